@@ -12,9 +12,6 @@
 #include <sstream>
 #include <string>
 #include <cstring>
-#include <boost/random/mersenne_twister.hpp>
-#include <boost/random/poisson_distribution.hpp>
-#include <boost/random/variate_generator.hpp>
 
 #include "vnoc_topology.h"
 #include "vnoc_router.h"
@@ -22,9 +19,6 @@
 
 
 using namespace std;
-using boost::mt19937;
-using boost::poisson_distribution;
-using boost::variate_generator;
 
 class EVENT;
 class EVENT_QUEUE;
@@ -57,6 +51,8 @@ class TRAFFIC_INJECTOR {
         double _task_stop_time;
         // selfsimilar related;
         Generator _gen_pareto_level2;
+        // stream of this injector (destinations, injection times);
+        RANDOM_NUMBER_GENERATOR _rng;
         double _prev_injection_time;
         int _prev_num_injected_packets;
         
@@ -94,6 +90,46 @@ class TRAFFIC_INJECTOR {
         void simulate_one_traffic_injector();   
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// CLOCK_DOMAIN
+//
+// routers that run at the same dvfs level and have their cycles at the 
+// same times, i.e., at the times t with t % _period == _phase; with the
+// clock-domain engine, one ROUTER event (ROUTER_BOOST, ROUTER, 
+// ROUTER_THROTTLE_1 or ROUTER_THROTTLE_2) per cycle of a domain simulates
+// all its members, in order of their ids, instead of one ROUTER_SINGLE 
+// event per router; a router whose level changes does its next cycle
+// at the old frequency with a ROUTER_SINGLE event, as with the 
+// event-driven engine; after a cycle that did not change its level, it
+// joins the domain of that level its next cycles are in; so, each router
+// is simulated at the same times and in the same order as with
+// ROUTER_SINGLE events only; dormant routers leave their domain and come
+// back the same way when woken up;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class CLOCK_DOMAIN {
+    public:
+        DVFS_LEVEL _level;
+        SIM_TIME _period;
+        SIM_TIME _phase;
+        // ids of routers simulated each cycle of this domain, sorted;
+        vector<long> _members;
+        // routers that moved here and the time of their first cycle;
+        vector<pair<long, SIM_TIME> > _joining;
+        // whether the event of the next cycle of this domain is in the 
+        // queue or being processed;
+        bool _scheduled;
+    public:
+        CLOCK_DOMAIN( DVFS_LEVEL level, SIM_TIME period, SIM_TIME phase) :
+            _level(level), _period(period), _phase(phase), _members(),
+            _joining(), _scheduled(false) {}
+        ~CLOCK_DOMAIN() {}
+
+        bool empty() const { return _members.empty() && _joining.empty(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // VNOC - versatile network-on-chip simulator;
@@ -107,14 +143,16 @@ class TRAFFIC_INJECTOR {
 class VNOC {
     private:
 
-        // because we work only with 2D meshes for now, nx and ny basically
-        // store _ary_size, which is stored in topology object; 
-        long _nx, _ny; // for 2D meshes only;
+        // routers along x and y, as in the topology object; used by the
+        // transpose traffics, which are for 2D meshes only;
+        long _nx, _ny;
         long _routers_count;
         // if _verbose is true then detailed debug info will be printed;
         bool _verbose;
         // set true once the simulator finished running the warmup cycles;
         bool _warmup_done;
+        // whether routers can go dormant (see ROUTER::go_dormant());
+        bool _dormant_routers_allowed;
         // _latency is the final result of running the vNOC simulator; introduced
         // in order to be able to read it from other classes, when vNOC is used 
         // multiple times;
@@ -129,15 +167,22 @@ class VNOC {
         // traffic related;
         TRAFFIC_TYPE _traffic_type;
         // used for selfsimilar case, where we need to generate duration tasks;
-        mt19937 _gen_4_poisson_level1;
-        poisson_distribution<int> _poisson_level1;
-        variate_generator< mt19937, poisson_distribution<int> > _rvt_level1;
         //Generator _gen_pareto_level2;
 
         // the name of the trace file; see README.txt for a description of trace
         // files format;
         ifstream _input_file_st;
         vector<TRAFFIC_INJECTOR> _traffic_injectors;
+        // all flits of the simulation; see FLIT_POOL;
+        FLIT_POOL _flit_pool;
+        // clock-domain engine only; by (DVFS_LEVEL, phase), made as
+        // routers join them;
+        map<pair<long, SIM_TIME>, CLOCK_DOMAIN> _clock_domains;
+        // neighbors and routing tables, compiled from the topology;
+        NETWORK _network;
+        // Orion coefficients shared by the routers of each configuration
+        // and operating point; built as routers are created; see POWER_MODEL;
+        map<POWER_MODEL_KEY, POWER_MODEL> _power_models;
 
     public:
         // _routers was made public to be accessed by the gui;
@@ -164,9 +209,17 @@ class VNOC {
 
         void set_warmup_done() { _warmup_done = true; }
         bool warmup_done() { return _warmup_done; }
+        bool dormant_routers_allowed() const { return _dormant_routers_allowed; }
+        void catch_up_dormant_routers();
+        void disable_dormant_routers();
         TOPOLOGY *topology() const { return _topology; }
         EVENT_QUEUE *event_queue() { return _event_queue; }
         GUI_GRAPHICS *gui() { return _gui; };
+        FLIT_POOL *flit_pool() { return &_flit_pool; }
+        const NETWORK *network() const { return &_network; }
+        // one for each DVFS_LEVEL;
+        vector<const POWER_MODEL *> power_models( long physical_ports_count,
+            long vc_count, double link_length, int arbiter_model);
         void set_gui(GUI_GRAPHICS *gui) { _gui = gui; };
 
         vector<ROUTER> &routers() { return _routers; }
@@ -182,18 +235,19 @@ class VNOC {
         TRAFFIC_TYPE traffic_type() const { return _traffic_type; }
         long get_num_of_traffic_sinks(void) const { return _routers_count; }
         void incr_total_packets_injected_count() { _total_packets_injected_count ++; }
-        void incr_packets_arrived_count_after_wu() { _packets_arrived_count_after_wu ++; }
+        void incr_packets_arrived_count_after_wu() { 
+            // routers of different PDES tiles may get here at the same time;
+            __sync_fetch_and_add( &_packets_arrived_count_after_wu, 1);
+        }
         long total_packets_injected_count(void) const { return _total_packets_injected_count; }
         long packets_arrived_count_after_wu(void) const { return _packets_arrived_count_after_wu; }
         // selfsimilar;
         void select_randomly_sources_for_selfsimilar_traffic();
-        int generate_new_task_start_time_from_poisson() {
-            // (1) version 1: using the boost poisson_distribution;
-            return _rvt_level1();
-            // (2) version 2: using my own implementation; results seem
-            // o be similar with either of them; use version 2 so that
-            // boost is not needed;
-            //return _topology->rng().poisson( 600);
+        int generate_new_task_start_time_from_poisson( RANDOM_NUMBER_GENERATOR &rng) {
+            // mean of 600 cycles; TODO: make it a parameter;
+            // Note: it used to be the boost poisson_distribution; results
+            // are similar; 
+            return rng.poisson( 600);
         }
         //Trace generate_new_trace() {
             // this gives us a Trace object with:
@@ -201,8 +255,8 @@ class VNOC {
             // Trc.PacketSize : of that many packets to inject
             // return _gen_pareto_level2.GenerateTrace();
         //}
-        long get_a_router_id_randomly() {
-            return _topology->rng().flat_l(0, _routers_count - 1);
+        long get_a_router_id_randomly( RANDOM_NUMBER_GENERATOR &rng) {
+            return rng.flat_l(0, _routers_count - 1);
         }
         
         bool check_address(const ADDRESS &a) const;
@@ -218,13 +272,13 @@ class VNOC {
 
         // receive_ functions are used inside the main while
         // loop of the simulation-queue;
-        bool receive_EVENT_PE( EVENT this_event);
-        bool receive_EVENT_ROUTER( EVENT this_event);
-        bool receive_EVENT_LINK( EVENT this_event);
-        bool receive_EVENT_CREDIT( EVENT this_event);
+        bool receive_EVENT_PE( const EVENT &this_event);
+        bool receive_EVENT_ROUTER( const EVENT &this_event);
+        void insert_clock_domain_events();
         
-        void receive_EVENT_ROUTER_SINGLE( EVENT this_event);
-        void receive_EVENT_SYNC_PREDICT_DVFS_SET( EVENT this_event);
+        void receive_EVENT_ROUTER_SINGLE( const EVENT &this_event);
+        SIM_TIME simulate_router_cycle( long router_id);
+        void receive_EVENT_SYNC_PREDICT_DVFS_SET( const EVENT &this_event);
         
 
         bool run_simulation();
@@ -235,6 +289,8 @@ class VNOC {
         
         // DVFS related;
         void set_frequencies_and_vdd( DVFS_LEVEL to_level);
+        CLOCK_DOMAIN &clock_domain( DVFS_LEVEL level, SIM_TIME time);
+        void move_router_to_clock_domain( long router_id, SIM_TIME first_time);
         void compute_and_print_prediction_stats();
 };
 
@@ -0,0 +1,54 @@
+#ifndef _VNOC_ARBITER_H_
+#define _VNOC_ARBITER_H_
+
+#include <vector>
+
+#include "vnoc_utils.h"
+#include "vnoc_topology.h"
+
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ARBITER
+//
+// picks one winner among the requesters whose bits are set in a request
+// vector; arbitrate() does not change the state of the arbiter; update() 
+// must be called with the winner only when its grant is actually used 
+// (e.g., in separable allocators, an input arbiter is updated only if 
+// its request won at the output arbiter as well);
+// RANDOM_ARB: winner picked randomly; this is how vnoc always did it;
+// ROUND_ROBIN_ARB: the requester after the last winner has highest priority;
+// MATRIX_ARB: least recently served requester has highest priority;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class ARBITER {
+    private:
+        ARBITER_TYPE _type;
+        long _size; // number of requesters;
+        RANDOM_NUMBER_GENERATOR _rng; // used by RANDOM_ARB only;
+        long _pointer; // ROUND_ROBIN_ARB: requester with highest priority;
+        // MATRIX_ARB: bit b of _beaten_by[a] is set if requester b has
+        // priority over requester a;
+        vector<BIT_VECTOR> _beaten_by;
+
+    public:
+        ARBITER() : _type(RANDOM_ARB), _size(0), _rng(), _pointer(0), 
+            _beaten_by() {}
+        ARBITER( ARBITER_TYPE type, long size);
+        ~ARBITER() {}
+
+        ARBITER_TYPE type() const { return _type; }
+        long size() const { return _size; }
+        // each arbiter must have its own stream;
+        void set_rng_stream( long seed, unsigned long long stream) {
+            _rng.set_seed( seed, stream);
+        }
+        // returns the index of the winner; -1 if there are no requests;
+        long arbitrate( const BIT_VECTOR &requests);
+        void update( long winner);
+};
+
+#endif
@@ -2,6 +2,8 @@
 #define _VNOC_EVENT_H_
 
 #include <set>
+#include <vector>
+#include <functional>
 
 #include "vnoc_topology.h"
 #include "vnoc.h"
@@ -9,6 +11,46 @@
 
 using namespace std;
 
+class PDES_ENGINE;
+class PARALLEL_CYCLE_ENGINE;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// EVENT_KEY
+//
+// order of events in the simulation-queue: by start time (in ticks, so 
+// times compare exactly, see TICKS_PER_CYCLE); events with equal
+// start times are ordered by the time they were issued at (i.e., added to
+// the queue) and then by the router that issued them (-1 if not issued by 
+// a router); the queue keeps events with equal keys in the order they were 
+// added; when all routers run at the same frequency this is exactly the 
+// order of a plain FIFO queue; unlike the FIFO order, it can be computed 
+// also for the cycles of dormant routers that are not in the queue, which 
+// is what lets them wake up in the right place (see ROUTER::go_dormant());
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class EVENT_KEY {
+    public:
+        SIM_TIME _start_time;
+        SIM_TIME _issue_time;
+        long _origin;
+    public:
+        EVENT_KEY( SIM_TIME start_time, SIM_TIME issue_time, long origin) :
+            _start_time(start_time), _issue_time(issue_time), _origin(origin) {}
+        ~EVENT_KEY() {}
+};
+
+inline bool operator<(const EVENT_KEY &a, const EVENT_KEY &b) {
+    if ( a._start_time != b._start_time) {
+        return a._start_time < b._start_time;
+    }
+    if ( a._issue_time != b._issue_time) {
+        return a._issue_time < b._issue_time;
+    }
+    return a._origin < b._origin;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // EVENT
@@ -19,68 +61,139 @@ class EVENT {
     public:
     enum EVENT_TYPE { 
         PE, ROUTER_BOOST, ROUTER, ROUTER_THROTTLE_1, ROUTER_THROTTLE_2, 
-        LINK, CREDIT, DUMMY, ROUTER_SINGLE, SYNC_PREDICT_DVFS_SET };
+        DUMMY, ROUTER_SINGLE, SYNC_PREDICT_DVFS_SET };
     private:
         EVENT_TYPE _type;
         // stores id of router where the event is generated;
         long _from_router_id;
-        // id of router where the LIN or CREDIT events go;
-        long _to_router_id;
-        double _start_time;
-        long _pc; // port id;
-        long _vc; // virtual channel id for the above port id;
-        FLIT _flit; // the data (payload);
+        SIM_TIME _start_time;
+        // set by EVENT_QUEUE::add_event(); see EVENT_KEY;
+        SIM_TIME _issue_time;
+        long _origin;
 
     public:
         // ROUTER type events;
-        EVENT( EVENT_TYPE type, double time, long from_router_id) : 
-            _type(type), _start_time(time), _pc(), _vc(), _flit() { 
+        EVENT( EVENT_TYPE type, SIM_TIME time, long from_router_id) : 
+            _type(type), _start_time(time), _issue_time(0), _origin(-1) { 
             _from_router_id = from_router_id; // src address; 
-            _to_router_id = 0; 
         }
         // PE type event;
-        EVENT( EVENT_TYPE type, double time) : 
-            _type(type), _start_time(time), _pc(), _vc(), _flit() { 
-            _from_router_id = 0; 
-            _to_router_id = 0; 
-        }
-        // LINK type event;
-        EVENT( EVENT_TYPE type, double time, long to_router_id,
-            long pc, long vc, FLIT &flit) : _type(type), 
-            _start_time(time), _pc(pc), _vc(vc), _flit(flit) { 
+        EVENT( EVENT_TYPE type, SIM_TIME time) : 
+            _type(type), _start_time(time), _issue_time(0), _origin(-1) { 
             _from_router_id = 0; 
-            _to_router_id = to_router_id; // dest address; 
-        }
-        // CREDIT type event;
-        EVENT( EVENT_TYPE type, double time, long to_router_id,
-            long pc, long vc) : _type(type), _start_time(time),
-            _pc(pc), _vc(vc), _flit() { 
-            _from_router_id = 0; 
-            _to_router_id = to_router_id; // dest address; 
         }
+        // Note: flits and credits do not go thru the simulation-queue; 
+        // they go thru links (see LINK);
 
         EVENT( EVENT &event) : _type(event.type()),
-            _start_time(event.start_time()),
             _from_router_id(event.from_router_id()),
-            _to_router_id(event.to_router_id()),
-            _pc(event.pc()), _vc(event.vc()), _flit(event.flit()) { }
-        EVENT( const EVENT &event) : _type(event.type()),
             _start_time(event.start_time()),
+            _issue_time(event.issue_time()),
+            _origin(event.origin()) { }
+        EVENT( const EVENT &event) : _type(event.type()),
             _from_router_id(event.from_router_id()),
-            _to_router_id(event.to_router_id()),
-            _pc(event.pc()), _vc(event.vc()), _flit(event.flit()) { }
+            _start_time(event.start_time()),
+            _issue_time(event.issue_time()),
+            _origin(event.origin()) { }
         ~EVENT() {}
 
 
         EVENT_TYPE type() const { return _type; }
-        double start_time() const { return _start_time; }
-        long pc() const { return _pc; }
-        long vc() const { return _vc; }
-        FLIT &flit() { return _flit; }
-        const FLIT &flit() const { return _flit;}
-
+        SIM_TIME start_time() const { return _start_time; }
+        SIM_TIME issue_time() const { return _issue_time; }
+        long origin() const { return _origin; }
+        EVENT_KEY key() const { 
+            return EVENT_KEY( _start_time, _issue_time, _origin); 
+        }
+        void set_issued( SIM_TIME issue_time, long origin) {
+            _issue_time = issue_time;
+            _origin = origin;
+        }
         long from_router_id() const { return _from_router_id; }
-        long to_router_id() const { return _to_router_id; }
+        // event of a cycle of a clock domain (see CLOCK_DOMAIN);
+        bool clock_domain_event() const {
+            return ( _type == ROUTER_BOOST || _type == ROUTER ||
+                _type == ROUTER_THROTTLE_1 || _type == ROUTER_THROTTLE_2);
+        }
+};
+
+inline bool operator<(const EVENT &a, const EVENT &b) {
+    return a.key() < b.key();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// CALENDAR_QUEUE
+//
+// timing wheel of buckets; each bucket covers CALENDAR_TICKS_PER_SLOT ticks
+// (1/20 of a base clock cycle); almost all events are scheduled a few cycles ahead 
+// (pipe, wire and credit delays) so they land directly into the wheel;
+// events beyond the horizon of the wheel (e.g., from tracefiles) wait in 
+// an overflow heap and are moved into the wheel as time advances;
+// events themselves are stored in a pool that is reused; buckets only keep
+// small entries (key, insertion order, index into pool); events with
+// equal keys come out in the order they were added (FIFO), which is
+// the same order the multiset gives;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#define CALENDAR_TICKS_PER_SLOT 9
+#define CALENDAR_BUCKETS_COUNT 4096 // must be a power of 2;
+
+class CALENDAR_ENTRY {
+    public:
+        EVENT_KEY _key;
+        unsigned long long _seq; // insertion order; breaks ties;
+        long _index; // index into the pool of events;
+    public:
+        CALENDAR_ENTRY( const EVENT_KEY &key, unsigned long long seq, long index) :
+            _key(key), _seq(seq), _index(index) {}
+        ~CALENDAR_ENTRY() {}
+};
+
+inline bool operator>(const CALENDAR_ENTRY &a, const CALENDAR_ENTRY &b) {
+    if ( a._key < b._key) {
+        return false;
+    }
+    if ( b._key < a._key) {
+        return true;
+    }
+    return a._seq > b._seq;
+}
+
+class CALENDAR_QUEUE {
+    private:
+        vector<EVENT> _pool;
+        vector<long> _free_indices;
+        // each bucket is a min-heap of entries; 
+        vector<vector<CALENDAR_ENTRY> > _buckets;
+        vector<CALENDAR_ENTRY> _overflow; // min-heap too;
+        // slot of the earliest bucket of the wheel; the wheel covers slots
+        // [_base_slot, _base_slot + CALENDAR_BUCKETS_COUNT);
+        long long _base_slot;
+        long _wheel_events_count;
+        unsigned long long _seq;
+
+    public:
+        CALENDAR_QUEUE();
+        ~CALENDAR_QUEUE() {}
+
+        long size() const { return _wheel_events_count + _overflow.size(); }
+        void push( const EVENT &event);
+        // both need a non-empty queue; the reference returned by top() is
+        // valid only until the next push();
+        const EVENT &top();
+        void pop();
+
+    private:
+        long long slot_of( SIM_TIME time) const { 
+            return time / CALENDAR_TICKS_PER_SLOT; 
+        }
+        vector<CALENDAR_ENTRY> &bucket_of( long long slot) {
+            return _buckets[ slot & (CALENDAR_BUCKETS_COUNT - 1)];
+        }
+        void advance_to_first_event();
+        void insert_into_wheel( long long slot, const CALENDAR_ENTRY &entry);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,50 +202,125 @@ class EVENT {
 //
 // the simulator is nothing but a queue of events that are continuously added
 // to the queue and continuously processed from the queue;
+// flits and credits do not go thru the queue; they go thru links (see
+// LINK) and routers take them in at their next cycle;
+// with the cycle-driven engine, routers are not in the queue; they are all
+// simulated each cycle, in the order of their ids; the queue keeps only PE
+// events; events are processed in the same order as with the event-driven
+// engine, which gives the same results; with more than one thread, routers
+// are simulated by PARALLEL_CYCLE_ENGINE;
+// with the PDES engine, each tile of routers has its own queue (see 
+// PDES_ENGINE); this main queue keeps only PE and SYNC_PREDICT_DVFS_SET
+// events;
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-inline bool operator<(const EVENT &a, const EVENT &b) {
-    return a.start_time() < b.start_time();
-}
-
 class EVENT_QUEUE {
     private:
+        // only one of the two is used, depending on the event_queue 
+        // command line option;
+        EVENT_QUEUE_TYPE _queue_type;
         multiset<EVENT> _events;
-        double _current_sim_time;
+        CALENDAR_QUEUE _calendar;
+        SIMULATION_ENGINE _engine;
+        // cycle-driven engine only;
+        long _current_cycle;
+        SIM_TIME _report_at_time;
+        SIM_TIME _current_sim_time;
+        // simulation and warmup cycles counts, in ticks;
+        SIM_TIME _simulation_end_time;
+        SIM_TIME _warmup_end_time;
+        // key of the event being processed and the router that processes
+        // it (-1 if the event is not a router cycle); events added while
+        // processing it are issued by that router;
+        EVENT_KEY _current_event_key;
+        long _current_origin;
         long _event_count;
         long _queue_events_simulated;
+        // clock-domain engine only; set when simulation must stop in the
+        // middle of the event of a domain;
+        bool _stop_requested;
+        // PDES engine only; owned by the main queue;
+        PDES_ENGINE *_pdes_engine;
+        // cycle-driven engine with more than one thread only;
+        PARALLEL_CYCLE_ENGINE *_cycle_engine;
     public:
         TOPOLOGY *_topology;
         VNOC *_vnoc;
 
     public:
-        EVENT_QUEUE( double start_time, TOPOLOGY *topology);
-        ~EVENT_QUEUE() {}
+        EVENT_QUEUE( SIM_TIME start_time, TOPOLOGY *topology);
+        ~EVENT_QUEUE();
 
         typedef multiset<EVENT>::size_type size_type; 
-        typedef multiset<EVENT>::iterator iterator;
 
         VNOC *vnoc() { return _vnoc; }
         void set_vnoc(VNOC *vnoc) { _vnoc = vnoc; };
         TOPOLOGY *topology() const { return _topology; }
-        double current_sim_time() const { return _current_sim_time; }
+        SIM_TIME current_sim_time() const { return _current_sim_time; }
+        double current_sim_cycles() const { return ticks_to_cycles( _current_sim_time); }
+        SIM_TIME warmup_end_time() const { return _warmup_end_time; }
+        const EVENT_KEY &current_event_key() const { return _current_event_key; }
+        void set_current_event( const EVENT_KEY &key, long origin) {
+            _current_sim_time = key._start_time;
+            _current_event_key = key;
+            _current_origin = origin;
+        }
         long event_count() const { return _event_count; }
         long queue_events_simulated() const { return _queue_events_simulated; }
-        iterator get_event() { return _events.begin(); }
-        void remove_event( iterator pos) { _events.erase(pos); }
+        const EVENT &get_event() { 
+            if ( _queue_type == CALENDAR_EVENT_QUEUE) {
+                return _calendar.top();
+            }
+            return *_events.begin(); 
+        }
         void remove_top_event() { 
-            _events.erase(_events.begin());
+            if ( _queue_type == CALENDAR_EVENT_QUEUE) {
+                _calendar.pop();
+            } else {
+                _events.erase(_events.begin());
+            }
             _event_count --; 
         }
-        size_type event_queue_size() const { return _events.size(); }
+        size_type event_queue_size() const { 
+            if ( _queue_type == CALENDAR_EVENT_QUEUE) {
+                return _calendar.size();
+            }
+            return _events.size(); 
+        }
         void add_event( const EVENT &event) { 
+            EVENT issued_event( event);
+            issued_event.set_issued( _current_sim_time, _current_origin);
+            add_issued_event( issued_event);
+        }
+        // adds an event whose issue time and origin were already set;
+        void add_issued_event( const EVENT &event) { 
             _event_count ++; 
-            _events.insert(event); 
+            if ( _queue_type == CALENDAR_EVENT_QUEUE) {
+                _calendar.push(event);
+            } else {
+                // equal keys are inserted after existing ones (FIFO);
+                _events.insert(event); 
+            }
         }
 
         void insert_initial_events();
         bool run_simulation();
+        // PDES engine; processes the events of this tile before bound;
+        void run_tile_window( const EVENT_KEY &bound);
+        EVENT_KEY router_cycle_key( long cycle, long router_id) const;
+        // clock-domain engine; processes the events that come before key
+        // and then makes router_id the origin of the events added next;
+        // returns false if simulation must stop;
+        bool start_router_cycle( const EVENT_KEY &key, long router_id);
+
+    private:
+        bool start_processing( const EVENT_KEY &key, long origin);
+        void process_event( EVENT &this_event);
+        void run_event_driven_loop();
+        void run_cycle_driven_loop();
+        void run_parallel_cycle_loop();
+        void run_pdes_loop();
 };
 
 #endif
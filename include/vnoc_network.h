@@ -0,0 +1,141 @@
+#ifndef _VNOC_NETWORK_H_
+#define _VNOC_NETWORK_H_
+
+#include <vector>
+#include <utility>
+#include <map>
+#include <string>
+
+#include "vnoc_topology.h"
+
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// NETWORK
+//
+// the compiled form of the topology, built once at startup: for each
+// output port of each router, the neighbor router, its input port and the
+// pipeline stages of the link; for each router, class of input port and
+// destination, the candidate (output port, vc) pairs of the routing algo;
+// so, routers do not compute neighbors or routes from addresses during
+// the simulation; the candidate lists are shared, as few distinct ones exist;
+// in meshes and tori, XY and TXY routes are kept for each dimension only,
+// as they depend on the router and destination coordinates in one dimension;
+// the topology is either a mesh or torus (2D or 3D, see TOPOLOGY) or a
+// graph read from a topology file (see README.txt); in meshes, port 0 is
+// the PE, port 1 is West, 2 is East, 3 is South, 4 is North, 5 is Down and
+// 6 is Up; in graphs, port 0 is the PE and the other ports are as in the file;
+// up*/down* routes are checked before the simulation starts: they must go
+// thru links, reach their destination and have no cycle of channel
+// dependencies (i.e., be deadlock free); XY and TXY routes are by design;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class NETWORK {
+    private:
+        long _routers_count;
+        // largest number of physical ports of a router, PE port included;
+        // the stride of the per-port tables;
+        long _ports_count;
+        long _vc_number;
+        vector<long> _router_ports_counts;
+        // neighbor router id, its input port and the pipeline stages of the
+        // link, at index router_id * _ports_count + port_id; -1 if the port
+        // has no link; links go both ways;
+        vector<long> _neighbor_routers;
+        vector<long> _neighbor_ports;
+        vector<long> _link_stages;
+        // routes may depend on the input port a flit came in thru; ports
+        // of the same class have the same routes; with up*/down* routing,
+        // class 1 is of ports that links come down to (only down links may
+        // be taken next); XY and TXY have only one class;
+        long _port_classes_count;
+        vector<long> _port_classes;
+        // up*/down* routes; index in _route_lists at
+        // (router_id * _port_classes_count + class) * _routers_count + des_router_id;
+        // int, as these tables grow with the square of the routers count;
+        vector<int> _route_ids;
+        // XY and TXY routes; they are those of the first dimension, from the
+        // last one, in which the router and destination coordinates a and b
+        // differ; index in _route_lists at a * size + b of that dimension;
+        vector<long> _dimension_sizes;
+        vector<vector<long> > _dimension_route_ids;
+        vector<vector<VC_PAIR> > _route_lists;
+        // router at the root of the up*/down* spanning tree; -1 means the
+        // center of the network;
+        long _root_id;
+
+    public:
+        NETWORK() : _routers_count(0), _ports_count(0), _vc_number(0),
+            _router_ports_counts(), _neighbor_routers(), _neighbor_ports(),
+            _link_stages(), _port_classes_count(1), _port_classes(),
+            _route_ids(), _dimension_sizes(), _dimension_route_ids(),
+            _route_lists(), _root_id(-1) {}
+        ~NETWORK() {}
+
+        // builds all tables for the topology and routing algo of the user;
+        // exits if the topology file is wrong or the routes are not
+        // deadlock free;
+        void compile( TOPOLOGY *topology);
+
+        long routers_count() const { return _routers_count; }
+        long ports_count() const { return _ports_count; }
+        long router_ports_count( long router_id) const {
+            return _router_ports_counts[ router_id];
+        }
+        long neighbor_router( long router_id, long port_id) const {
+            return _neighbor_routers[ router_id * _ports_count + port_id];
+        }
+        long neighbor_port( long router_id, long port_id) const {
+            return _neighbor_ports[ router_id * _ports_count + port_id];
+        }
+        long link_stages( long router_id, long port_id) const {
+            return _link_stages[ router_id * _ports_count + port_id];
+        }
+        long min_link_stages() const;
+        // candidate (output port, vc) pairs at router_id for flits that
+        // came in thru input port in_port_id and go to des_router_id; empty
+        // if they are the same;
+        const vector<VC_PAIR> &routes( long router_id, long in_port_id,
+            long des_router_id) const {
+            if ( !_dimension_sizes.empty()) {
+                // the last dimension is of stride 1 in router ids;
+                for ( long d = long(_dimension_sizes.size()) - 1; d >= 0; d--) {
+                    long size = _dimension_sizes[ d];
+                    long a = router_id % size, b = des_router_id % size;
+                    if ( a != b) {
+                        return _route_lists[ _dimension_route_ids[ d][ a * size + b]];
+                    }
+                    router_id /= size;
+                    des_router_id /= size;
+                }
+                return _route_lists[ 0]; // empty;
+            }
+            long c = _port_classes[ router_id * _ports_count + in_port_id];
+            return _route_lists[ _route_ids[
+                (router_id * _port_classes_count + c) * _routers_count +
+                des_router_id]];
+        }
+
+    private:
+        void resize_tables();
+        void add_link( long router_id, long port_id,
+            long other_id, long other_port_id, long stages);
+        void build_cube_neighbors( TOPOLOGY *topology, long stages);
+        void load_topology_file( const string &file_name, long stages);
+        long add_route_list( map<vector<VC_PAIR>, long> &list_ids,
+            const vector<VC_PAIR> &routes);
+        void build_cube_routes( TOPOLOGY *topology);
+        void dimension_order_routes( TOPOLOGY *topology, const ADDRESS &a,
+            const ADDRESS &des_a, bool torus_routes, vector<VC_PAIR> &routes) const;
+        void distances_from( long router_id, vector<long> &distances) const;
+        void build_up_down_routes();
+        void follow_routes( long router_id, long in_port_id, long des_router_id,
+            long from, vector<vector<long> > &dependencies, vector<char> &depends,
+            vector<char> &reached, vector<long> &stack_t) const;
+        void check_routes() const;
+};
+
+#endif
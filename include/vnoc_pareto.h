@@ -12,6 +12,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include "vnoc_utils.h"
+
 using namespace std;
 
 
@@ -56,37 +58,18 @@ template < class T > inline T round( DOUBLE val )  { return (T)( val + 0.5 ); }
 
 typedef double rnd_t;
 
-const int16u SMALL_RANGE  =  15;  /* range of random values returned by rand()  [0 ... 2^15] */
-const int16u LARGE_RANGE  =  24;  /* extended range of random values [0 ... 2^24] */
-
-const int16u EXTENTION    = LARGE_RANGE - SMALL_RANGE;
-const int16u EXTEN_MASK   = (0x0001 << (EXTENTION + 1)) - 1;
-
-#define EXT_RANGE( X, Y )  ((((int32u)X) << EXTENTION ) | ( Y & EXTEN_MASK ))
-
-#if defined( RND_LARGE_RANGE )
-
-    int32u _lrand(void)        { return EXT_RANGE( rand(), rand() ); }
-    #define RAND               _lrand
-    const int32u RND_MAXIMUM = EXT_RANGE( RAND_MAX, RAND_MAX );
-    
-#else
-
-    #define RAND               rand
-    const int32u RND_MAXIMUM = RAND_MAX;
-
-#endif
+// numbers are drawn from the stream of the Generator (it used to be the 
+// global rand());
+typedef RANDOM_NUMBER_GENERATOR RNG;
 
+const int32u RND_MAXIMUM = RAND_MAX;
 
 const rnd_t SMALL_VAL = 0.5 / RND_MAXIMUM;
 
-//inline void   _seed(void)                    { srand( (unsigned)time( NULL ) );          }
-inline void  _seed( long seed)                { srand( seed); }
-inline rnd_t _uniform01(void)                { return ((rnd_t)RAND()) / RND_MAXIMUM;     }
-inline rnd_t _uniform_(rnd_t low, rnd_t hi)  { return (hi - low) * _uniform01() + low;   }
-inline rnd_t _uniform_non0(void)             { return _uniform_( SMALL_VAL, 1.0 );       }
-inline rnd_t _exponent_(void)                { return -log( _uniform_non0() );           }
-inline rnd_t _pareto_(rnd_t shape)           { return pow( _uniform_non0(), -1.0/shape); }
+inline rnd_t _uniform_(RNG &rng, rnd_t low, rnd_t hi)  { return rng.flat_d( low, hi);             }
+inline rnd_t _uniform_non0(RNG &rng)             { return _uniform_( rng, SMALL_VAL, 1.0 );  }
+inline rnd_t _exponent_(RNG &rng)                { return -log( _uniform_non0( rng) );       }
+inline rnd_t _pareto_(RNG &rng, rnd_t shape)     { return pow( _uniform_non0( rng), -1.0/shape); }
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -102,10 +85,10 @@ typedef DOUBLE   bytestamp_t;
 
 /* Choose one of the following lines */
 /* Use Pareto distributed ON and OFF periods */
-inline DOUBLE rnd_val( DOUBLE shape )   { return _pareto_( shape ); }
+inline DOUBLE rnd_val( RNG &rng, DOUBLE shape )   { return _pareto_( rng, shape ); }
 
 /* Use exponentially distributed ON and OFF periods */
-//inline DOUBLE rnd_val( DOUBLE shape )   { return _exponent_() / (shape - 1.0) + 1.0; }
+//inline DOUBLE rnd_val( RNG &rng, DOUBLE shape )   { return _exponent_( rng) / (shape - 1.0) + 1.0; }
 
 class Source
 {
@@ -120,7 +103,7 @@ private:
 
 public:
 
-    Source(pct_size_t pct_sz, pct_size_t preamble, int32u min_gap, DOUBLE pshape, DOUBLE gshape )
+    Source(RNG &rng, pct_size_t pct_sz, pct_size_t preamble, int32u min_gap, DOUBLE pshape, DOUBLE gshape )
     { 
         PctSize   = pct_sz;
         Preamble  = preamble;
@@ -128,18 +111,18 @@ public:
         PctShape  = pshape;
         GapShape  = gshape;
 
-        Reset();
+        Reset( rng);
     }
 
     ~Source() {}
 
     ///////////////////////////////////////////////////////////////////////////////
 
-    void Reset(void)
+    void Reset(RNG &rng)
     {
         Elapsed   = 0.0;
         BurstSize = 0;
-        ExtractPacket();
+        ExtractPacket( rng);
     }
     ///////////////////////////////////////////////////////////////////////////////
 
@@ -155,12 +138,12 @@ public:
     //              distribution. Elapsed time is also incremented by a 
     //              Pareto-distributed value to account for inter-burst gap.
     ////////////////////////////////////////////////////////////////////////////////
-    void ExtractPacket(void)
+    void ExtractPacket(RNG &rng)
     {
         if( BurstSize == 0 )
         {
-            BurstSize = round<int16u>( rnd_val( PctShape ) * MIN_BURST );
-            Elapsed  += round<int32u>( rnd_val( GapShape ) * MinGap );
+            BurstSize = round<int16u>( rnd_val( rng, PctShape ) * MIN_BURST );
+            Elapsed  += round<int32u>( rnd_val( rng, GapShape ) * MinGap );
         }
         BurstSize--;
         Elapsed += ( PctSize + Preamble );
@@ -177,12 +160,13 @@ class SourceLink: public Source
     SourceLink* pNext;
 
   public:
-    SourceLink( pct_size_t pct_sz, 
+    SourceLink( RNG &rng,
+                pct_size_t pct_sz, 
                 pct_size_t preamble, 
                 int32u min_gap, 
                 DOUBLE pshape, 
                 DOUBLE gshape ):
-                Source( pct_sz, preamble, min_gap, pshape, gshape )  { pNext = NULL; }
+                Source( rng, pct_sz, preamble, min_gap, pshape, gshape )  { pNext = NULL; }
     ~SourceLink() {}
 
     SourceLink* GetNext(void)                            { return pNext; }
@@ -247,6 +231,7 @@ private:
     int32s      TotalPackets;   /* Total packets generated */ 
     bytestamp_t Elapsed;        /* Elapsed time (expressed in ByteTime units)
                                   since the beginning of the trace */
+    RNG         Rng;            /* stream of this generator and its sources */
 
     ////////////////////////////////////////////////////////////////////////////////
     // FUNCTION:    void InsertInOrder( SourceLink* pSrc )
@@ -285,9 +270,10 @@ public:
     
     // this was the original constructor Generator;
     void initialize( DOUBLE line_rate_Mbps, DOUBLE load = 0.0, 
-                     int16s sources = 0, long seed = 1) 
+                     int16s sources = 0, long seed = 1, 
+                     unsigned long long stream = 0) 
     { 
-        _seed( seed);
+        Rng.set_seed( seed, stream);
 
         pFirst    = NULL;  
         Preamble  = PREAMBLE;
@@ -318,7 +304,7 @@ public:
         Elapsed      = 0.0;
         TotalPackets = 0;
         for( SourceLink* p = pFirst; p; p = p->GetNext() )
-            p->Reset();
+            p->Reset( Rng);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -339,7 +325,7 @@ public:
     ////////////////////////////////////////////////////////////////////////////////
     void AddSource(pct_size_t pct_sz, pct_size_t preamble, int32u min_gap, 
         DOUBLE pshape, DOUBLE gshape ) {
-        InsertInOrder( new SourceLink( pct_sz, preamble, min_gap, pshape, gshape ) );
+        InsertInOrder( new SourceLink( Rng, pct_sz, preamble, min_gap, pshape, gshape ) );
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -380,7 +366,7 @@ public:
                 /* Every source has a constant packet size from uniform
                  * distribution [MinPacket ... MaxPacket]
                  */
-                packet_size = round<int16u>(_uniform_(MinPacket, MaxPacket));
+                packet_size = round<int16u>(_uniform_(Rng, MinPacket, MaxPacket));
                 AddSource(packet_size, Preamble, (int32u)(coef * packet_size), on_shape, off_shape);
             }
         }
@@ -434,7 +420,7 @@ public:
         TotalBytes   += Trc.PacketSize;     
         TotalPackets++;
 
-        pNextSrc->ExtractPacket();          /* receive new packet */
+        pNextSrc->ExtractPacket( Rng);      /* receive new packet */
         InsertInOrder( pNextSrc );          /* place the source in the list 
                                              * in order of packet arrival */
         return Trc;
@@ -0,0 +1,189 @@
+#ifndef _VNOC_PDES_H_
+#define _VNOC_PDES_H_
+
+#include <vector>
+#include <pthread.h>
+
+#include "vnoc_event.h"
+
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// WORKER_POOL
+//
+// threads that run a step in one or two phases, each one separated by a
+// barrier; in the first phase, workers simulate their own routers and only
+// post what goes to other workers; in the second phase, if any, workers 
+// take in what was posted to them; the main thread is worker 0; workers
+// wait at the barrier between steps, while the main thread does the rest;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class WORKER_POOL;
+
+class WORKER {
+    public:
+        WORKER_POOL *_pool;
+        long _id;
+    public:
+        WORKER( WORKER_POOL *pool, long id) : _pool(pool), _id(id) {}
+        ~WORKER() {}
+};
+
+class WORKER_POOL {
+    protected:
+        long _workers_count;
+        // whether steps have a second phase (and its barrier);
+        bool _second_phase;
+    private:
+        vector<WORKER> _workers;
+        vector<pthread_t> _threads;
+        pthread_barrier_t _barrier;
+        bool _stop;
+        bool _threads_running;
+
+    public:
+        WORKER_POOL() : _workers_count(1), _second_phase(true), _workers(),
+            _threads(), _stop(false), _threads_running(false) {}
+        // derived classes must call stop_threads() in their destructor;
+        virtual ~WORKER_POOL() {}
+
+        long workers_count() const { return _workers_count; }
+        void start_threads();
+        void stop_threads();
+        // runs the phases on all workers;
+        void run_step();
+
+    protected:
+        virtual void run_first_phase( long worker_id) = 0;
+        virtual void run_second_phase( long) {}
+
+    private:
+        void run_worker( long worker_id);
+        static void *worker_entry( void *arg);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PDES_TILE
+//
+// a rectangle of routers simulated by one thread, with its own
+// simulation-queue; flits and credits for routers of other tiles go thru
+// their links (see LINK), which routers of two threads can share;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class PDES_TILE {
+    public:
+        long _id;
+        vector<long> _router_ids;
+        EVENT_QUEUE *_event_queue;
+        // routers with a neighbor in another tile;
+        vector<long> _boundary_router_ids;
+    public:
+        PDES_TILE( long id) : _id(id), _router_ids(), _event_queue(0),
+            _boundary_router_ids() {}
+        ~PDES_TILE() {}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PDES_ENGINE
+//
+// conservative parallel simulation: the mesh is cut into tiles; routers of
+// different tiles talk only thru links, where flits and credits take at
+// least "lookahead" time (smallest wire or credit delay, for all stages of
+// a link); so, all events in a window [t, t + lookahead) can be processed 
+// by the tiles in parallel, where t is the earliest event; flits and 
+// credits sent to other tiles arrive after the window; dormant routers 
+// they are sent to are woken up between windows, by their own thread;
+// events that touch the whole network (PE, SYNC_PREDICT_DVFS_SET) stay in
+// the main simulation-queue and are processed by the main thread between
+// windows, while all tiles wait;
+// each tile is a worker; the main thread simulates tile 0 too;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class PDES_ENGINE : public WORKER_POOL {
+    private:
+        VNOC *_vnoc;
+        vector<PDES_TILE> _tiles;
+        // tile of each router;
+        vector<long> _router_tiles;
+        SIM_TIME _lookahead;
+        // written by the main thread only while workers wait;
+        EVENT_KEY _window_bound;
+
+    public:
+        PDES_ENGINE( VNOC *vnoc);
+        ~PDES_ENGINE();
+
+        long tiles_count() const { return _workers_count; }
+        SIM_TIME lookahead() const { return _lookahead; }
+        EVENT_QUEUE *tile_queue( long tile_id) {
+            return _tiles[ tile_id]._event_queue;
+        }
+
+        // key of the earliest event of all tiles; false if all are empty;
+        bool earliest_event_key( EVENT_KEY &key);
+        // key of the latest event processed by the tiles, if later than key;
+        void latest_event_key( EVENT_KEY &key);
+        void set_current_event( const EVENT_KEY &key, long origin);
+        // process in parallel all tile events that come before bound;
+        void run_window( const EVENT_KEY &bound);
+
+    protected:
+        // simulate the window; then, wake up routers flits were sent to;
+        void run_first_phase( long tile_id);
+        void run_second_phase( long tile_id);
+
+    private:
+        void partition();
+        void find_boundary_routers();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PARALLEL_CYCLE_ENGINE
+//
+// the cycle-driven engine on several threads; each cycle, each worker
+// simulates one cycle of its own routers (a range of router ids); routers
+// change only their own state and the links they send flits and credits
+// on (see LINK), which routers of other workers read at the same time;
+// what is sent in a cycle arrives in a later cycle, so it is never taken
+// in too early; as with the sequential engine, a flit sent by a router 
+// with a larger id than its receiver is seen by the receiver only one 
+// cycle later (see EVENT_KEY);
+// the main thread processes the events of the main queue (PE) between 
+// cycles;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class PARALLEL_CYCLE_ENGINE : public WORKER_POOL {
+    private:
+        VNOC *_vnoc;
+        // routers [_first_routers[w], _first_routers[w+1]) belong to worker w;
+        vector<long> _first_routers;
+        vector<EVENT_QUEUE *> _event_queues;
+        long _current_cycle;
+        // routers with smaller ids already did the current cycle;
+        long _first_router_id;
+
+    public:
+        PARALLEL_CYCLE_ENGINE( VNOC *vnoc);
+        ~PARALLEL_CYCLE_ENGINE();
+
+        void set_current_event( const EVENT_KEY &key, long origin);
+        // a cycle of routers first_router_id and up, in parallel;
+        void run_cycle( long cycle, long first_router_id);
+        // a cycle of one router, by the main thread;
+        void run_router_cycle( long cycle, long router_id);
+
+    protected:
+        // simulate routers; there is no second phase;
+        void run_first_phase( long worker_id);
+};
+
+#endif
@@ -28,21 +28,23 @@ class PREDICTOR_MODULE {
         long _history_window;
         long _history_weight; 
 
-        // BU predicted at output port i=1..4, which are proxy for the actual
-        // BU predictions of the input buffers in downsteam routers; these
-        // are used in algorithm 1 of Li Shang paper; 
-        double _BU_predicted_out_i[5];
-        double _BU_predicted_out_i_last[5];
+        // physical ports of the router, PE port included; 5 in the 2D mesh;
+        long _ports_count;
+        // BU predicted at output port i=1..4 (in the 2D mesh), which are proxy
+        // for the actual BU predictions of the input buffers in downsteam 
+        // routers; these are used in algorithm 1 of Li Shang paper; 
+        vector<double> _BU_predicted_out_i;
+        vector<double> _BU_predicted_out_i_last;
         // link utilization predicted for the link driven by the aforementioned
         // output port; also used in algorithm 1 of Li Shang paper; 
-        double _LU_predicted_out_i[5]; 
-        double _LU_predicted_out_i_last[5]; 
+        vector<double> _LU_predicted_out_i; 
+        vector<double> _LU_predicted_out_i_last; 
         // denuminator of eq. 2 in Li Shang paper; this counter is
         // reset at the end of the control period when actaul predictions 
         // are made;
         long _counter_router_own_cycles;
         // numerator of eq. 2 in Li Shang paper;
-        long _counter_flits_sent_during_hw[5];
+        vector<long> _counter_flits_sent_during_hw;
 
         // ovearll BU utilization for this router; looks at all input ports
         // of this buffer itself; used in the freq. throttle section 
@@ -57,7 +59,13 @@ class PREDICTOR_MODULE {
 
     public:
         PREDICTOR_MODULE( PREDICTOR_TYPE predictor_type,
-            long control_period, long history_window) {
+            long control_period, long history_window, long ports_count) :
+            _ports_count(ports_count),
+            _BU_predicted_out_i( ports_count, 0.0),
+            _BU_predicted_out_i_last( ports_count, 0.0),
+            _LU_predicted_out_i( ports_count, 0.0),
+            _LU_predicted_out_i_last( ports_count, 0.0),
+            _counter_flits_sent_during_hw( ports_count, 0) {
             _predictor_type = predictor_type;
             _control_period = control_period; // 50 cycles by default;
 
@@ -68,13 +76,6 @@ class PREDICTOR_MODULE {
 
             _BU_predicted_all_inputs = 0.0;
             _BU_predicted_all_inputs_last = 0.0;
-            for (long i = 1; i < 5; i++) {
-                _BU_predicted_out_i[i] = 0.0;
-                _BU_predicted_out_i_last[i] = 0.0;
-                _LU_predicted_out_i[i] = 0.0; // LU related;
-                _LU_predicted_out_i_last[i] = 0.0; // LU related;
-                _counter_flits_sent_during_hw[i] = 0; // LU related;
-            }
             _counter_router_own_cycles = 0; // used for BU, LU;
             
             _predictions_count = 1;
@@ -95,7 +96,8 @@ class PREDICTOR_MODULE {
         void update_DVFS_settings_throttle_and_boost( ROUTER *my_router);
         
         void record_flit_transmission_for_LU_calculation(long i) {
-            // i is 1..4 as the index of any of the four output ports;
+            // i is 1..4 as the index of any of the four output ports
+            // (in the 2D mesh);
             _counter_flits_sent_during_hw[i] ++;
         }
         void reset_all_BU_related_variables() {
@@ -105,7 +107,7 @@ class PREDICTOR_MODULE {
             // to keep track of calculations during the next history
             // window;
             _BU_predicted_all_inputs = 0.0;
-            for (long i = 1; i < 5; i++) {
+            for (long i = 1; i < _ports_count; i++) {
                 _BU_predicted_out_i[i] = 0.0;
             }
         }        
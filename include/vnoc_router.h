@@ -12,8 +12,11 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <pthread.h>
 
 #include "vnoc_topology.h"
+#include "vnoc_network.h"
+#include "vnoc_arbiter.h"
 #include "vnoc_predictor.h"
 
 
@@ -28,42 +31,198 @@ extern "C" {
 #include "SIM_clock.h"
 #include "SIM_array.h"
 #include "SIM_router_power.h"
+#include "SIM_util.h"
 }
 
 
 using namespace std;
 
 class EVENT;
+class EVENT_KEY;
+class EVENT_QUEUE;
 class ROUTER;
 class VNOC;
 
 
 ////////////////////////////////////////////////////////////////////////////////
 //
-// POWER_MODULE
+// POWER_ACTIVITY
+//
+// activity of a router since the start of the simulation: number of
+// accesses and of bits that switched, per component; kept as plain counters,
+// so that flits only cost a few popcounts and adds; the energy, which is
+// counters times Orion's per-switch energies (e.g., e_chg_in, e_chg_out),
+// is computed from these by POWER_MODEL only when reports or DVFS
+// windows need it; so, energy is the same as if each flit was recorded;
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-class POWER_MODULE {
-    ROUTER *_router; // its owner;
-    long _flit_size;
+class POWER_ACTIVITY {
+    public:
+        LIB_Type_max_uint _buffer_writes; // words;
+        LIB_Type_max_uint _buffer_write_toggles;
+        LIB_Type_max_uint _buffer_reads; // words;
+        LIB_Type_max_uint _buffer_read_ones;
+        LIB_Type_max_uint _crossbar_in_toggles;
+        LIB_Type_max_uint _crossbar_out_toggles;
+        LIB_Type_max_uint _crossbar_port_changes;
+        LIB_Type_max_uint _arbiter_records;
+        LIB_Type_max_uint _arbiter_req_toggles;
+        LIB_Type_max_uint _arbiter_grant_changes;
+        LIB_Type_max_uint _link_toggles;
+        long _cycles;
+    public:
+        POWER_ACTIVITY() { clear(); }
+        ~POWER_ACTIVITY() {}
+
+        void clear() {
+            _buffer_writes = 0; _buffer_write_toggles = 0;
+            _buffer_reads = 0; _buffer_read_ones = 0;
+            _crossbar_in_toggles = 0; _crossbar_out_toggles = 0;
+            _crossbar_port_changes = 0;
+            _arbiter_records = 0; _arbiter_req_toggles = 0;
+            _arbiter_grant_changes = 0;
+            _link_toggles = 0;
+            _cycles = 0;
+        }
+        void add(const POWER_ACTIVITY &other) {
+            _buffer_writes += other._buffer_writes;
+            _buffer_write_toggles += other._buffer_write_toggles;
+            _buffer_reads += other._buffer_reads;
+            _buffer_read_ones += other._buffer_read_ones;
+            _crossbar_in_toggles += other._crossbar_in_toggles;
+            _crossbar_out_toggles += other._crossbar_out_toggles;
+            _crossbar_port_changes += other._crossbar_port_changes;
+            _arbiter_records += other._arbiter_records;
+            _arbiter_req_toggles += other._arbiter_req_toggles;
+            _arbiter_grant_changes += other._arbiter_grant_changes;
+            _link_toggles += other._link_toggles;
+            _cycles += other._cycles;
+        }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// POWER_MODEL
+//
+// the Orion structs of a router configuration at an operating point (Vdd,
+// freq.), i.e., its capacitances and per-switch energies; there is one for
+// each DVFS level; computed once, when the first router of this
+// configuration is built, and then shared read-only by all its routers
+// (see VNOC::power_models()); their counters stay zero; a router's energy is
+// computed on a scratch copy of the component, into which its activity 
+// is recorded; so, routers (of different threads too) never write here;
+// with power_cache:, models are saved to a file of that directory, one per
+// configuration, and next runs load them instead of doing Orion's init;
+// a file is made again if Orion's sources or flags changed (their 
+// checksum, SIM_sources_fingerprint, is in the file); the technology
+// node, transistor type and buffer sizes are those of the topology;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class POWER_MODEL {
+    private:
+        //SIM_power_router_info_t _router_info; // orion1
+        SIM_router_info_t _router_info; // orion2
+        //router_info_t _router_info; // orion3
+
+        //SIM_power_router_t _router_power; // orion1
+        SIM_router_power_t _router_power; // orion2
+        //router_power_t _router_power; // orion3
+
+        //SIM_power_arbiter_t _arbiter_vc_power; // orion1
+        SIM_arbiter_t _arbiter_vc_power; // orion2
+
+        //SIM_power_bus_t _link_power;
+        SIM_bus_t _link_power;
+
+        // clock energy of 4 cycles (one per router pipe stage);
+        double _clock_energy;
+        // bits that Orion counts toggles of;
+        LIB_Type_max_uint _buffer_write_mask;
+        LIB_Type_max_uint _buffer_read_mask;
+        LIB_Type_max_uint _crossbar_mask;
+        LIB_Type_max_uint _link_mask;
+
+    public:
+        // vdd in V and freq in Hz;
+        POWER_MODEL(long physical_ports_count, long vc_count,
+                    double link_length, int arbiter_model,
+                    double vdd, double freq, const TOPOLOGY *topology);
+        ~POWER_MODEL() {}
+
+        LIB_Type_max_uint buffer_write_mask() const { return _buffer_write_mask; }
+        LIB_Type_max_uint buffer_read_mask() const { return _buffer_read_mask; }
+        LIB_Type_max_uint crossbar_mask() const { return _crossbar_mask; }
+        LIB_Type_max_uint link_mask() const { return _link_mask; }
+
+        // energies (J) of the activity;
+        double buffer_energy(const POWER_ACTIVITY &activity) const;
+        double crossbar_energy(const POWER_ACTIVITY &activity) const;
+        double arbiter_energy(const POWER_ACTIVITY &activity) const;
+        double link_energy(const POWER_ACTIVITY &activity) const;
+        double clock_energy(const POWER_ACTIVITY &activity) const;
 
-    //SIM_power_router_info_t _router_info; // orion1
-    SIM_router_info_t _router_info; // orion2
-    //router_info_t _router_info; // orion3
+    private:
+        void init_orion(long physical_ports_count, long vc_count,
+                        double link_length, int arbiter_model,
+                        double vdd, double freq, const TOPOLOGY *topology);
+        // parts of the model that are saved to cache files, in order;
+        void saved_parts(vector<pair<char *, size_t> > &parts);
+        bool load(const string &file_name, const string &header);
+        void save(const string &cache_dir, const string &file_name,
+                  const string &header);
+};
 
-    //SIM_power_router_t _router_power; // orion1
-    SIM_router_power_t _router_power; // orion2
-    //router_power_t _router_power; // orion3
+// what a POWER_MODEL is made of; key of VNOC::_power_models;
+class POWER_MODEL_KEY {
+    public:
+        long _physical_ports_count;
+        long _vc_count;
+        double _link_length;
+        int _arbiter_model;
+        double _vdd;
+        double _freq;
+    public:
+        POWER_MODEL_KEY( long physical_ports_count, long vc_count,
+            double link_length, int arbiter_model, double vdd, double freq) :
+            _physical_ports_count(physical_ports_count), _vc_count(vc_count),
+            _link_length(link_length), _arbiter_model(arbiter_model),
+            _vdd(vdd), _freq(freq) {}
+        ~POWER_MODEL_KEY() {}
+};
 
-    SIM_router_area_t _router_area; // orion2
-    //router_area_t _router_area; // orion3
+inline bool operator<(const POWER_MODEL_KEY &a, const POWER_MODEL_KEY &b) {
+    if ( a._physical_ports_count != b._physical_ports_count) {
+        return a._physical_ports_count < b._physical_ports_count;
+    }
+    if ( a._vc_count != b._vc_count) {
+        return a._vc_count < b._vc_count;
+    }
+    if ( a._link_length != b._link_length) {
+        return a._link_length < b._link_length;
+    }
+    if ( a._arbiter_model != b._arbiter_model) {
+        return a._arbiter_model < b._arbiter_model;
+    }
+    if ( a._vdd != b._vdd) {
+        return a._vdd < b._vdd;
+    }
+    return a._freq < b._freq;
+}
 
-    //SIM_power_arbiter_t _arbiter_vc_power; // orion1
-    SIM_arbiter_t _arbiter_vc_power; // orion2
+////////////////////////////////////////////////////////////////////////////////
+//
+// POWER_MODULE
+//
+////////////////////////////////////////////////////////////////////////////////
 
-    //SIM_power_bus_t _link_power;
-    SIM_bus_t _link_power;
+class POWER_MODULE {
+    ROUTER *_router; // its owner;
+    // shared by all routers of the same configuration; one for each
+    // DVFS level, made with the Vdd and freq. of the level;
+    vector<const POWER_MODEL *> _models;
+    long _flit_size;
 
     vector<DATA> _buffer_write;
     vector<DATA> _buffer_read;
@@ -71,22 +230,23 @@ class POWER_MODULE {
     vector<DATA> _crossbar_write;
     vector<DATA> _link_traversal;
     vector<long> _crossbar_input;
-    vector<vector<DATA_ATOMIC_UNIT> > _arbiter_vc_req;
+    // last request vector (one 64-bit word per 64 input vc's) and grant
+    // of the vc arbiter of each output port, vc;
+    vector<vector<vector<DATA_ATOMIC_UNIT> > > _arbiter_vc_req;
     vector<vector<unsigned long> > _arbiter_vc_grant;
+    // activity since the start, while at each DVFS level; the current
+    // level is the one counted by the power_* functions;
+    vector<POWER_ACTIVITY> _activities;
+    long _dvfs_level;
     // freq. boost/throttle;
-    // sketch variables to store scaled (up or down - depending
-    // on if its freq. boost or throttle) energy; if working at
-    // the default Vdd, then scaling factor is 1;
-    // _scaled_energy will store total energy spent so far,
-    // until current time; it scaled according to how Vdd has been 
-    // scaled; for example normally we could have a run till 100 n
-    // for default value of Vdd=1.2V for which energy is say e = 100 J;
+    // _scaled_energy will store total energy spent so far, until the last
+    // call of scale_and_accumulate_energy(); the activity at each DVFS
+    // level is priced with the Orion models of that level, i.e., of 
+    // its Vdd and freq.; for example normally we could have a run till 
+    // 100 ns for default value of Vdd=1.2V for which energy is say e = 100 J;
     // if say at time 70 ns we would throttle freq. (which would also 
-    // require to lower Vdd) then the energy would have to be
-    // e = e1 + e2 = 70 + 30*energy_scaling_factor (less energy);
-    // this "e" will be stored by _scaled_energy, which is
-    // the accumulated energy with the appropriate scalings for
-    // different periods of time according to how Vdd changed;
+    // require to lower Vdd) then the energy would be e = e1 + e2, where
+    // e2 is priced by the models of the lower Vdd (less energy);
     // note that because freq is lower not all packets would have been
     // processed (as in the default case) and to finish them we
     // would have to continue simulation longer which will increase 
@@ -96,38 +256,28 @@ class POWER_MODULE {
     // Note: freq will be boosted or throttled by changing the clock
     // when events are created during simulation;
     double _scaled_energy; 
-    // _prev_unscaled_energy stores the value of total accumulated energy
-    // (as computed, unscaled by Orion) till the last time when a recording
-    // took place; needed to compute "delta" of energy that needs to be 
-    // scaled and accumulated;
-    double _prev_unscaled_energy;
     // components;
     double _scaled_energy_buffer; 
-    double _prev_unscaled_energy_buffer;
     double _scaled_energy_crossbar; 
-    double _prev_unscaled_energy_crossbar;
     double _scaled_energy_arbiter; 
-    double _prev_unscaled_energy_arbiter;
     double _scaled_energy_link; 
-    double _prev_unscaled_energy_link;
     double _scaled_energy_clock; 
-    double _prev_unscaled_energy_clock;
 
-    double _current_vdd;
-    double _current_period; // Tclock = 1/current_freq;
-    double _energy_scaling_factor;
+    double _current_period; // Tclock = 1/current_freq; in cycles;
 
  public:
-    POWER_MODULE(long physical_ports_count, long vc_count,
-                 long flit_size, double link_length);
+    POWER_MODULE(const vector<const POWER_MODEL *> &models,
+                 long physical_ports_count, long vc_count, long flit_size);
     ~POWER_MODULE() {}
 
-    void power_buffer_read(long in_port, DATA & read_d);
-    void power_buffer_write(long in_port, DATA & write_d);
-    void power_crossbar_trav(long in_port, long out_port, DATA & trav_d);
-    void power_vc_arbit(long pc, long vc, DATA_ATOMIC_UNIT req, unsigned long gra);
-    void power_link_traversal(long in_port, DATA & read_d);
-    void power_clock_record();
+    void power_buffer_read(long in_port, const DATA_ATOMIC_UNIT *read_d);
+    void power_buffer_write(long in_port, const DATA_ATOMIC_UNIT *write_d);
+    void power_crossbar_trav(long in_port, long out_port, const DATA_ATOMIC_UNIT *trav_d);
+    void power_vc_arbit(long pc, long vc, const BIT_VECTOR &req, unsigned long gra);
+    void power_link_traversal(long in_port, const DATA_ATOMIC_UNIT *read_d);
+    void power_clock_record(long cycles = 1);
+    // energy of all activity as if it was at the base level (i.e., the
+    // default Vdd and freq.);
     double power_buffer_report();
     double power_link_report();
     double power_crossbar_report();
@@ -135,10 +285,9 @@ class POWER_MODULE {
     double power_clock_report();
     
     // utils;
-    void set_current_vdd(double vdd) { _current_vdd = vdd; }
+    void set_dvfs_level(DVFS_LEVEL level) { _dvfs_level = level; }
     void set_current_period(double tick) { _current_period = tick; }
     double current_period() const { return _current_period; }
-    void set_energy_scaling_factor(double esf) { _energy_scaling_factor = esf; }
     double scaled_energy() const { return _scaled_energy; }
     double scaled_energy_buffer() const { return _scaled_energy_buffer; }
     double scaled_energy_crossbar() const { return _scaled_energy_crossbar; }
@@ -148,6 +297,10 @@ class POWER_MODULE {
 
     // freq. boost/throttle;
     void scale_and_accumulate_energy(); 
+
+ private:
+    // activity of all levels together;
+    POWER_ACTIVITY total_activity() const;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,42 +309,170 @@ class POWER_MODULE {
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+// flits are plain, trivially copyable objects that live in the FLIT_POOL;
+// a flit is written once, when its packet is injected, and is not copied
+// after that; source and destination are kept as router id's (id = x * ny + y)
+// and the payload is stored inline; only the first flit_size words of
+// the payload are used;
 class FLIT {
     public:
         enum FLIT_TYPE { HEADER, BODY, TAIL };
     private:
-        long _id;
+        int _id; // index of this flit inside its packet;
         FLIT_TYPE _type;
-        double _start_time;
-        double _finish_time;
-        ADDRESS _src_addr;
-        ADDRESS _des_addr;
-        DATA _data; // vector<unsigned long long>;
+        int _src_router_id;
+        int _des_router_id;
+        long _packet_id; // packet counter of the source router;
+        SIM_TIME _start_time; // in ticks;
+        SIM_TIME _finish_time;
+        DATA_ATOMIC_UNIT _data[FLIT_MAX_SIZE];
 
     public:
-        FLIT() : _id(0), _type(HEADER), _src_addr(0), _des_addr(0), 
-            _start_time(0), _finish_time(0), _data() {}
-        FLIT( long id, FLIT_TYPE type, ADDRESS &src, ADDRESS &des,
-            double start_time, const DATA &data) : 
-            _id(0), _type(type), 
-            _src_addr(src), _des_addr(des), 
-            _start_time(start_time), _finish_time(0), 
-            _data(data) {}
-        FLIT( const FLIT &f) : _id(f.id()), _type(f.type()),
-            _src_addr(f.src_addr()), _des_addr(f.des_addr()),
-            _start_time(f.start_time()), _finish_time(f.finish_time()), 
-            _data(f.data()) {}
-        ~FLIT() {}
+        FLIT() : _id(0), _type(HEADER), _src_router_id(0), _des_router_id(0),
+            _packet_id(0), _start_time(0), _finish_time(0) {
+            memset( _data, 0, sizeof(_data));
+        }
+        FLIT( int id, long packet_id, FLIT_TYPE type, 
+            long src_router_id, long des_router_id,
+            SIM_TIME start_time, const DATA_ATOMIC_UNIT *data, long data_size) : 
+            _id(id), _type(type), 
+            _src_router_id(src_router_id), _des_router_id(des_router_id), 
+            _packet_id(packet_id), _start_time(start_time), _finish_time(0) {
+            assert( data_size <= FLIT_MAX_SIZE);
+            memset( _data, 0, sizeof(_data));
+            memcpy( _data, data, data_size * sizeof(DATA_ATOMIC_UNIT));
+        }
 
         int id() const { return _id; }
         void set_id(int id) { _id = id; }
+        long packet_id() const { return _packet_id; }
         FLIT_TYPE type() const { return _type; }
-        double start_time() const { return _start_time; }
-        double finish_time() const { return _finish_time; }
-        ADDRESS src_addr() const { return _src_addr; }
-        ADDRESS des_addr() const { return _des_addr; }
-        DATA &data() { return _data; }
-        const DATA &data() const { return _data; }
+        SIM_TIME start_time() const { return _start_time; }
+        SIM_TIME finish_time() const { return _finish_time; }
+        long src_router_id() const { return _src_router_id; }
+        long des_router_id() const { return _des_router_id; }
+        DATA_ATOMIC_UNIT *data() { return _data; }
+        const DATA_ATOMIC_UNIT *data() const { return _data; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// FLIT_POOL
+//
+// storage of all flits of a simulation; buffers and links carry only
+// handles (32-bit indices into the pool) of flits; flits are stored in 
+// slabs of FLIT_SLAB_SIZE flits, which are never moved or freed while the
+// simulation runs; so, a flit stays in place from injection until it is 
+// consumed at its destination; each router keeps a few free handles of
+// its own (see ROUTER::new_flit()), which go to and come from the pool in
+// batches; only the batches take the lock, needed because routers of the 
+// parallel engines get here from different threads;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+typedef unsigned int FLIT_HANDLE;
+
+#define FLIT_SLAB_BITS 12
+#define FLIT_SLAB_SIZE (1 << FLIT_SLAB_BITS)
+#define FLIT_SLABS_MAX (1 << 16) // at most 2^28 flits in flight;
+#define FLIT_BATCH_SIZE 64
+
+class FLIT_POOL {
+    private:
+        // pointers to slabs; sized to FLIT_SLABS_MAX upfront so that it is
+        // never reallocated while other threads read it;
+        vector<FLIT *> _slabs;
+        long _slabs_count;
+        vector<FLIT_HANDLE> _free_handles;
+        pthread_mutex_t _mutex;
+
+    public:
+        FLIT_POOL();
+        ~FLIT_POOL();
+
+        FLIT &flit( FLIT_HANDLE handle) { 
+            return _slabs[ handle >> FLIT_SLAB_BITS][ handle & (FLIT_SLAB_SIZE - 1)];
+        }
+        long flits_count() const { return _slabs_count * FLIT_SLAB_SIZE; }
+        // moves FLIT_BATCH_SIZE free handles to the end of handles; 
+        void get_batch( vector<FLIT_HANDLE> &handles);
+        // moves the last FLIT_BATCH_SIZE handles of handles back to the pool;
+        void put_batch( vector<FLIT_HANDLE> &handles);
+
+    private:
+        // not copyable;
+        FLIT_POOL( const FLIT_POOL &);
+        FLIT_POOL &operator=( const FLIT_POOL &);
+        void add_slab();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// LINK
+//
+// delay line of one physical link: the flits on their way to one input
+// port of a router or the credits on their way back to one output port;
+// the sending router adds each flit (or credit) with its arrival time and
+// the time and router it was sent at and by; i.e., the key its LINK (or 
+// CREDIT) event would have had in the simulation-queue (see EVENT_KEY); 
+// the receiving router takes in those that come before its cycle, when 
+// it's simulated; this gives the same results as the events, without 
+// adding them to the queue;
+// only the sender adds and only the receiver takes; so, they can run on
+// different threads (single producer, single consumer ring);
+// the ring never grows: with credit based flow control, flits (or 
+// credits) on a link are never more than the vc buffers of its port;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class LINK_SLOT {
+    public:
+        SIM_TIME _arrival_time;
+        SIM_TIME _sent_time;
+        long _sender_id;
+        long _vc;
+        FLIT_HANDLE _flit; // not used by credits;
+    public:
+        LINK_SLOT() : _arrival_time(0), _sent_time(0), _sender_id(-1),
+            _vc(0), _flit(0) {}
+        LINK_SLOT( SIM_TIME arrival_time, SIM_TIME sent_time, long sender_id,
+            long vc, FLIT_HANDLE flit) : _arrival_time(arrival_time),
+            _sent_time(sent_time), _sender_id(sender_id), _vc(vc), _flit(flit) {}
+        ~LINK_SLOT() {}
+};
+
+class LINK {
+    private:
+        vector<LINK_SLOT> _slots;
+        unsigned long _mask;
+        // written only by the receiver and by the sender, respectively;
+        unsigned long _head;
+        unsigned long _tail;
+        ROUTER *_receiver;
+        long _receiver_port;
+        // pipeline registers; flits (or credits) take ( _stages + 1) wire
+        // (or credit) delays;
+        long _stages;
+    public:
+        LINK() : _slots(), _mask(0), _head(0), _tail(0), _receiver(0),
+            _receiver_port(-1), _stages(0) {}
+        ~LINK() {}
+
+        void init( unsigned long capacity, ROUTER *receiver, long receiver_port,
+            long stages);
+        ROUTER *receiver() const { return _receiver; }
+        long receiver_port() const { return _receiver_port; }
+        long stages() const { return _stages; }
+        // sender side;
+        void push( const LINK_SLOT &slot);
+        // receiver side; front() is 0 if empty;
+        bool empty() const { 
+            return _head == __atomic_load_n( &_tail, __ATOMIC_ACQUIRE);
+        }
+        const LINK_SLOT *front() const {
+            return empty() ? 0 : &_slots[ _head & _mask];
+        }
+        void pop() { __atomic_store_n( &_head, _head + 1, __ATOMIC_RELEASE); }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -203,13 +484,19 @@ class FLIT {
 class ROUTER_INPUT {
     private:
         ROUTER *_router; // its owner;
-        // input buffers: <physical port index<vc index<buffer>>>
-        vector<vector<vector<FLIT> > > _input_buff;
+        // input buffers: <physical port index<vc index<buffer of flit handles>>>
+        vector<vector<RING_QUEUE<FLIT_HANDLE> > > _input_buff;
         // state of each input vc;
         vector<vector<VC_STATE> > _vc_state; // IDLE, ROUTING, VC_AB, SW_AB, SW_TR, HOME
+        // one mask for each VC_STATE; bit i * vc_count + j is set if input
+        // port "i", vc index "j" is in that state; used by the allocators
+        // to visit only the vc's that request something;
+        vector<BIT_VECTOR> _vc_state_masks;
+        long _vc_count;
         // candidate routing vcs; this stores the routing matrix/mapping
         // between inputs and outputs; recall that: typedef pair<long,long> VC_PAIR;
-        vector<vector<vector<VC_PAIR> > > _routing; // pair<long, long>
+        // each one points to a list of the routing tables (see NETWORK);
+        vector<vector<const vector<VC_PAIR> *> > _routing;
         // the selected routing vc;
         vector<vector<VC_PAIR> > _selected_routing;
         // this is a flag record that the buffer of injection is full;
@@ -217,34 +504,35 @@ class ROUTER_INPUT {
         bool _injection_buff_full;
 
     public:
-        ROUTER_INPUT(long physical_ports_count, long vc_count);
+        ROUTER_INPUT(long physical_ports_count, long vc_count, long buffer_size);
         ROUTER_INPUT();
         ~ROUTER_INPUT() {}
 
     public:
         // _input_buff;
-        vector<vector<vector<FLIT> > > &input_buff() { return _input_buff; }
-        const vector<vector<vector<FLIT> > > &input_buff() const 
+        vector<vector<RING_QUEUE<FLIT_HANDLE> > > &input_buff() { return _input_buff; }
+        const vector<vector<RING_QUEUE<FLIT_HANDLE> > > &input_buff() const 
             { return _input_buff; }
-        vector<FLIT> &input_buff(long i, long j) { return _input_buff[i][j]; } 
-        const vector<FLIT> &input_buff(long i, long j) const 
+        RING_QUEUE<FLIT_HANDLE> &input_buff(long i, long j) { return _input_buff[i][j]; } 
+        const RING_QUEUE<FLIT_HANDLE> &input_buff(long i, long j) const 
             { return _input_buff[i][j]; }
         //_vc_state;
-        vector<vector<VC_STATE> > &vc_state() { return _vc_state; }
         const vector<vector<VC_STATE> > &vc_state() const { return _vc_state; }
         VC_STATE vc_state(long i, long j) { return _vc_state[i][j]; }
         const VC_STATE vc_state(long i, long j) const { return _vc_state[i][j]; }
-        void vc_state_update(long i, long j, VC_STATE state)
-            { _vc_state[i][j] = state;}
+        void vc_state_update(long i, long j, VC_STATE state) { 
+            _vc_state_masks[ _vc_state[i][j]].reset( i * _vc_count + j);
+            _vc_state_masks[ state].set( i * _vc_count + j);
+            _vc_state[i][j] = state;
+        }
+        const BIT_VECTOR &vc_state_mask(VC_STATE state) const 
+            { return _vc_state_masks[state]; }
         // _routing;
-        vector<vector<vector<VC_PAIR> > > &routing() { return _routing; }
-        const vector<vector<vector<VC_PAIR> > > &routing() const 
-            { return _routing; }
-        vector<VC_PAIR> &routing(long i, long j) { return _routing[i][j];}
         const vector<VC_PAIR> &routing(long i, long j) const 
-            { return _routing[i][j]; }
-        void add_routing(long i, long j, VC_PAIR t) { _routing[i][j].push_back(t); }
-        void clear_routing(long i, long j) { _routing[i][j].clear(); }
+            { return *_routing[i][j]; }
+        void set_routing(long i, long j, const vector<VC_PAIR> *t) 
+            { _routing[i][j] = t; }
+        void clear_routing(long i, long j) { _routing[i][j] = 0; }
         // _selected_routing;
         vector<vector<VC_PAIR> > &selected_routing() { return _selected_routing; }
         const vector<vector<VC_PAIR> > & selected_routing() const 
@@ -258,15 +546,15 @@ class ROUTER_INPUT {
             { _selected_routing[i][j] = VC_NULL; }
 
         // utils;
-        void add_flit(long i, long j, const FLIT &flit) 
+        void add_flit(long i, long j, FLIT_HANDLE flit) 
             { _input_buff[i][j].push_back(flit); }
         void remove_flit(long i, long j)
-            { _input_buff[i][j].erase(_input_buff[i][j].begin()); }
-        FLIT &get_flit(long i, long j) {
+            { _input_buff[i][j].pop_front(); }
+        FLIT_HANDLE get_flit(long i, long j) const {
             assert( _input_buff[i][j].size() > 0);
-            return ( _input_buff[i][j][0]); 
+            return ( _input_buff[i][j].front()); 
         }
-        FLIT &get_flit(long i, long j, long k) {
+        FLIT_HANDLE get_flit(long i, long j, long k) const {
             assert( _input_buff[i][j].size() > k);
             return ( _input_buff[i][j][k]); 
         }
@@ -294,8 +582,8 @@ class ROUTER_OUTPUT {
         // assigned to the input
         vector<vector<VC_PAIR> > _assigned_to; // pair<long, long>
         vector<vector<VC_USAGE> > _vc_usage; // USED FREE
-        vector<vector<FLIT> > _out_buffer; // actual local output buffers;
-        vector<vector<VC_PAIR> > _out_addr; // output address;
+        vector<RING_QUEUE<FLIT_HANDLE> > _out_buffer; // actual local output buffers;
+        vector<RING_QUEUE<VC_PAIR> > _out_addr; // output address;
         vector<long> _local_counter; // one for each output port;
 
     public:
@@ -322,25 +610,25 @@ class ROUTER_OUTPUT {
         VC_USAGE vc_usage(long i, long j) { return _vc_usage[i][j]; }
         VC_USAGE vc_usage(long i, long j) const { return _vc_usage[i][j]; }
         
-        void add_flit(long i, const FLIT &flit)
+        void add_flit(long i, FLIT_HANDLE flit)
             { _out_buffer[i].push_back(flit); _local_counter[i]--; }
         void remove_flit(long i);
-        FLIT &get_flit(long i) {
+        FLIT_HANDLE get_flit(long i) const {
             assert( _out_buffer[i].size() > 0);
-            return _out_buffer[i][0];
+            return _out_buffer[i].front();
         }
-        vector<FLIT> &out_buffer(long i) { return _out_buffer[i]; }
-        const vector<FLIT> &out_buffer(long i) const 
+        RING_QUEUE<FLIT_HANDLE> &out_buffer(long i) { return _out_buffer[i]; }
+        const RING_QUEUE<FLIT_HANDLE> &out_buffer(long i) const 
             { return _out_buffer[i]; }
 
-        vector<vector<VC_PAIR> > out_addr() { return _out_addr; }
-        const vector<vector<VC_PAIR> > out_addr() const { return _out_addr; }
-        vector<VC_PAIR> out_addr(long i) { return _out_addr[i];}
-        const vector<VC_PAIR> out_addr(long i) const { return _out_addr[i]; }
-        VC_PAIR get_addr(long i) { return _out_addr[i][0];}
+        vector<RING_QUEUE<VC_PAIR> > &out_addr() { return _out_addr; }
+        const vector<RING_QUEUE<VC_PAIR> > &out_addr() const { return _out_addr; }
+        RING_QUEUE<VC_PAIR> &out_addr(long i) { return _out_addr[i];}
+        const RING_QUEUE<VC_PAIR> &out_addr(long i) const { return _out_addr[i]; }
+        VC_PAIR get_addr(long i) { return _out_addr[i].front();}
         void remove_addr(long i) { 
             assert( _out_addr[i].size() > 0); 
-            _out_addr[i].erase( _out_addr[i].begin());
+            _out_addr[i].pop_front();
         }
         void add_addr(long i, VC_PAIR b) { _out_addr[i].push_back(b); }
 
@@ -360,6 +648,17 @@ class ROUTER_OUTPUT {
 class ROUTER {
     private:
         VNOC *_vnoc; // its owner, which has EVENT_QUEUE *_event_queue as well;
+        // where events of this router go; same as the one of the owner, 
+        // except for parallel engines, where each tile (or worker) has its
+        // own queue;
+        EVENT_QUEUE *_event_queue;
+        // stream of this router (packets injected); arbiters have their own;
+        RANDOM_NUMBER_GENERATOR _rng;
+        // the pool of the owner, where flits are stored; and free handles
+        // of this router: handles of flits consumed here are reused by 
+        // packets injected here;
+        FLIT_POOL *_flit_pool;
+        vector<FLIT_HANDLE> _free_flits;
         // for 2D meshes, address is just a vector with two elements; x and y;
         ADDRESS _address;
         long _id;
@@ -374,22 +673,22 @@ class ROUTER {
 
         // initial random number
         DATA _init_data;
-        long _ary_size;
         long _flit_size; // how many groups of "64 bits";
         long _physical_ports_count;
         long _vc_number;
         long _buffer_size; // of each virtual channel;
         long _out_buffer_size; // of each vc out buffer size;
         // accumulated total "propagation" delay of all packets with destination
-        // (i.e., consumed) by this router;
+        // (i.e., consumed) by this router; in cycles;
         double _total_delay;
-        ROUTING_ALGORITHM _routing_algo; // routing algorithm used;
+        // compiled topology; gives the routes of the routing algorithm used;
+        const NETWORK *_network;
         // local_injection_time is used only with tracefile traffic, when
         // injection times are read from local files of type tests/bench.x.y
         // and where injection times may be real numbers in between "integer"
         // edges of the clock that is mimic-ed by simulation engine
         // each time when an event of type ROUTER is processed;
-        double _local_injection_time; // used for the next packet injection time;
+        SIM_TIME _local_injection_time; // used for the next packet injection time;
         long _inj_packet_counter;
         // number of packet injection atempts that failed during
         // synthetic traffic; it happens due to PE input buffer being
@@ -407,23 +706,81 @@ class ROUTER {
         // DVFS_BOOST, DVFS_BASE, DVFS_THROTTLE_1, DVFS_THROTTLE_2
         DVFS_LEVEL _dvfs_level; 
         DVFS_LEVEL _dvfs_level_prev; // previous "cycle" dvfs level;
-        double _wire_delay;
-        double _pipe_delay;
-        double _credit_delay;
+        // in ticks;
+        SIM_TIME _wire_delay;
+        SIM_TIME _pipe_delay;
+        SIM_TIME _credit_delay;
         // a hack to be able to keep ordering of flits being sent thru links
         // when frequency changes and could get something like a body flit get
         // faster than its header flits if a change in frequency happened;
-        vector<double> _can_send_on_link_after_time;
+        vector<SIM_TIME> _can_send_on_link_after_time;
+        // for each input port, flits on their way here; for each output 
+        // port, credits on their way here; see LINK;
+        vector<LINK> _flit_links;
+        vector<LINK> _credit_links;
+        // links of neighbors: where flits from each output port and credits
+        // from each input port go (0 at the edges of the mesh);
+        vector<LINK *> _downstream_flit_links;
+        vector<LINK *> _upstream_credit_links;
+
+        // a dormant router has nothing to do and is not in the simulation-
+        // queue; _next_tick_time is the time of its next (skipped) cycle
+        // and _last_tick_time the time of the cycle before it; see go_dormant();
+        bool _dormant;
+        SIM_TIME _last_tick_time;
+        SIM_TIME _next_tick_time;
 
         // summation of size of all input buffers of all vc's; stored
         // for faster computations of BU utilizations; 
         long _overall_size_input_buffs;
 
+        // allocators scratch storage; allocated once, in the constructor,
+        // and left all zero after each use;
+        // VC_AB: for each output port "o", vc index "v" (bit o * vc + v of
+        // _vc_ab_out_mask), the input vc's that requested it;
+        vector<BIT_VECTOR> _vc_ab_requests;
+        BIT_VECTOR _vc_ab_out_mask;
+        // VC_AB: all input vc's that requested some output vc;
+        BIT_VECTOR _vc_ab_request_vector;
+        // vc_selection: output vc's (o * vc + v) that are free candidates;
+        BIT_VECTOR _vc_sel_candidates;
+        // SW_AB: for each input port, its vc's that can send (and the mask 
+        // _sw_ab_in_mask of input ports that have at least one such vc);
+        // for each output port, the input ports that requested it;
+        // _sw_ab_in_vc stores which of its vc's each input port put forward
+        // (input first allocator); _sw_ab_grants stores for each input port
+        // the output ports that granted it (output first allocators);
+        vector<BIT_VECTOR> _sw_ab_eligible;
+        BIT_VECTOR _sw_ab_in_mask;
+        vector<BIT_VECTOR> _sw_ab_requests;
+        BIT_VECTOR _sw_ab_out_mask;
+        vector<long> _sw_ab_in_vc;
+        vector<BIT_VECTOR> _sw_ab_grants;
+        BIT_VECTOR _sw_ab_in_matched;
+        BIT_VECTOR _sw_ab_out_matched;
+        BIT_VECTOR _sw_ab_port_scratch; // of ports count bits;
+        BIT_VECTOR _sw_ab_vc_scratch; // of vc count bits;
+
+        // arbiters used by the allocators; see vnoc_arbiter.h;
+        // _vc_sel_arbiters: one per input vc, picks among output vc's;
+        // _vc_ab_arbiters: one per output vc, picks among input vc's;
+        // _sw_in_arbiters: one per input port, picks among its vc's;
+        // _sw_out_arbiters: one per output port, picks among input ports;
+        // _sw_accept_arbiters: one per input port, picks among the output
+        // ports that granted it (output first allocators only);
+        vector<ARBITER> _vc_sel_arbiters;
+        vector<ARBITER> _vc_ab_arbiters;
+        vector<ARBITER> _sw_in_arbiters;
+        vector<ARBITER> _sw_out_arbiters;
+        vector<ARBITER> _sw_accept_arbiters;
+        // wavefront allocator: diagonal that has highest priority;
+        long _sw_wavefront_priority;
+
 
     public:
         ROUTER( long physical_ports_count, long vc_number, long buffer_size, 
-                long out_buffer_size, const ADDRESS &address, long ary_size, 
-                long flit_size, VNOC *owner_vnoc, long id, double link_length,
+                long out_buffer_size, const ADDRESS &address, long flit_size,
+                VNOC *owner_vnoc, long id, double link_length,
                 PREDICTOR_TYPE predictor_type);
         ~ROUTER() {}
 
@@ -431,6 +788,8 @@ class ROUTER {
         long id() { return _id; }
         void set_owner(VNOC *vnoc) { _vnoc = vnoc; }
         VNOC *vnoc() { return _vnoc; }
+        EVENT_QUEUE *event_queue() { return _event_queue; }
+        void set_event_queue(EVENT_QUEUE *event_queue) { _event_queue = event_queue; }
         const vector<long> &address() const { return _address; }
         ROUTER_INPUT &input() { return _input; }
         ROUTER_OUTPUT &output() { return _output; }
@@ -450,17 +809,45 @@ class ROUTER {
         // retrieve packet from trace file associated with this;
         long receive_packet_from_local_trace_file();
         bool receive_packet_from_local_traffic_injector(long dest_id);
-        void inject_packet( long flit_id, ADDRESS &sor_addr, ADDRESS &des_addr,
-            double time, long packet_size);
+        void inject_packet( long packet_id, long src_router_id, long des_router_id,
+            SIM_TIME time, long packet_size);
 
         // flit and credit utils;
-        void receive_flit_from_upstream(long port_id, long vc_id, FLIT &flit);
-        void consume_flit(double t, const FLIT &flit);
+        FLIT &flit( FLIT_HANDLE handle) { return _flit_pool->flit( handle); }
+        FLIT_HANDLE new_flit();
+        void delete_flit( FLIT_HANDLE handle);
+        void receive_flit_from_upstream(long port_id, long vc_id, FLIT_HANDLE flit,
+            SIM_TIME arrival_time);
+        void consume_flit(SIM_TIME t, FLIT_HANDLE flit);
         void receive_credit(long i, long j);
 
+        // links;
+        LINK &flit_link( long port_id) { return _flit_links[ port_id]; }
+        LINK &credit_link( long port_id) { return _credit_links[ port_id]; }
+        void connect_to_neighbor( long port_id, ROUTER *neighbor, long neighbor_port_id);
+        void send_on_link( LINK *link, long vc, FLIT_HANDLE flit, SIM_TIME delay);
+        void receive_from_links();
+        bool flit_links_empty() const;
+
         // run simulation of this router;
         void simulate_one_router();
+        void maintain_dvfs_prediction();
+        SIM_TIME clock_period( DVFS_LEVEL level) const;
+
+        // dormant routers;
+        bool dormant() const { return _dormant; }
+        bool is_quiescent() const;
+        void go_dormant( SIM_TIME last_tick_time, SIM_TIME next_tick_time);
+        void wake_up();
+        EVENT_KEY next_tick_key() const;
+        void simulate_dormant_cycle();
+        void catch_up_dormant_cycles( const EVENT_KEY &bound);
         VC_PAIR vc_selection(long i, long j);
+        void sw_allocator_input_first();
+        void sw_allocator_output_first( long iterations);
+        void sw_allocator_wavefront();
+        void sw_allocator_grant( long i, long o);
+        bool vc_is_free_for_selection(const VC_PAIR &v_t) const;
         void routing_decision_stage_RC();
         void vc_arbitration_stage_VC_AB();
         void sw_arbitration_stage_SW_AB();
@@ -471,13 +858,13 @@ class ROUTER {
 
         ifstream &local_injection_file() { return *_local_injection_file; }
         void init_local_injection_file();
+        void read_local_injection_time();
         void close_injection_file() { 
             _local_injection_file->close();
             delete _local_injection_file;
         }
         void call_current_routing_algorithm(
-            const ADDRESS &des_t, const ADDRESS &sor_t,
-            long s_ph, long s_vc);
+            long des_router_id, long s_ph, long s_vc);
 
         // power estimations related;
         double power_buffer_report() { return _power_module.power_buffer_report(); }
@@ -509,9 +896,9 @@ class ROUTER {
         // DVFS related;
         DVFS_LEVEL dvfs_level() { return _dvfs_level; }
         DVFS_LEVEL dvfs_level_prev() { return _dvfs_level_prev; }
-        void set_wire_delay(double delay) { _wire_delay = delay; }
-        void set_pipe_delay(double delay) { _pipe_delay = delay; }
-        void set_credit_delay(double delay) { _credit_delay = delay; }
+        void set_wire_delay(SIM_TIME delay) { _wire_delay = delay; }
+        void set_pipe_delay(SIM_TIME delay) { _pipe_delay = delay; }
+        void set_credit_delay(SIM_TIME delay) { _credit_delay = delay; }
         void set_dvfs_level(DVFS_LEVEL level) { _dvfs_level = level; }
         void set_dvfs_level_prev(DVFS_LEVEL level) { _dvfs_level_prev = level; }
         void set_frequencies_and_vdd( DVFS_LEVEL to_level);
@@ -524,27 +911,4 @@ class ROUTER {
         }
 };
 
-////////////////////////////////////////////////////////////////////////////////
-//
-// LINK
-//
-////////////////////////////////////////////////////////////////////////////////
-
-class LINK {
-  private:
-    int _id;
-    int _x;
-    int _y;
-    
-  public:
-  LINK( int x, int y, int z) : _x(x), _y(y), _id(-1) {}
-    ~LINK() {}
-    
-    int id() const { return _id; }
-    void set_id(int id) { _id = id; }
-    
-};
-
-
-
 #endif
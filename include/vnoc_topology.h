@@ -11,14 +11,37 @@
 
 using namespace std;
 
-// DVFS related;
+// DVFS related; levels are indices in the DVFS table of TOPOLOGY;
 enum DVFS_LEVEL { DVFS_BOOST, DVFS_BASE, DVFS_THROTTLE_1, DVFS_THROTTLE_2 };
+const long DVFS_LEVELS_COUNT = 4;
 
 // predictors related;
 enum PREDICTOR_TYPE { EXPONENTIAL_AVERAGING, HISTORY, RECURSIVE_LEAST_SQUARE, ARMA };
 enum DVFS_MODE { ASYNC, SYNC };
 
-enum ROUTING_ALGORITHM { XY = 0, TXY = 1 };
+// up*/down* routes any topology (see NETWORK);
+enum ROUTING_ALGORITHM { XY = 0, TXY = 1, UP_DOWN = 2 };
+// scheduler used by EVENT_QUEUE; the calendar queue is the default; the
+// multiset is the original implementation and is kept for A/B comparisons;
+enum EVENT_QUEUE_TYPE { CALENDAR_EVENT_QUEUE, MULTISET_EVENT_QUEUE };
+// how EVENT_QUEUE::run_simulation() advances time; the cycle-driven engine
+// steps all routers each cycle; with dvfs, routers do not share a cycle
+// and it steps each clock domain by its own period instead, as the
+// clock-domain engine does; the PDES engine splits the mesh into tiles
+// simulated by parallel threads; the clock-domain engine simulates the
+// routers of a dvfs level that have the same clock edges with one event
+// per cycle (see CLOCK_DOMAIN);
+enum SIMULATION_ENGINE { EVENT_DRIVEN_ENGINE, CYCLE_DRIVEN_ENGINE, PARALLEL_ENGINE,
+    CLOCK_DOMAIN_ENGINE };
+// arbiters used by the vc and switch allocators; RANDOM is the original
+// behavior of vnoc; 
+enum ARBITER_TYPE { RANDOM_ARB, ROUND_ROBIN_ARB, MATRIX_ARB };
+// transistors of the technology tables of Orion (see POWER_MODEL);
+enum TRANSISTOR_TYPE { LVT_TRANSISTOR, NVT_TRANSISTOR, HVT_TRANSISTOR };
+// organization of the switch allocator; the vc allocator is always 
+// separable input-first;
+enum SW_ALLOCATOR_TYPE { SEPARABLE_INPUT_FIRST, SEPARABLE_OUTPUT_FIRST,
+    ISLIP_ALLOCATOR, WAVEFRONT_ALLOCATOR };
 // synthetic traffic type
 enum TRAFFIC_TYPE { UNIFORM_TRAFFIC, HOTSPOT_TRAFFIC, TRANSPOSE1_TRAFFIC,
     TRANSPOSE2_TRAFFIC, TRACEFILE_TRAFFIC, IPCORE_TRAFFIC, 
@@ -41,57 +64,59 @@ const VC_PAIR VC_NULL = VC_PAIR(-1,-1);
 
 #define REPORT_STATS_PERIOD 2000
 
+// simulation time is kept in integer ticks; one base clock cycle (at 
+// FREQ_BASE) is TICKS_PER_CYCLE ticks; 180 is the smallest number for which
+// the periods of all four clocks are whole numbers of ticks (see the 
+// delays below); so, times of events of routers at different frequencies 
+// are exact and compare exactly; times given in cycles (command line, trace
+// files) are converted once, when read, and results are converted back;
+typedef long long SIM_TIME;
+#define TICKS_PER_CYCLE 180
+
+inline SIM_TIME cycles_to_ticks( double cycles) {
+    return (SIM_TIME)floor( cycles * TICKS_PER_CYCLE + 0.5);
+}
+inline double ticks_to_cycles( SIM_TIME ticks) {
+    return double(ticks) / TICKS_PER_CYCLE;
+}
+
 // the "input" buffers from the local PE have a size/capacity of 100;
 #define BUFF_BOUND 512
 
-#define S_ELPS 0.00000001
 #define ATOM_WIDTH 64
+// max flit size in multiples of 64 bits; flit payload is stored inline;
+#define FLIT_MAX_SIZE 8
 #define ZERO 0
 #define MAX_64_ 0xffffffffffffffffLL
 #define CORR_EFF 0.8
 
 // power estimations related stuff;
 #define POWER_NOM 1e9
-// the three voltages we work with (in V);
+// default Vdd (in V) and frequency (in GHz) of the DVFS levels; they can
+// be changed with a DVFS table file (see TOPOLOGY::load_dvfs_table());
 // adopted from A. Coskun paper TCAD'2009 for a tech node of 65nm;
 #define VDD_BOOST        1.3
 #define VDD_BASE         1.2 
 #define VDD_THROTTLE_1   1.1 
 #define VDD_THROTTLE_2   1.0 
-// the three frequencies we work with (in GHz);
 #define FREQ_BOOST       2.5
 #define FREQ_BASE        2.0 
 #define FREQ_THROTTLE_1  1.8 
 #define FREQ_THROTTLE_2  1.6 
-// energy scaling factors;
-#define SCALING_BOOST      1.1736    
-#define SCALING_BASE       1.0    
-#define SCALING_THROTTLE_1 0.8403
-#define SCALING_THROTTLE_2 0.6944 
 
+// all delays are in ticks;
 // delay it takes a flit to traverse the physical link from upstream to 
 // downstream router;
-#define WIRE_DELAY_BASE 1.0 // 0.9; 
+#define WIRE_DELAY_BASE 180 // 1.0 cycles; 
 // delay of a router's pipeline stage;
-#define PIPE_DELAY_BASE 1.0 // 1.0; 
+#define PIPE_DELAY_BASE 180 // 1.0 cycles; 
 // delay it takes the credit control signal to go back to upstream router to 
 // let it know that there is room in this downstream router;
-#define CREDIT_DELAY_BASE 1.0 // 1.0; 
-// if DVFS is done and the above delays are for the BASE CASE (that is
-// 1.0 is the normalized 2.0GHz), then the boost and two throttle cases 
-// (2.5GHz, 1.8 GHz and 1.6GHz) would have these "normalized" delays;
-// the boost case:
-#define WIRE_DELAY_BOOST        0.8
-#define PIPE_DELAY_BOOST        0.8 
-#define CREDIT_DELAY_BOOST      0.8
-// 1.8GHz case:
-#define WIRE_DELAY_THROTTLE_1   1.111 
-#define PIPE_DELAY_THROTTLE_1   1.111 
-#define CREDIT_DELAY_THROTTLE_1 1.111 
-// 1.6GHz case:
-#define WIRE_DELAY_THROTTLE_2   1.25
-#define PIPE_DELAY_THROTTLE_2   1.25 
-#define CREDIT_DELAY_THROTTLE_2 1.25 
+#define CREDIT_DELAY_BASE 180 // 1.0 cycles; 
+// if DVFS is done, the three delays of the other levels are the clock
+// period of the level, i.e., PIPE_DELAY_BASE * base freq / freq of level;
+// e.g., 144 ticks (0.8 cycles) at 2.5GHz, 200 ticks (10/9 cycles) at 1.8GHz
+// and 225 ticks (1.25 cycles) at 1.6GHz (see TOPOLOGY::dvfs_clock_period());
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,8 +173,28 @@ class TOPOLOGY
         // terminology...
         long _ary_size; // k-ary; i.e., "network size" in one dimension;
         long _cube_size; // n-cube;
+        // routers along each dimension; nx and ny are _ary_size unless
+        // given; the mesh is 3D if nz is more than 1;
+        long _nx, _ny, _nz;
+        // wraparound links close each row of routers into a ring;
+        bool _torus;
         double _link_length; // physical link length in um;
-        long _pipeline_stages_per_link; // number of pipeline registers for each link?
+        long _pipeline_stages_per_link; // number of pipeline registers of each link;
+        // if not empty, routers and links are read from this file instead
+        // of building the mesh (see NETWORK);
+        string _topology_file;
+        // Vdd (V), freq. (GHz) and clock period (ticks) of each DVFS level;
+        // defaults, or read from _dvfs_table_file if not empty;
+        string _dvfs_table_file;
+        vector<double> _dvfs_vdd;
+        vector<double> _dvfs_freq;
+        vector<SIM_TIME> _dvfs_clock_periods;
+        // if not empty, the Orion power models are saved to and loaded
+        // from files of this directory (see POWER_MODEL);
+        string _power_cache_dir;
+        // technology node (nm) and transistor type of the Orion power models;
+        long _tech_node;
+        TRANSISTOR_TYPE _transistor_type;
         // virtual channel sharing? depends on the type of routing;
         // by default it is SHARED;
         VIRTUAL_CHANNEL_SHARING _vc_sharing_mode;
@@ -171,6 +216,15 @@ class TOPOLOGY
         // we count say 100 of "base" cycles and then perform prediction
         // for all routers;
         DVFS_MODE _dvfs_mode;
+        EVENT_QUEUE_TYPE _event_queue_type;
+        SIMULATION_ENGINE _simulation_engine;
+        long _threads_count; // used by the PDES and CYCLE engines;
+        ARBITER_TYPE _arbiter_type;
+        SW_ALLOCATOR_TYPE _sw_allocator_type;
+        long _islip_iterations;
+        // routers with nothing to do stop being simulated each cycle until
+        // a flit, a credit or a packet arrives;
+        bool _dormant_routers;
         
 
     public:
@@ -184,10 +238,11 @@ class TOPOLOGY
 
         // traffic related;
         TRAFFIC_TYPE traffic_type() const { return _traffic_type; }
-        vector<long> hotspots() const { return _hotspots; }
-        vector<long> non_hotspots() const { return _non_hotspots; }
+        const vector<long> &hotspots() const { return _hotspots; }
+        const vector<long> &non_hotspots() const { return _non_hotspots; }
         double hotspot_percentage() const { return _hotspot_percentage; }
         void populate_hotspot_sketch_arrays();
+        void load_dvfs_table();
 
         // prediction related;
         PREDICTOR_TYPE predictor_type() const { return _predictor_type; }
@@ -196,12 +251,45 @@ class TOPOLOGY
         long history_window() const { return _history_window; }
         long history_weight() const { return _history_weight; }
         bool do_dvfs() const { return _do_dvfs; }
+        double dvfs_vdd( DVFS_LEVEL level) const { return _dvfs_vdd[ level]; }
+        double dvfs_freq( DVFS_LEVEL level) const { return _dvfs_freq[ level]; }
+        // time between two consecutive cycles of a router at this level;
+        SIM_TIME dvfs_clock_period( DVFS_LEVEL level) const { 
+            return _dvfs_clock_periods[ level]; 
+        }
+        // shortest clock period of all levels;
+        SIM_TIME min_dvfs_clock_period() const;
         bool use_freq_boost() const { return _use_freq_boost; }
         bool use_link_pred() const { return _use_link_pred; }
         DVFS_MODE dvfs_mode() const { return _dvfs_mode; }
+        EVENT_QUEUE_TYPE event_queue_type() const { return _event_queue_type; }
+        SIMULATION_ENGINE simulation_engine() const { return _simulation_engine; }
+        // whether routers are stepped by clock domains (see CLOCK_DOMAIN);
+        // the cycle-driven engine does so with dvfs;
+        bool clock_domain_stepping() const {
+            return ( _simulation_engine == CLOCK_DOMAIN_ENGINE ||
+                ( _simulation_engine == CYCLE_DRIVEN_ENGINE && _do_dvfs));
+        }
+        long threads_count() const { return _threads_count; }
+        ARBITER_TYPE arbiter_type() const { return _arbiter_type; }
+        SW_ALLOCATOR_TYPE sw_allocator_type() const { return _sw_allocator_type; }
+        long islip_iterations() const { return _islip_iterations; }
+        bool dormant_routers() const { return _dormant_routers; }
 
         long ary_size() const { return _ary_size; }
         long cube_size() const { return _cube_size; }
+        long nx() const { return _nx; }
+        long ny() const { return _ny; }
+        long nz() const { return _nz; }
+        bool torus() const { return _torus; }
+        // routers along dimension d (0 is x, 1 is y, 2 is z);
+        long dimension_size( long d) const {
+            return ( d == 0) ? _nx : ( ( d == 1) ? _ny : _nz);
+        }
+        // of the mesh or torus (not of a topology file);
+        long routers_count() const;
+        long router_id( const ADDRESS &a) const;
+        ADDRESS router_address( long id) const;
         long virtual_channel_number() const { return _vc_number; }
         long input_buffer_size() const { return _input_buffer_size; }
         long output_buffer_size() const { return _output_buffer_size; }
@@ -209,6 +297,11 @@ class TOPOLOGY
         long flit_size() const { return _flit_size; }
         long link_bandwidth() const { return _link_bandwidth; }
         double link_length() const { return _link_length; }
+        long pipeline_stages_per_link() const { return _pipeline_stages_per_link; }
+        const string &topology_file() const { return _topology_file; }
+        const string &power_cache_dir() const { return _power_cache_dir; }
+        long tech_node() const { return _tech_node; }
+        TRANSISTOR_TYPE transistor_type() const { return _transistor_type; }
         ROUTING_ALGORITHM routing_algo() const { return _routing_algo; }
         double simulation_cycles_count() const { return _simulation_cycles_count; }
         double warmup_cycles_count() const { return _warmup_cycles_count; }
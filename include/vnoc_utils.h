@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <assert.h>
+#include <vector>
 
 
 using namespace std;
@@ -25,18 +27,60 @@ void *my_realloc(void *ptr, size_t size);
 //
 // RANDOM_NUMBER_GENERATOR
 //
+// one stream of random numbers; counter-based (Philox4x32-10): the n-th
+// block of numbers of a stream is a function of the seed, the stream id
+// and n only; so, streams are independent of each other and can be used
+// from different threads without any shared state; each router, arbiter
+// and traffic injector has its own stream (see rng_stream()); all streams
+// of a simulation share the seed of the seed: command line option;
+//
 ////////////////////////////////////////////////////////////////////////////////
 
+// kinds of streams; ids of streams of different kinds never overlap;
+enum RNG_STREAM_KIND { 
+    TOPOLOGY_RNG_STREAM, ROUTER_RNG_STREAM, ARBITER_RNG_STREAM,
+    INJECTOR_RNG_STREAM, PARETO_RNG_STREAM };
+
+inline unsigned long long rng_stream( RNG_STREAM_KIND kind, 
+    unsigned long long index) 
+{
+    return ((unsigned long long)kind << 48) + index;
+}
+
 class RANDOM_NUMBER_GENERATOR
 {
     private:
-        long _seed;
+        unsigned long long _seed;
+        unsigned long long _stream;
+        unsigned long long _counter; // blocks generated so far;
+        unsigned int _block[4];
+        long _block_used; // numbers of _block already returned;
+        // gauss01() makes two numbers at a time;
+        bool _gauss_saved;
+        double _gauss_next;
 
     private:
-        double sflat01();
+        void next_block();
+        unsigned int next_u32() {
+            if ( _block_used == 4) {
+                next_block();
+            }
+            return _block[ _block_used ++];
+        }
+        unsigned long long next_u64() {
+            unsigned long long hi = next_u32();
+            return (hi << 32) | next_u32();
+        }
+        // uniform in [0, range);
+        unsigned long long bounded( unsigned long long range) {
+            return (unsigned long long)
+                (((unsigned __int128)next_u64() * range) >> 64);
+        }
+        // uniform in [0, 1), with 53 random bits;
+        double flat01() { return (next_u64() >> 11) * (1.0 / 9007199254740992.0); }
         double gauss01();
     public:
-        RANDOM_NUMBER_GENERATOR(long seed);
+        RANDOM_NUMBER_GENERATOR(long seed, unsigned long long stream = 0);
         RANDOM_NUMBER_GENERATOR();
         ~RANDOM_NUMBER_GENERATOR() {}
 
@@ -48,11 +92,180 @@ class RANDOM_NUMBER_GENERATOR
         long gauss_mean_l( long mean, double variance);
         unsigned long gauss_mean_ul( unsigned long mean, double variance);
         unsigned long long gauss_mean_ull( unsigned long long mean, double variance);
-        void set_seed( long seed);
+        // restarts the stream from its first number;
+        void set_seed( long seed, unsigned long long stream = 0);
 
         int poisson( double this_mean);
         int pareto( double alpha);
         
 };
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// BIT_VECTOR
+//
+// fixed-size vector of bits stored in 64-bit words; used for request and
+// grant masks of the allocators; storage is allocated once at construction
+// time; scanning for set bits is done a word at a time;
+//
+////////////////////////////////////////////////////////////////////////////////
+
+class BIT_VECTOR
+{
+    private:
+        vector<unsigned long long> _words;
+        long _bits_count;
+
+    public:
+        BIT_VECTOR() : _words(), _bits_count(0) {}
+        BIT_VECTOR( long bits_count) : 
+            _words( (bits_count + 63) / 64, 0ULL), _bits_count(bits_count) {}
+        ~BIT_VECTOR() {}
+
+        long size() const { return _bits_count; }
+        long words_count() const { return _words.size(); }
+        unsigned long long word( long w) const { return _words[w]; }
+
+        void set( long k) { 
+            assert( k >= 0 && k < _bits_count);
+            _words[k >> 6] |= (1ULL << (k & 63)); 
+        }
+        void reset( long k) { 
+            assert( k >= 0 && k < _bits_count);
+            _words[k >> 6] &= ~(1ULL << (k & 63)); 
+        }
+        bool test( long k) const { 
+            assert( k >= 0 && k < _bits_count);
+            return (_words[k >> 6] >> (k & 63)) & 1ULL; 
+        }
+        void clear() {
+            for ( long w = 0; w < long(_words.size()); w++) { _words[w] = 0ULL; }
+        }
+        bool none() const {
+            for ( long w = 0; w < long(_words.size()); w++) { 
+                if ( _words[w] != 0ULL) return false; 
+            }
+            return true;
+        }
+        // both vectors must have the same size;
+        bool intersects( const BIT_VECTOR &other) const {
+            for ( long w = 0; w < long(_words.size()); w++) { 
+                if ( (_words[w] & other._words[w]) != 0ULL) return true; 
+            }
+            return false;
+        }
+        void and_not( const BIT_VECTOR &other) {
+            for ( long w = 0; w < long(_words.size()); w++) { 
+                _words[w] &= ~other._words[w];
+            }
+        }
+        long count() const {
+            long n = 0;
+            for ( long w = 0; w < long(_words.size()); w++) { 
+                n += __builtin_popcountll( _words[w]); 
+            }
+            return n;
+        }
+        // index of first set bit at position >= k; -1 if none;
+        long find_from( long k) const {
+            long w = k >> 6;
+            if ( w >= long(_words.size())) return -1;
+            unsigned long long word_t = _words[w] & (~0ULL << (k & 63));
+            while ( word_t == 0ULL) {
+                w ++;
+                if ( w == long(_words.size())) return -1;
+                word_t = _words[w];
+            }
+            return (w << 6) + __builtin_ctzll( word_t);
+        }
+        long find_first() const { return find_from( 0); }
+        long find_next( long k) const { return find_from( k + 1); }
+        // index of the n-th (counting from 0) set bit; -1 if none;
+        long find_nth( long n) const {
+            for ( long w = 0; w < long(_words.size()); w++) {
+                long c = __builtin_popcountll( _words[w]);
+                if ( n < c) {
+                    unsigned long long word_t = _words[w];
+                    for ( ; n > 0; n--) { word_t &= word_t - 1; } // drop lowest;
+                    return (w << 6) + __builtin_ctzll( word_t);
+                }
+                n -= c;
+            }
+            return -1;
+        }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// RING_QUEUE
+//
+// FIFO queue stored as a circular buffer; push_back and pop_front are O(1)
+// and do not move the other items; storage is allocated once, at 
+// construction time, with the given capacity; if more items than that are
+// pushed, storage is doubled (needed only for the PE injection queues, 
+// which are not bounded by credits);
+//
+////////////////////////////////////////////////////////////////////////////////
+
+template<class T> class RING_QUEUE
+{
+    private:
+        vector<T> _items; // its size is the capacity of the queue;
+        long _head; // index of the front item;
+        long _size; // number of items in queue;
+
+    public:
+        RING_QUEUE() : _items(), _head(0), _size(0) {}
+        RING_QUEUE( long capacity) : _items(capacity), _head(0), _size(0) {}
+        ~RING_QUEUE() {}
+
+        long size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        long capacity() const { return _items.size(); }
+        // k-th item counted from the front;
+        T &operator[]( long k) { 
+            assert( k >= 0 && k < _size);
+            return _items[ index_of(k)]; 
+        }
+        const T &operator[]( long k) const { 
+            assert( k >= 0 && k < _size);
+            return _items[ index_of(k)]; 
+        }
+        T &front() { return (*this)[0]; }
+        const T &front() const { return (*this)[0]; }
+        void push_back( const T &item) {
+            if ( _size == long(_items.size())) {
+                grow();
+            }
+            _items[ index_of(_size)] = item;
+            _size ++;
+        }
+        void pop_front() {
+            assert( _size > 0);
+            _head ++;
+            if ( _head == long(_items.size())) {
+                _head = 0;
+            }
+            _size --;
+        }
+        void clear() { _head = 0; _size = 0; }
+
+    private:
+        long index_of( long k) const {
+            long index = _head + k;
+            if ( index >= long(_items.size())) {
+                index -= _items.size();
+            }
+            return index;
+        }
+        void grow() {
+            vector<T> items( _items.size() > 0 ? 2 * _items.size() : 1);
+            for ( long k = 0; k < _size; k++) {
+                items[k] = _items[ index_of(k)];
+            }
+            _items.swap( items);
+            _head = 0;
+        }
+};
+
 #endif
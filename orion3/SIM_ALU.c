@@ -61,10 +61,6 @@ static u_int plx_tc[PLX_BLK][PLX_GATE] =
 	  /* WHS: ignore for fair comparison */
 	  //0,  0,  0,  0,  0,  0,  0,  8,  0,  0, 16,  0 };
 
-/* capacitance table of PLX ALU */
-static double plx_c[PLX_GATE];
-
-
 static double c_NOT(void)
 {
 	return (SIM_draincap(WaluNOTp, PCH, 1) + SIM_draincap(WaluNOTn, NCH, 1) +
@@ -119,6 +115,8 @@ static double c_PASS(void)
 
 int SIM_ALU_init(SIM_ALU_t *alu, int model, u_int data_width)
 {
+	/* capacitance table of PLX ALU; of the technology being used */
+	double plx_c[PLX_GATE];
 	u_int i, j;
 
 	switch (alu->model = model) {
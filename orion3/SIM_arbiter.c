@@ -295,6 +295,35 @@ int SIM_arbiter_record(SIM_arbiter_t *arb, LIB_Type_max_uint new_req, LIB_Type_m
 	return 0;
 }
 
+/* same as n_record calls of SIM_arbiter_record whose requests toggle
+ * n_chg_req bits and whose grants change n_chg_grant times in total */
+int SIM_arbiter_record_batch(SIM_arbiter_t *arb, LIB_Type_max_uint n_record, LIB_Type_max_uint n_chg_req, LIB_Type_max_uint n_chg_grant)
+{
+	switch (arb->model) {
+		case MATRIX_ARBITER:
+			arb->n_chg_req += n_chg_req;
+			arb->n_chg_grant += n_chg_grant;
+			arb->n_chg_mint += (LIB_Type_max_uint)((arb->req_width - 1) * arb->req_width / 2) * n_record;
+			arb->pri_ff.n_switch += (LIB_Type_max_uint)((arb->req_width - 1) / 2) * n_record;
+			break;
+
+		case RR_ARBITER:
+			arb->n_chg_req += n_chg_req;
+			arb->n_chg_grant += n_chg_grant;
+			arb->n_chg_carry += (LIB_Type_max_uint)(arb->req_width / 2) * n_record;
+			arb->n_chg_carry_in += (LIB_Type_max_uint)(arb->req_width / 2 - 1) * n_record;
+			arb->pri_ff.n_switch += 2 * n_record;
+			break;
+
+		case QUEUE_ARBITER:
+			break;
+
+		default: printf ("error\n");	/* some error handler */
+	}
+
+	return 0;
+}
+
 double SIM_arbiter_report(SIM_arbiter_t *arb)
 {
 	switch (arb->model) {
@@ -67,6 +67,8 @@ int SIM_arbiter_init(SIM_arbiter_t *arb, int arbiter_model, int ff_model, u_int
 
 int SIM_arbiter_record(SIM_arbiter_t *arb, LIB_Type_max_uint new_req, LIB_Type_max_uint old_req, u_int new_grant, u_int old_grant);
 
+int SIM_arbiter_record_batch(SIM_arbiter_t *arb, LIB_Type_max_uint n_record, LIB_Type_max_uint n_chg_req, LIB_Type_max_uint n_chg_grant);
+
 double SIM_arbiter_report(SIM_arbiter_t *arb);
     
 double SIM_arbiter_stat_energy(SIM_arbiter_t *arb, SIM_array_info_t *info, double n_req, int print_depth, char *path, int max_avg);
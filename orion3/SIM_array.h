@@ -212,6 +212,9 @@ typedef struct {
 extern int SIM_array_dec(SIM_array_info_t *info, SIM_array_t *arr, SIM_array_port_state_t *port, LIB_Type_max_uint row_addr, int rw );
 extern int SIM_array_data_read(SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint data );
 extern int SIM_array_data_write(SIM_array_info_t *info, SIM_array_t *arr, SIM_array_set_state_t *set, u_int n_item, u_char *data_line, u_char *old_data, u_char *new_data );
+extern int SIM_array_dec_batch(SIM_array_info_t *info, SIM_array_t *arr, int rw, LIB_Type_max_uint n_access );
+extern int SIM_array_data_read_batch(SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint n_read, LIB_Type_max_uint n_ones );
+extern int SIM_array_data_write_batch(SIM_array_info_t *info, SIM_array_t *arr, u_int n_item, LIB_Type_max_uint n_write, LIB_Type_max_uint n_toggles );
 extern int SIM_array_tag_read(SIM_array_info_t *info, SIM_array_t *arr, SIM_array_set_state_t *set );
 extern int SIM_array_tag_update(SIM_array_info_t *info, SIM_array_t *arr, SIM_array_port_state_t *port, SIM_array_set_state_t *set );
 extern int SIM_array_tag_compare(SIM_array_info_t *info, SIM_array_t *arr, SIM_array_port_state_t *port, LIB_Type_max_uint tag_input, LIB_Type_max_uint col_addr, SIM_array_set_state_t *set );
@@ -158,11 +158,9 @@ int SIM_array_data_write(
     // because when, below, we do data_line[i] = new_data[i], that will effectively
     // overwrite old_data ('coz the way SIM_array_data_write is called) and no
     // switching will be recorded...
-    /* record memory cell stats */
-    for ( i = 0; i < n_item; i ++ ) {
-        //printf(" (%d)==============> %d %d ", i, old_data[i], new_data[i]);
-        SIM_array_mem_record( &arr->data_mem, old_data[i], new_data[i], 8 );
-    }
+    /* record memory cell stats; same as SIM_array_mem_record of each
+     * item (byte), but 8 items at a time */
+    arr->data_mem.n_switch += SIM_Hamming_bytes( old_data, new_data, n_item );
             
     /* record bitline stats */
     if ( IS_FULLY_ASSOC( info )) {
@@ -214,6 +212,81 @@ int SIM_array_data_write(
 }
 
 
+/* ==================== batched recording ==================== */
+/* the same counter updates as many calls of the functions above, for
+ * callers that count activity themselves and record it only when energy
+ * is needed; for non-fully-associative arrays without row decoder only
+ * (e.g., FIFO buffers) */
+
+/* same as n_access calls of SIM_array_dec */
+int SIM_array_dec_batch( SIM_array_info_t *info, SIM_array_t *arr, int rw, LIB_Type_max_uint n_access )
+{
+	if ( ! IS_FULLY_ASSOC( info ) && ! info->row_dec_model ) {
+		SIM_array_wordline_record( &arr->data_wordline, rw, info->data_ndwl * n_access );
+		if ( HAVE_TAG( info ))
+			SIM_array_wordline_record( &arr->tag_wordline, rw, info->tag_ndwl * n_access );
+
+		return 0;
+	}
+	else
+		return -1;
+}
+
+
+/* same as n_read calls of SIM_array_data_read whose data have n_ones 1 bits
+ * in total among their low info->eff_data_cols bits */
+int SIM_array_data_read_batch( SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint n_read, LIB_Type_max_uint n_ones )
+{
+    if (info->data_end == 1) {
+        if ( arr->data_bitline.end == 2 )
+            arr->data_bitline.n_col_read += info->eff_data_cols * n_read;
+        else    /* single-ended bitline; see SIM_array_bitline_record */
+            arr->data_bitline.n_col_read += n_ones;
+        return 0;
+    }
+    else if ( ! IS_FULLY_ASSOC( info )) {
+        /* data is 0 here, so single-ended bitlines do not switch */
+        if ( arr->data_bitline.end == 2 )
+            arr->data_bitline.n_col_read += info->eff_data_cols * n_read;
+        arr->data_amp.n_access += info->eff_data_cols * n_read;
+        return 0;
+    }
+    else
+        return -1;
+}
+
+
+/* same as n_write calls of SIM_array_data_write whose data_line is their
+ * old_data and whose n_item bytes toggle n_toggles bits in total */
+int SIM_array_data_write_batch( SIM_array_info_t *info, SIM_array_t *arr, u_int n_item, LIB_Type_max_uint n_write, LIB_Type_max_uint n_toggles )
+{
+    /* record memory cell stats */
+    arr->data_mem.n_switch += n_toggles;
+
+    /* record bitline stats */
+    if ( IS_FULLY_ASSOC( info ))
+        return -1;
+
+    else if (info->share_rw) {
+        /* old and new values are 0, so only shared bitlines switch */
+        if ( arr->data_bitline.share_rw ) {
+            arr->data_bitline.n_col_write += info->eff_data_cols * n_write;
+            if ( IS_DIRECT_MAP( info ) && info->data_ndbl > 1 )
+                arr->data_bitline.n_col_write += n_item * 8 * ( info->data_ndbl - 1 ) * n_write;
+        }
+    }
+
+    else {  /* separate R/W bitlines */
+        if ( arr->data_bitline.share_rw )
+            arr->data_bitline.n_col_write += n_item * 8 * n_write;
+        else
+            arr->data_bitline.n_col_write += n_toggles;
+    }
+
+    return 0;
+}
+
+
 /* record read tag activity (including bitline and sense amplifier) */
 /* only used by non-RF array */
 /* set only used by fully-associative array */
@@ -43,7 +43,6 @@
 #include "SIM_util.h"
 #include "SIM_link.h"
 
-#if ( PARM(TECH_POINT) <= 90 )
 double SIM_total_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router)
 {
     double sram_buffer_clockcap = 0;
@@ -106,7 +105,7 @@ double SIM_total_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router
        the functions, internally, use meters. */
 
     if(info->H_tree_clock){
-        if ((PARM(TRANSISTOR_TYPE) == HVT) || (PARM(TRANSISTOR_TYPE) == NVT)) {
+        if ((SIM_TRANSISTOR_TYPE == HVT) || (SIM_TRANSISTOR_TYPE == NVT)) {
             H_tree_clockcap = (4+4+2+2) * (info->router_diagonal * 1e-6) * (Clockwire);
             H_tree_resistance = (4+4+2+2) * (info->router_diagonal * 1e-6) * (Reswire);
 
@@ -120,7 +119,7 @@ double SIM_total_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router
             pmosLeakage = BufferPMOSOffCurrent * h * k * 15;
             nmosLeakage = BufferNMOSOffCurrent * h * k * 15;
         }
-        else if(PARM(TRANSISTOR_TYPE) == LVT) {
+        else if(SIM_TRANSISTOR_TYPE == LVT) {
             H_tree_clockcap = (8+4+4+4+4) * (info->router_diagonal * 1e-6)  * (Clockwire);
             H_tree_resistance = (8+4+4+4+4) * (info->router_diagonal * 1e-6) * (Reswire);
 
@@ -171,29 +170,13 @@ void SIM_simulation_cycles_record(SIM_router_info_t *info)
 {
     info->n_simulation_cycles = info->n_simulation_cycles + 1;
 }
-double fpfp_clock_cap() 
-{
-    return ClockCap;
-}
-
-#else
-/*=================clock power is not supported for 110nm and above=================*/
-double SIM_total_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router)
-{
-    return 0;
-}
-double SIM_total_during_n_cycles_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router)
+void SIM_simulation_cycles_record_batch(SIM_router_info_t *info, u_int n_cycles)
 {
-    return 0.0;
+    info->n_simulation_cycles = info->n_simulation_cycles + n_cycles;
 }
-void SIM_simulation_cycles_record(SIM_router_info_t *info)
-{
-    // do nothing;
-}
-double fpfp_clock_cap()
+double fpfp_clock_cap() 
 {
-    return 0;
+    return ClockCap;
 }
 
-#endif
 
@@ -40,6 +40,7 @@
 double SIM_total_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router);
 double SIM_total_during_n_cycles_clockEnergy(SIM_router_info_t *info, SIM_router_power_t *router);
 void SIM_simulation_cycles_record(SIM_router_info_t *info);
+void SIM_simulation_cycles_record_batch(SIM_router_info_t *info, u_int n_cycles);
 double fpfp_clock_cap();
 
 #endif
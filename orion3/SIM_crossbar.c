@@ -393,6 +393,34 @@ int SIM_crossbar_record(SIM_crossbar_t *xb, int io,
 }
 
 
+/* same as SIM_crossbar_record calls whose data toggle n_chg_in bits in
+ * total at input ports and n_chg_out at output ports, and whose ports
+ * change n_chg_ctr times */
+int SIM_crossbar_record_batch(SIM_crossbar_t *xb, LIB_Type_max_uint n_chg_in, 
+    LIB_Type_max_uint n_chg_out, LIB_Type_max_uint n_chg_ctr)
+{
+    switch (xb->model) {
+        case MATRIX_CROSSBAR:
+            xb->n_chg_in += n_chg_in;
+            xb->n_chg_out += n_chg_out;
+            xb->n_chg_ctr += n_chg_ctr;
+            break;
+
+        case CUT_THRU_CROSSBAR:
+            xb->n_chg_in += n_chg_in;
+            xb->n_chg_ctr += n_chg_ctr;
+            break;
+
+        case MULTREE_CROSSBAR:
+            break;
+
+        default: printf ("error crossbar_record\n");    /* some error handler */
+    }
+
+    return 0;
+}
+
+
 double SIM_crossbar_report(SIM_crossbar_t *crsbar)
 {
     return (crsbar->n_chg_in * crsbar->e_chg_in + crsbar->n_chg_out * crsbar->e_chg_out +
@@ -39,7 +39,6 @@
 #include "SIM_link.h"
 
 /* Link power and area model is only supported for 90nm, 65nm, 45nm and 32nm */
-#if ( PARM(TECH_POINT) <= 90 )
 
 // The following function computes the wire resistance considering
 // width-spacing combination and a width-dependent resistivity model
@@ -252,14 +251,13 @@ double LinkArea(double Length, unsigned NumBits)
     int *ptr_k = &k;
     double *ptr_h = &h;
     getOptBuffering(ptr_k, ptr_h, Length);
-    #if(PARM(TECH_POINT) == 90)
+    if (SIM_TECH_POINT == 90) {
     	deviceArea = NumBits * k * ((h * 0.43) + 1.38);
-    #elif(PARM(TECH_POINT) <= 65)
+    } else {
         deviceArea = (NumBits) * k * ((h * 0.45) + 0.65) * SCALE_T;
-    #endif
+    }
 
     routingArea = (NumBits * (WireMinWidth*1e6 + WireMinSpacing*1e6) + WireMinSpacing*1e6) * Length*1e6; 
     return deviceArea + routingArea;
 }
 
-#endif /*( PARM(TECH_POINT) <= 90 */
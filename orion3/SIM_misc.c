@@ -385,6 +385,14 @@ int SIM_bus_record(SIM_bus_t *bus, LIB_Type_max_uint old_state, LIB_Type_max_uin
 }
 
 
+/* same as SIM_bus_record calls that switch n_switch bits in total */
+int SIM_bus_record_batch(SIM_bus_t *bus, LIB_Type_max_uint n_switch)
+{
+    bus->n_switch += n_switch;
+    return 0;
+}
+
+
 double SIM_bus_report(SIM_bus_t *bus)
 {
     //printf(" bus n_switch: %d bus e_switch: %g \n", bus->n_switch, bus->e_switch);
@@ -84,6 +84,7 @@ typedef struct {
 /* bus model interface */
 extern int SIM_bus_init(SIM_bus_t *bus, int model, int encoding, u_int width, u_int grp_width, u_int n_snd, u_int n_rcv, double length, double time);
 extern int SIM_bus_record(SIM_bus_t *bus, LIB_Type_max_uint old_state, LIB_Type_max_uint new_state);
+extern int SIM_bus_record_batch(SIM_bus_t *bus, LIB_Type_max_uint n_switch);
 extern double SIM_bus_report(SIM_bus_t *bus);
 extern LIB_Type_max_uint SIM_bus_state(SIM_bus_t *bus, LIB_Type_max_uint old_data, LIB_Type_max_uint old_state, LIB_Type_max_uint new_data);
 
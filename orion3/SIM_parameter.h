@@ -94,11 +94,16 @@
 #include "SIM_port.h"
 /*End user-defined router with selected tech node and operating freq and Vdd */
 
+/* Vdd and Freq of the models being initialized are SIM_Vdd and SIM_Freq
+ * of the context of the calling thread (see SIM_technology_runtime.h);
+ * they are PARM(Vdd) and PARM(Freq) unless set by SIM_set_operating_point()
+ * (see SIM_util.c), e.g., to initialize models for each DVFS level */
+
 /* Useful macros related to parameters defined by users */
-#define Vdd             (PARM(Vdd))
-#define Period          ((double)1/(double)PARM(Freq))
+#define Vdd             (SIM_Vdd)
+#define Period          ((double)1/(double)SIM_Freq)
 
-#define Powerfactor		((PARM(Freq))*Vdd*Vdd)
+#define Powerfactor		((SIM_Freq)*Vdd*Vdd)
 #define EnergyFactor	(Vdd*Vdd)
 /* End useful macros related to parameters defined by users */
 
@@ -106,4 +111,8 @@
 #include "SIM_technology.h"
 /* End technology file */
 
+/* Technology node chosen at run time */
+#include "SIM_technology_runtime.h"
+/* End technology node chosen at run time */
+
 #endif /* _SIM_PARAMETER_H */
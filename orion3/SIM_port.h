@@ -8,8 +8,13 @@
 #ifndef _SIM_PORT_H
 #define _SIM_PORT_H
 /*Technology related parameters */
+/* defaults of SIM_set_technology(); 90, 65, 45 or 32 */
+#ifndef PARM_TECH_POINT
 #define PARM_TECH_POINT       65
+#endif
+#ifndef PARM_TRANSISTOR_TYPE
 #define PARM_TRANSISTOR_TYPE  LVT // NVT // transistor type, HVT, NVT, or LVT
+#endif
 #define PARM_Vdd              1.2 // 1.0
 #define PARM_Freq             2.0e9 // 0.746e9
 #define PARM_VDD_V            PARM_Vdd
@@ -38,33 +38,67 @@
 #include "SIM_router.h"
 #include "SIM_util.h"
 
-/* global variables */
-GLOBDEF(SIM_router_power_t, SIM_router_power);
-GLOBDEF(SIM_router_info_t, SIM_router_info);
-GLOBDEF(SIM_router_area_t, SIM_router_area);
-
 int SIM_router_init(SIM_router_info_t *info, 
     SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area)
+{
+	SIM_router_parm_t parm;
+
+	SIM_router_parm_default(&parm);
+	return SIM_router_init_with_parm(info, SIM_router_power, SIM_router_area, &parm);
+}
+
+/* same as SIM_router_init, but with the number of input and output ports
+ * given by the caller instead of PARM(in_port) and PARM(out_port); so,
+ * routers with different numbers of ports can be modeled in one run */
+int SIM_router_init_with_ports(SIM_router_info_t *info, 
+    SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area,
+    u_int n_in, u_int n_out)
+{
+	SIM_router_parm_t parm;
+
+	SIM_router_parm_default(&parm);
+	parm.n_in = n_in;
+	parm.n_out = n_out;
+	return SIM_router_init_with_parm(info, SIM_router_power, SIM_router_area, &parm);
+}
+
+/* the parameters of SIM_router_parm_t as in SIM_port.h */
+void SIM_router_parm_default(SIM_router_parm_t *parm)
+{
+	parm->n_in = PARM(in_port);
+	parm->n_out = PARM(out_port);
+	parm->n_v_channel = PARM(v_channel);
+	parm->in_buf_set = PARM(in_buf_set);
+	parm->out_buf_set = PARM(out_buf_set);
+}
+
+/* same as SIM_router_init, but with the parameters of parm instead of
+ * those of SIM_port.h; so, e.g., the number of virtual channels and the
+ * buffer depths of the simulator can be modeled without a recompile */
+int SIM_router_init_with_parm(SIM_router_info_t *info, 
+    SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area,
+    const SIM_router_parm_t *parm)
 {
 	u_int line_width;
 	int share_buf, outdrv;
+	u_int n_in = parm->n_in, n_out = parm->n_out;
 
 	/* PHASE 1: set parameters */
 	/* general parameters */
-	info->n_in = PARM(in_port);
+	info->n_in = n_in;
 	info->n_cache_in = PARM(cache_in_port);
 	info->n_mc_in = PARM(mc_in_port);
 	info->n_io_in = PARM(io_in_port);
-	info->n_total_in = PARM(in_port) + PARM(cache_in_port) + PARM(mc_in_port) + PARM(io_in_port);
-	info->n_out = PARM(out_port);
+	info->n_total_in = n_in + PARM(cache_in_port) + PARM(mc_in_port) + PARM(io_in_port);
+	info->n_out = n_out;
 	info->n_cache_out = PARM(cache_out_port);
 	info->n_mc_out = PARM(mc_out_port);
 	info->n_io_out = PARM(io_out_port);
-	info->n_total_out = PARM(out_port) + PARM(cache_out_port) + PARM(mc_out_port) + PARM(io_out_port);
+	info->n_total_out = n_out + PARM(cache_out_port) + PARM(mc_out_port) + PARM(io_out_port);
 	info->flit_width = PARM(flit_width);
 
 	/* virtual channel parameters */
-	info->n_v_channel = MAX(PARM(v_channel), 1);
+	info->n_v_channel = MAX(parm->n_v_channel, 1);
 	info->n_v_class = MAX(PARM(v_class), 1); 
 	info->cache_class = MAX(PARM(cache_class), 1);
 	info->mc_class = MAX(PARM(mc_class), 1);
@@ -103,7 +137,7 @@ int SIM_router_init(SIM_router_info_t *info,
 	info->in_buffer_model = PARM(in_buffer_type);
 	if(info->in_buf){
 		outdrv = !info->in_share_buf && info->in_share_switch;
-		SIM_array_init(&info->in_buf_info, 1, PARM(in_buf_rport), 1, PARM(in_buf_set), PARM(flit_width), outdrv, info->in_buffer_model);
+		SIM_array_init(&info->in_buf_info, 1, PARM(in_buf_rport), 1, parm->in_buf_set, PARM(flit_width), outdrv, info->in_buffer_model);
 	}
 
     if (PARM(cache_in_port)){
@@ -156,7 +190,7 @@ int SIM_router_init(SIM_router_info_t *info,
 	info->out_buffer_model = PARM(out_buffer_type);
 	if (info->out_buf){
 		/* output buffer has no tri-state buffer anyway */
-		SIM_array_init(&info->out_buf_info, 1, 1, PARM(out_buf_wport), PARM(out_buf_set), PARM(flit_width), 0, info->out_buffer_model);
+		SIM_array_init(&info->out_buf_info, 1, 1, PARM(out_buf_wport), parm->out_buf_set, PARM(flit_width), 0, info->out_buffer_model);
 	}
 
 	/* central buffer */
@@ -388,6 +422,48 @@ int SIM_buf_power_data_write(SIM_array_info_t *info, SIM_array_t *arr,
     return 0;
 }
 
+
+/* ==================== buffer (batched recording) ==================== */
+
+/* bits of the read data that SIM_buf_power_data_read looks at */
+LIB_Type_max_uint SIM_buf_power_data_read_mask(SIM_array_info_t *info)
+{
+	return HAMM_MASK(info->eff_data_cols);
+}
+
+
+/* same as n_read calls of SIM_buf_power_data_read whose data have n_ones
+ * 1 bits in total among the bits of SIM_buf_power_data_read_mask */
+int SIM_buf_power_data_read_batch(SIM_array_info_t *info, SIM_array_t *arr, 
+    LIB_Type_max_uint n_read, LIB_Type_max_uint n_ones)
+{
+	SIM_array_pre_record(&arr->data_bitline_pre, info->blk_bits * n_read);
+	SIM_array_dec_batch(info, arr, SIM_ARRAY_READ, n_read);
+	SIM_array_data_read_batch(info, arr, n_read, n_ones);
+
+	return 0;
+}
+
+
+/* bits of the written data that SIM_buf_power_data_write looks at */
+LIB_Type_max_uint SIM_buf_power_data_write_mask(void)
+{
+	return HAMM_MASK(N_ITEM * 8);
+}
+
+
+/* same as n_write calls of SIM_buf_power_data_write, with data_line same
+ * as old_data, that toggle n_toggles bits in total among the bits of 
+ * SIM_buf_power_data_write_mask */
+int SIM_buf_power_data_write_batch(SIM_array_info_t *info, SIM_array_t *arr, 
+    LIB_Type_max_uint n_write, LIB_Type_max_uint n_toggles)
+{
+	SIM_array_dec_batch(info, arr, SIM_ARRAY_WRITE, n_write);
+	SIM_array_data_write_batch(info, arr, N_ITEM, n_write, n_toggles);
+
+	return 0;
+}
+
 /* WHS: missing data output wrapper function */
 
 /* ==================== buffer (wrapper functions) ==================== */
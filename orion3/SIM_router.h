@@ -166,16 +166,27 @@ typedef struct {
 } SIM_router_info_t;
 
 
-/* global variables */
-extern GLOBDEF(SIM_router_power_t, SIM_router_power);
-extern GLOBDEF(SIM_router_info_t, SIM_router_info);
-extern GLOBDEF(SIM_router_area_t, SIM_router_area);
-
+/* router parameters that can be given at run time; the others are the
+ * PARM(...) of SIM_port.h */
+typedef struct {
+	u_int n_in;		/* PARM(in_port) */
+	u_int n_out;		/* PARM(out_port) */
+	u_int n_v_channel;	/* PARM(v_channel) */
+	u_int in_buf_set;	/* PARM(in_buf_set) */
+	u_int out_buf_set;	/* PARM(out_buf_set) */
+} SIM_router_parm_t;
 
 extern int SIM_router_init(SIM_router_info_t *info, SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area);
+extern int SIM_router_init_with_ports(SIM_router_info_t *info, SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area, u_int n_in, u_int n_out);
+extern void SIM_router_parm_default(SIM_router_parm_t *parm);
+extern int SIM_router_init_with_parm(SIM_router_info_t *info, SIM_router_power_t *SIM_router_power, SIM_router_area_t *SIM_router_area, const SIM_router_parm_t *parm);
 
 extern int SIM_buf_power_data_read(SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint data);
 extern int SIM_buf_power_data_write(SIM_array_info_t *info, SIM_array_t *arr, u_char *data_line, u_char *old_data, u_char *new_data);
+extern LIB_Type_max_uint SIM_buf_power_data_read_mask(SIM_array_info_t *info);
+extern int SIM_buf_power_data_read_batch(SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint n_read, LIB_Type_max_uint n_ones);
+extern LIB_Type_max_uint SIM_buf_power_data_write_mask(void);
+extern int SIM_buf_power_data_write_batch(SIM_array_info_t *info, SIM_array_t *arr, LIB_Type_max_uint n_write, LIB_Type_max_uint n_toggles);
 
 extern int SIM_router_power_init(SIM_router_info_t *info, SIM_router_power_t *router);
 extern int SIM_router_power_report(SIM_router_info_t *info, SIM_router_power_t *router);
@@ -185,6 +196,7 @@ extern int SIM_router_area_init(SIM_router_info_t *info, SIM_router_area_t *SIM_
 extern double SIM_router_area(SIM_router_area_t *SIM_router_area);
 
 extern int SIM_crossbar_record(SIM_crossbar_t *xb, int io, LIB_Type_max_uint new_data, LIB_Type_max_uint old_data, u_int new_port, u_int old_port);
+extern int SIM_crossbar_record_batch(SIM_crossbar_t *xb, LIB_Type_max_uint n_chg_in, LIB_Type_max_uint n_chg_out, LIB_Type_max_uint n_chg_ctr);
 extern int SIM_arbiter_record(SIM_arbiter_t *arb, LIB_Type_max_uint new_req, LIB_Type_max_uint old_req, u_int new_grant, u_int old_grant);
 
 
@@ -290,12 +290,8 @@ double SIM_router_area(SIM_router_area_t *router_area)
 	double Atotal;
 	Atotal = router_area->buffer + router_area->crossbar + router_area->vc_allocator + router_area->sw_allocator;
 
-#if( PARM(TECH_POINT) <= 90 )
 	fprintf(stdout, "Abuffer:%g\t ACrossbar:%g\t AVCAllocator:%g\t ASWAllocator:%g\t Atotal:%g\n", router_area->buffer, router_area->crossbar, router_area->vc_allocator, router_area->sw_allocator,  Atotal);	
 
-#else
-    fprintf(stderr, "Router area is only supported for 90nm, 65nm, 45nm and 32nm\n");
-#endif
 	return Atotal;
 }
 
@@ -435,7 +435,7 @@ double SIM_router_stat_energy(SIM_router_info_t *info, SIM_router_power_t *route
     }
 
     /*router clock power (supported for 90nm and below) */
-    if (PARM(TECH_POINT) <= 90) {
+    if (SIM_TECH_POINT <= 90) {
         //energy_prev = Eavg; // cris
         Eavg += SIM_total_clockEnergy(info, router);
         //printf("\n Eavg: %g", Eavg - energy_prev); // cris
@@ -36,9 +36,10 @@
 
 #include "SIM_parameter.h"
 
-extern double NMOS_TAB[1];
-extern double PMOS_TAB[1];
-extern double NAND2_TAB[4];
-extern double NOR2_TAB[4];
-extern double DFF_TAB[1];
+/* leakage currents of the technology node of SIM_tech */
+#define NMOS_TAB	(SIM_tech->tech_NMOS_TAB)
+#define PMOS_TAB	(SIM_tech->tech_PMOS_TAB)
+#define NAND2_TAB	(SIM_tech->tech_NAND2_TAB)
+#define NOR2_TAB	(SIM_tech->tech_NOR2_TAB)
+#define DFF_TAB		(SIM_tech->tech_DFF_TAB)
 #endif	/* _SIM_POWER_STATIC_H */
@@ -0,0 +1,186 @@
+/* Technology parameters that differ between the technology nodes (90nm,
+ * 65nm, 45nm and 32nm) and transistor types (LVT, NVT and HVT), i.e., the
+ * macros of SIM_technology.h, SIM_technology_v2_NEW.h and
+ * technology_area_power.h that are defined under #if PARM(TECH_POINT) or
+ * PARM(TRANSISTOR_TYPE); one SIM_TECH_FIELD(name) per macro. The values
+ * of each node and type are kept in a SIM_technology_t (see
+ * SIM_technology_table.c), so that the node is chosen at run time with
+ * SIM_set_technology(). A macro of those files that is made to depend on
+ * the node must be added here and to SIM_technology_runtime.h. */
+
+/* SIM_technology.h */
+SIM_TECH_FIELD(PARM_Cgatepass)
+SIM_TECH_FIELD(PARM_Cpdiffarea)
+SIM_TECH_FIELD(PARM_Cpdiffside)
+SIM_TECH_FIELD(PARM_Cndiffside)
+SIM_TECH_FIELD(PARM_Cndiffarea)
+SIM_TECH_FIELD(PARM_Cnoverlap)
+SIM_TECH_FIELD(PARM_Cgate)
+SIM_TECH_FIELD(PARM_Cpdiffovlp)
+SIM_TECH_FIELD(PARM_Cndiffovlp)
+SIM_TECH_FIELD(PARM_Cnoxideovlp)
+SIM_TECH_FIELD(PARM_Cpoxideovlp)
+
+/* SIM_technology_v2_NEW.h */
+SIM_TECH_FIELD(SCALE_T)
+SIM_TECH_FIELD(SCALE_M)
+SIM_TECH_FIELD(SCALE_S)
+SIM_TECH_FIELD(SCALE_W)
+SIM_TECH_FIELD(SCALE_H)
+SIM_TECH_FIELD(SCALE_BW)
+SIM_TECH_FIELD(SCALE_Crs)
+SIM_TECH_FIELD(LSCALE)
+SIM_TECH_FIELD(BitWidth)
+SIM_TECH_FIELD(BitHeight)
+SIM_TECH_FIELD(Cout)
+SIM_TECH_FIELD(BitlineSpacing)
+SIM_TECH_FIELD(WordlineSpacing)
+SIM_TECH_FIELD(RegCellHeight)
+SIM_TECH_FIELD(RegCellWidth)
+SIM_TECH_FIELD(Cwordmetal)
+SIM_TECH_FIELD(Cbitmetal)
+SIM_TECH_FIELD(CCmetal)
+SIM_TECH_FIELD(CCM2metal)
+SIM_TECH_FIELD(CCM3metal)
+SIM_TECH_FIELD(CC2metal)
+SIM_TECH_FIELD(CC2M2metal)
+SIM_TECH_FIELD(CC2M3metal)
+SIM_TECH_FIELD(CC3metal)
+SIM_TECH_FIELD(CC3M2metal)
+SIM_TECH_FIELD(CC3M3metal)
+SIM_TECH_FIELD(Clockwire)
+SIM_TECH_FIELD(Reswire)
+SIM_TECH_FIELD(invCap)
+SIM_TECH_FIELD(Resout)
+SIM_TECH_FIELD(Leff)
+SIM_TECH_FIELD(Cpolywire)
+SIM_TECH_FIELD(Rnchannelstatic)
+SIM_TECH_FIELD(Rpchannelstatic)
+SIM_TECH_FIELD(Rnchannelon)
+SIM_TECH_FIELD(Rpchannelon)
+SIM_TECH_FIELD(Rbitmetal)
+SIM_TECH_FIELD(Rwordmetal)
+SIM_TECH_FIELD(Vt)
+SIM_TECH_FIELD(Wdecdrivep)
+SIM_TECH_FIELD(Wdecdriven)
+SIM_TECH_FIELD(Wdec3to8n)
+SIM_TECH_FIELD(Wdec3to8p)
+SIM_TECH_FIELD(WdecNORn)
+SIM_TECH_FIELD(WdecNORp)
+SIM_TECH_FIELD(Wdecinvn)
+SIM_TECH_FIELD(Wdecinvp)
+SIM_TECH_FIELD(Wdff)
+SIM_TECH_FIELD(Wworddrivemax)
+SIM_TECH_FIELD(Wmemcella)
+SIM_TECH_FIELD(Wmemcellr)
+SIM_TECH_FIELD(Wmemcellw)
+SIM_TECH_FIELD(Wmemcellbscale)
+SIM_TECH_FIELD(Wbitpreequ)
+SIM_TECH_FIELD(Wbitmuxn)
+SIM_TECH_FIELD(WsenseQ1to4)
+SIM_TECH_FIELD(Wcompinvp1)
+SIM_TECH_FIELD(Wcompinvn1)
+SIM_TECH_FIELD(Wcompinvp2)
+SIM_TECH_FIELD(Wcompinvn2)
+SIM_TECH_FIELD(Wcompinvp3)
+SIM_TECH_FIELD(Wcompinvn3)
+SIM_TECH_FIELD(Wevalinvp)
+SIM_TECH_FIELD(Wevalinvn)
+SIM_TECH_FIELD(Wcompn)
+SIM_TECH_FIELD(Wcompp)
+SIM_TECH_FIELD(Wcomppreequ)
+SIM_TECH_FIELD(Wmuxdrv12n)
+SIM_TECH_FIELD(Wmuxdrv12p)
+SIM_TECH_FIELD(WmuxdrvNANDn)
+SIM_TECH_FIELD(WmuxdrvNANDp)
+SIM_TECH_FIELD(WmuxdrvNORn)
+SIM_TECH_FIELD(WmuxdrvNORp)
+SIM_TECH_FIELD(Wmuxdrv3n)
+SIM_TECH_FIELD(Wmuxdrv3p)
+SIM_TECH_FIELD(Woutdrvseln)
+SIM_TECH_FIELD(Woutdrvselp)
+SIM_TECH_FIELD(Woutdrvnandn)
+SIM_TECH_FIELD(Woutdrvnandp)
+SIM_TECH_FIELD(Woutdrvnorn)
+SIM_TECH_FIELD(Woutdrvnorp)
+SIM_TECH_FIELD(Woutdrivern)
+SIM_TECH_FIELD(Woutdriverp)
+SIM_TECH_FIELD(Wbusdrvn)
+SIM_TECH_FIELD(Wbusdrvp)
+SIM_TECH_FIELD(Wcompcellpd2)
+SIM_TECH_FIELD(Wcompdrivern)
+SIM_TECH_FIELD(Wcompdriverp)
+SIM_TECH_FIELD(Wcomparen2)
+SIM_TECH_FIELD(Wcomparen1)
+SIM_TECH_FIELD(Wmatchpchg)
+SIM_TECH_FIELD(Wmatchinvn)
+SIM_TECH_FIELD(Wmatchinvp)
+SIM_TECH_FIELD(Wmatchnandn)
+SIM_TECH_FIELD(Wmatchnandp)
+SIM_TECH_FIELD(Wmatchnorn)
+SIM_TECH_FIELD(Wmatchnorp)
+SIM_TECH_FIELD(WSelORn)
+SIM_TECH_FIELD(WSelORprequ)
+SIM_TECH_FIELD(WSelPn)
+SIM_TECH_FIELD(WSelPp)
+SIM_TECH_FIELD(WSelEnn)
+SIM_TECH_FIELD(WSelEnp)
+SIM_TECH_FIELD(Wsenseextdrv1p)
+SIM_TECH_FIELD(Wsenseextdrv1n)
+SIM_TECH_FIELD(Wsenseextdrv2p)
+SIM_TECH_FIELD(Wsenseextdrv2n)
+SIM_TECH_FIELD(CamCellHeight)
+SIM_TECH_FIELD(CamCellWidth)
+SIM_TECH_FIELD(MatchlineSpacing)
+SIM_TECH_FIELD(TaglineSpacing)
+SIM_TECH_FIELD(CrsbarCellHeight)
+SIM_TECH_FIELD(CrsbarCellWidth)
+SIM_TECH_FIELD(krise)
+SIM_TECH_FIELD(tsensedata)
+SIM_TECH_FIELD(tsensetag)
+SIM_TECH_FIELD(tfalldata)
+SIM_TECH_FIELD(tfalltag)
+SIM_TECH_FIELD(WireMinWidth)
+SIM_TECH_FIELD(WireMinSpacing)
+SIM_TECH_FIELD(WireMetalThickness)
+SIM_TECH_FIELD(WireBarrierThickness)
+SIM_TECH_FIELD(WireDielectricThickness)
+SIM_TECH_FIELD(WireDielectricConstant)
+SIM_TECH_FIELD(BufferDriveResistance)
+SIM_TECH_FIELD(BufferIntrinsicDelay)
+SIM_TECH_FIELD(BufferInputCapacitance)
+SIM_TECH_FIELD(BufferPMOSOffCurrent)
+SIM_TECH_FIELD(BufferNMOSOffCurrent)
+SIM_TECH_FIELD(ClockCap)
+SIM_TECH_FIELD(AreaNOR)
+SIM_TECH_FIELD(AreaINV)
+SIM_TECH_FIELD(AreaAND)
+SIM_TECH_FIELD(AreaDFF)
+SIM_TECH_FIELD(AreaMUX2)
+SIM_TECH_FIELD(AreaMUX3)
+SIM_TECH_FIELD(AreaMUX4)
+
+/* technology_area_power.h */
+SIM_TECH_FIELD(Area_NOR_um2)
+SIM_TECH_FIELD(Area_INV_um2)
+SIM_TECH_FIELD(Area_AND_um2)
+SIM_TECH_FIELD(Area_DFF_um2)
+SIM_TECH_FIELD(Area_MUX2_um2)
+SIM_TECH_FIELD(Area_MUX3_um2)
+SIM_TECH_FIELD(Area_MUX4_um2)
+SIM_TECH_FIELD(Area_AOI_um2)
+SIM_TECH_FIELD(NOR_leak_nW)
+SIM_TECH_FIELD(INV_leak_nW)
+SIM_TECH_FIELD(DFF_leak_nW)
+SIM_TECH_FIELD(AOI_leak_nW)
+SIM_TECH_FIELD(MUX2_leak_nW)
+SIM_TECH_FIELD(NOR_load_pF)
+SIM_TECH_FIELD(INV_load_pF)
+SIM_TECH_FIELD(DFF_load_pF)
+SIM_TECH_FIELD(AOI_load_pF)
+SIM_TECH_FIELD(MUX2_load_pF)
+SIM_TECH_FIELD(NOR_int_J)
+SIM_TECH_FIELD(INV_int_J)
+SIM_TECH_FIELD(DFF_int_J)
+SIM_TECH_FIELD(AOI_int_J)
+SIM_TECH_FIELD(MUX2_int_J)
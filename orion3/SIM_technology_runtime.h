@@ -0,0 +1,408 @@
+/* Technology of the models being initialized, chosen at run time.
+ *
+ * SIM_port.h gives the default technology node and transistor type; the
+ * parameters that differ between nodes and types (SIM_technology_fields.h)
+ * are then read from SIM_tech, which is one of the tables built by
+ * SIM_technology_table.c for 90nm, 65nm, 45nm and 32nm and LVT, NVT and
+ * HVT, and is set by SIM_set_technology() (see SIM_util.c). So, the
+ * macros of the technology files keep their names, but are redirected
+ * here to SIM_tech. SIM_technology_table.c, which builds the tables from
+ * the compile-time values of the macros, defines SIM_TECH_TABLE. */
+
+#ifndef _SIM_TECHNOLOGY_RUNTIME_H
+#define _SIM_TECHNOLOGY_RUNTIME_H
+
+#if (PARM(TECH_POINT) > 90)
+#error "the technology tables are for 90nm, 65nm, 45nm and 32nm only"
+#endif
+
+typedef struct {
+	int tech_point;
+	int transistor_type;
+	/* field tech_X is the value of macro X */
+#define SIM_TECH_FIELD(n) double tech_ ## n;
+#include "SIM_technology_fields.h"
+#undef SIM_TECH_FIELD
+	/* leakage currents of SIM_static.h */
+	double tech_NMOS_TAB[1];
+	double tech_PMOS_TAB[1];
+	double tech_NAND2_TAB[4];
+	double tech_NOR2_TAB[4];
+	double tech_DFF_TAB[1];
+} SIM_technology_t;
+
+/* name of the table of a node and transistor type, e.g.,
+ * SIM_TECH_NAME(65, LVT) */
+#define SIM_TECH_NAME_(n, t) SIM_technology_ ## n ## _ ## t
+#define SIM_TECH_NAME(n, t) SIM_TECH_NAME_(n, t)
+
+/* technology and operating point of the models being initialized; each
+ * thread has its own, so that threads can initialize models of different
+ * nodes and operating points at the same time; SIM_tech, SIM_Vdd and
+ * SIM_Freq are those of the calling thread */
+typedef struct {
+	const SIM_technology_t *tech;
+	double vdd;
+	double freq;
+} SIM_context_t;
+
+extern __thread SIM_context_t SIM_context;
+
+#define SIM_tech	(SIM_context.tech)
+#define SIM_Vdd		(SIM_context.vdd)
+#define SIM_Freq	(SIM_context.freq)
+
+/* technology node (nm) and transistor type of SIM_tech; PARM(TECH_POINT)
+ * and PARM(TRANSISTOR_TYPE) are the defaults */
+#define SIM_TECH_POINT		(SIM_tech->tech_point)
+#define SIM_TRANSISTOR_TYPE	(SIM_tech->transistor_type)
+
+#ifndef SIM_TECH_TABLE
+/* SIM_technology.h */
+#undef PARM_Cgatepass
+#define PARM_Cgatepass (SIM_tech->tech_PARM_Cgatepass)
+#undef PARM_Cpdiffarea
+#define PARM_Cpdiffarea (SIM_tech->tech_PARM_Cpdiffarea)
+#undef PARM_Cpdiffside
+#define PARM_Cpdiffside (SIM_tech->tech_PARM_Cpdiffside)
+#undef PARM_Cndiffside
+#define PARM_Cndiffside (SIM_tech->tech_PARM_Cndiffside)
+#undef PARM_Cndiffarea
+#define PARM_Cndiffarea (SIM_tech->tech_PARM_Cndiffarea)
+#undef PARM_Cnoverlap
+#define PARM_Cnoverlap (SIM_tech->tech_PARM_Cnoverlap)
+#undef PARM_Cgate
+#define PARM_Cgate (SIM_tech->tech_PARM_Cgate)
+#undef PARM_Cpdiffovlp
+#define PARM_Cpdiffovlp (SIM_tech->tech_PARM_Cpdiffovlp)
+#undef PARM_Cndiffovlp
+#define PARM_Cndiffovlp (SIM_tech->tech_PARM_Cndiffovlp)
+#undef PARM_Cnoxideovlp
+#define PARM_Cnoxideovlp (SIM_tech->tech_PARM_Cnoxideovlp)
+#undef PARM_Cpoxideovlp
+#define PARM_Cpoxideovlp (SIM_tech->tech_PARM_Cpoxideovlp)
+/* SIM_technology_v2_NEW.h */
+#undef SCALE_T
+#define SCALE_T (SIM_tech->tech_SCALE_T)
+#undef SCALE_M
+#define SCALE_M (SIM_tech->tech_SCALE_M)
+#undef SCALE_S
+#define SCALE_S (SIM_tech->tech_SCALE_S)
+#undef SCALE_W
+#define SCALE_W (SIM_tech->tech_SCALE_W)
+#undef SCALE_H
+#define SCALE_H (SIM_tech->tech_SCALE_H)
+#undef SCALE_BW
+#define SCALE_BW (SIM_tech->tech_SCALE_BW)
+#undef SCALE_Crs
+#define SCALE_Crs (SIM_tech->tech_SCALE_Crs)
+#undef LSCALE
+#define LSCALE (SIM_tech->tech_LSCALE)
+#undef BitWidth
+#define BitWidth (SIM_tech->tech_BitWidth)
+#undef BitHeight
+#define BitHeight (SIM_tech->tech_BitHeight)
+#undef Cout
+#define Cout (SIM_tech->tech_Cout)
+#undef BitlineSpacing
+#define BitlineSpacing (SIM_tech->tech_BitlineSpacing)
+#undef WordlineSpacing
+#define WordlineSpacing (SIM_tech->tech_WordlineSpacing)
+#undef RegCellHeight
+#define RegCellHeight (SIM_tech->tech_RegCellHeight)
+#undef RegCellWidth
+#define RegCellWidth (SIM_tech->tech_RegCellWidth)
+#undef Cwordmetal
+#define Cwordmetal (SIM_tech->tech_Cwordmetal)
+#undef Cbitmetal
+#define Cbitmetal (SIM_tech->tech_Cbitmetal)
+#undef CCmetal
+#define CCmetal (SIM_tech->tech_CCmetal)
+#undef CCM2metal
+#define CCM2metal (SIM_tech->tech_CCM2metal)
+#undef CCM3metal
+#define CCM3metal (SIM_tech->tech_CCM3metal)
+#undef CC2metal
+#define CC2metal (SIM_tech->tech_CC2metal)
+#undef CC2M2metal
+#define CC2M2metal (SIM_tech->tech_CC2M2metal)
+#undef CC2M3metal
+#define CC2M3metal (SIM_tech->tech_CC2M3metal)
+#undef CC3metal
+#define CC3metal (SIM_tech->tech_CC3metal)
+#undef CC3M2metal
+#define CC3M2metal (SIM_tech->tech_CC3M2metal)
+#undef CC3M3metal
+#define CC3M3metal (SIM_tech->tech_CC3M3metal)
+#undef Clockwire
+#define Clockwire (SIM_tech->tech_Clockwire)
+#undef Reswire
+#define Reswire (SIM_tech->tech_Reswire)
+#undef invCap
+#define invCap (SIM_tech->tech_invCap)
+#undef Resout
+#define Resout (SIM_tech->tech_Resout)
+#undef Leff
+#define Leff (SIM_tech->tech_Leff)
+#undef Cpolywire
+#define Cpolywire (SIM_tech->tech_Cpolywire)
+#undef Rnchannelstatic
+#define Rnchannelstatic (SIM_tech->tech_Rnchannelstatic)
+#undef Rpchannelstatic
+#define Rpchannelstatic (SIM_tech->tech_Rpchannelstatic)
+#undef Rnchannelon
+#define Rnchannelon (SIM_tech->tech_Rnchannelon)
+#undef Rpchannelon
+#define Rpchannelon (SIM_tech->tech_Rpchannelon)
+#undef Rbitmetal
+#define Rbitmetal (SIM_tech->tech_Rbitmetal)
+#undef Rwordmetal
+#define Rwordmetal (SIM_tech->tech_Rwordmetal)
+#undef Vt
+#define Vt (SIM_tech->tech_Vt)
+#undef Wdecdrivep
+#define Wdecdrivep (SIM_tech->tech_Wdecdrivep)
+#undef Wdecdriven
+#define Wdecdriven (SIM_tech->tech_Wdecdriven)
+#undef Wdec3to8n
+#define Wdec3to8n (SIM_tech->tech_Wdec3to8n)
+#undef Wdec3to8p
+#define Wdec3to8p (SIM_tech->tech_Wdec3to8p)
+#undef WdecNORn
+#define WdecNORn (SIM_tech->tech_WdecNORn)
+#undef WdecNORp
+#define WdecNORp (SIM_tech->tech_WdecNORp)
+#undef Wdecinvn
+#define Wdecinvn (SIM_tech->tech_Wdecinvn)
+#undef Wdecinvp
+#define Wdecinvp (SIM_tech->tech_Wdecinvp)
+#undef Wdff
+#define Wdff (SIM_tech->tech_Wdff)
+#undef Wworddrivemax
+#define Wworddrivemax (SIM_tech->tech_Wworddrivemax)
+#undef Wmemcella
+#define Wmemcella (SIM_tech->tech_Wmemcella)
+#undef Wmemcellr
+#define Wmemcellr (SIM_tech->tech_Wmemcellr)
+#undef Wmemcellw
+#define Wmemcellw (SIM_tech->tech_Wmemcellw)
+#undef Wmemcellbscale
+#define Wmemcellbscale (SIM_tech->tech_Wmemcellbscale)
+#undef Wbitpreequ
+#define Wbitpreequ (SIM_tech->tech_Wbitpreequ)
+#undef Wbitmuxn
+#define Wbitmuxn (SIM_tech->tech_Wbitmuxn)
+#undef WsenseQ1to4
+#define WsenseQ1to4 (SIM_tech->tech_WsenseQ1to4)
+#undef Wcompinvp1
+#define Wcompinvp1 (SIM_tech->tech_Wcompinvp1)
+#undef Wcompinvn1
+#define Wcompinvn1 (SIM_tech->tech_Wcompinvn1)
+#undef Wcompinvp2
+#define Wcompinvp2 (SIM_tech->tech_Wcompinvp2)
+#undef Wcompinvn2
+#define Wcompinvn2 (SIM_tech->tech_Wcompinvn2)
+#undef Wcompinvp3
+#define Wcompinvp3 (SIM_tech->tech_Wcompinvp3)
+#undef Wcompinvn3
+#define Wcompinvn3 (SIM_tech->tech_Wcompinvn3)
+#undef Wevalinvp
+#define Wevalinvp (SIM_tech->tech_Wevalinvp)
+#undef Wevalinvn
+#define Wevalinvn (SIM_tech->tech_Wevalinvn)
+#undef Wcompn
+#define Wcompn (SIM_tech->tech_Wcompn)
+#undef Wcompp
+#define Wcompp (SIM_tech->tech_Wcompp)
+#undef Wcomppreequ
+#define Wcomppreequ (SIM_tech->tech_Wcomppreequ)
+#undef Wmuxdrv12n
+#define Wmuxdrv12n (SIM_tech->tech_Wmuxdrv12n)
+#undef Wmuxdrv12p
+#define Wmuxdrv12p (SIM_tech->tech_Wmuxdrv12p)
+#undef WmuxdrvNANDn
+#define WmuxdrvNANDn (SIM_tech->tech_WmuxdrvNANDn)
+#undef WmuxdrvNANDp
+#define WmuxdrvNANDp (SIM_tech->tech_WmuxdrvNANDp)
+#undef WmuxdrvNORn
+#define WmuxdrvNORn (SIM_tech->tech_WmuxdrvNORn)
+#undef WmuxdrvNORp
+#define WmuxdrvNORp (SIM_tech->tech_WmuxdrvNORp)
+#undef Wmuxdrv3n
+#define Wmuxdrv3n (SIM_tech->tech_Wmuxdrv3n)
+#undef Wmuxdrv3p
+#define Wmuxdrv3p (SIM_tech->tech_Wmuxdrv3p)
+#undef Woutdrvseln
+#define Woutdrvseln (SIM_tech->tech_Woutdrvseln)
+#undef Woutdrvselp
+#define Woutdrvselp (SIM_tech->tech_Woutdrvselp)
+#undef Woutdrvnandn
+#define Woutdrvnandn (SIM_tech->tech_Woutdrvnandn)
+#undef Woutdrvnandp
+#define Woutdrvnandp (SIM_tech->tech_Woutdrvnandp)
+#undef Woutdrvnorn
+#define Woutdrvnorn (SIM_tech->tech_Woutdrvnorn)
+#undef Woutdrvnorp
+#define Woutdrvnorp (SIM_tech->tech_Woutdrvnorp)
+#undef Woutdrivern
+#define Woutdrivern (SIM_tech->tech_Woutdrivern)
+#undef Woutdriverp
+#define Woutdriverp (SIM_tech->tech_Woutdriverp)
+#undef Wbusdrvn
+#define Wbusdrvn (SIM_tech->tech_Wbusdrvn)
+#undef Wbusdrvp
+#define Wbusdrvp (SIM_tech->tech_Wbusdrvp)
+#undef Wcompcellpd2
+#define Wcompcellpd2 (SIM_tech->tech_Wcompcellpd2)
+#undef Wcompdrivern
+#define Wcompdrivern (SIM_tech->tech_Wcompdrivern)
+#undef Wcompdriverp
+#define Wcompdriverp (SIM_tech->tech_Wcompdriverp)
+#undef Wcomparen2
+#define Wcomparen2 (SIM_tech->tech_Wcomparen2)
+#undef Wcomparen1
+#define Wcomparen1 (SIM_tech->tech_Wcomparen1)
+#undef Wmatchpchg
+#define Wmatchpchg (SIM_tech->tech_Wmatchpchg)
+#undef Wmatchinvn
+#define Wmatchinvn (SIM_tech->tech_Wmatchinvn)
+#undef Wmatchinvp
+#define Wmatchinvp (SIM_tech->tech_Wmatchinvp)
+#undef Wmatchnandn
+#define Wmatchnandn (SIM_tech->tech_Wmatchnandn)
+#undef Wmatchnandp
+#define Wmatchnandp (SIM_tech->tech_Wmatchnandp)
+#undef Wmatchnorn
+#define Wmatchnorn (SIM_tech->tech_Wmatchnorn)
+#undef Wmatchnorp
+#define Wmatchnorp (SIM_tech->tech_Wmatchnorp)
+#undef WSelORn
+#define WSelORn (SIM_tech->tech_WSelORn)
+#undef WSelORprequ
+#define WSelORprequ (SIM_tech->tech_WSelORprequ)
+#undef WSelPn
+#define WSelPn (SIM_tech->tech_WSelPn)
+#undef WSelPp
+#define WSelPp (SIM_tech->tech_WSelPp)
+#undef WSelEnn
+#define WSelEnn (SIM_tech->tech_WSelEnn)
+#undef WSelEnp
+#define WSelEnp (SIM_tech->tech_WSelEnp)
+#undef Wsenseextdrv1p
+#define Wsenseextdrv1p (SIM_tech->tech_Wsenseextdrv1p)
+#undef Wsenseextdrv1n
+#define Wsenseextdrv1n (SIM_tech->tech_Wsenseextdrv1n)
+#undef Wsenseextdrv2p
+#define Wsenseextdrv2p (SIM_tech->tech_Wsenseextdrv2p)
+#undef Wsenseextdrv2n
+#define Wsenseextdrv2n (SIM_tech->tech_Wsenseextdrv2n)
+#undef CamCellHeight
+#define CamCellHeight (SIM_tech->tech_CamCellHeight)
+#undef CamCellWidth
+#define CamCellWidth (SIM_tech->tech_CamCellWidth)
+#undef MatchlineSpacing
+#define MatchlineSpacing (SIM_tech->tech_MatchlineSpacing)
+#undef TaglineSpacing
+#define TaglineSpacing (SIM_tech->tech_TaglineSpacing)
+#undef CrsbarCellHeight
+#define CrsbarCellHeight (SIM_tech->tech_CrsbarCellHeight)
+#undef CrsbarCellWidth
+#define CrsbarCellWidth (SIM_tech->tech_CrsbarCellWidth)
+#undef krise
+#define krise (SIM_tech->tech_krise)
+#undef tsensedata
+#define tsensedata (SIM_tech->tech_tsensedata)
+#undef tsensetag
+#define tsensetag (SIM_tech->tech_tsensetag)
+#undef tfalldata
+#define tfalldata (SIM_tech->tech_tfalldata)
+#undef tfalltag
+#define tfalltag (SIM_tech->tech_tfalltag)
+#undef WireMinWidth
+#define WireMinWidth (SIM_tech->tech_WireMinWidth)
+#undef WireMinSpacing
+#define WireMinSpacing (SIM_tech->tech_WireMinSpacing)
+#undef WireMetalThickness
+#define WireMetalThickness (SIM_tech->tech_WireMetalThickness)
+#undef WireBarrierThickness
+#define WireBarrierThickness (SIM_tech->tech_WireBarrierThickness)
+#undef WireDielectricThickness
+#define WireDielectricThickness (SIM_tech->tech_WireDielectricThickness)
+#undef WireDielectricConstant
+#define WireDielectricConstant (SIM_tech->tech_WireDielectricConstant)
+#undef BufferDriveResistance
+#define BufferDriveResistance (SIM_tech->tech_BufferDriveResistance)
+#undef BufferIntrinsicDelay
+#define BufferIntrinsicDelay (SIM_tech->tech_BufferIntrinsicDelay)
+#undef BufferInputCapacitance
+#define BufferInputCapacitance (SIM_tech->tech_BufferInputCapacitance)
+#undef BufferPMOSOffCurrent
+#define BufferPMOSOffCurrent (SIM_tech->tech_BufferPMOSOffCurrent)
+#undef BufferNMOSOffCurrent
+#define BufferNMOSOffCurrent (SIM_tech->tech_BufferNMOSOffCurrent)
+#undef ClockCap
+#define ClockCap (SIM_tech->tech_ClockCap)
+#undef AreaNOR
+#define AreaNOR (SIM_tech->tech_AreaNOR)
+#undef AreaINV
+#define AreaINV (SIM_tech->tech_AreaINV)
+#undef AreaAND
+#define AreaAND (SIM_tech->tech_AreaAND)
+#undef AreaDFF
+#define AreaDFF (SIM_tech->tech_AreaDFF)
+#undef AreaMUX2
+#define AreaMUX2 (SIM_tech->tech_AreaMUX2)
+#undef AreaMUX3
+#define AreaMUX3 (SIM_tech->tech_AreaMUX3)
+#undef AreaMUX4
+#define AreaMUX4 (SIM_tech->tech_AreaMUX4)
+/* technology_area_power.h */
+#undef Area_NOR_um2
+#define Area_NOR_um2 (SIM_tech->tech_Area_NOR_um2)
+#undef Area_INV_um2
+#define Area_INV_um2 (SIM_tech->tech_Area_INV_um2)
+#undef Area_AND_um2
+#define Area_AND_um2 (SIM_tech->tech_Area_AND_um2)
+#undef Area_DFF_um2
+#define Area_DFF_um2 (SIM_tech->tech_Area_DFF_um2)
+#undef Area_MUX2_um2
+#define Area_MUX2_um2 (SIM_tech->tech_Area_MUX2_um2)
+#undef Area_MUX3_um2
+#define Area_MUX3_um2 (SIM_tech->tech_Area_MUX3_um2)
+#undef Area_MUX4_um2
+#define Area_MUX4_um2 (SIM_tech->tech_Area_MUX4_um2)
+#undef Area_AOI_um2
+#define Area_AOI_um2 (SIM_tech->tech_Area_AOI_um2)
+#undef NOR_leak_nW
+#define NOR_leak_nW (SIM_tech->tech_NOR_leak_nW)
+#undef INV_leak_nW
+#define INV_leak_nW (SIM_tech->tech_INV_leak_nW)
+#undef DFF_leak_nW
+#define DFF_leak_nW (SIM_tech->tech_DFF_leak_nW)
+#undef AOI_leak_nW
+#define AOI_leak_nW (SIM_tech->tech_AOI_leak_nW)
+#undef MUX2_leak_nW
+#define MUX2_leak_nW (SIM_tech->tech_MUX2_leak_nW)
+#undef NOR_load_pF
+#define NOR_load_pF (SIM_tech->tech_NOR_load_pF)
+#undef INV_load_pF
+#define INV_load_pF (SIM_tech->tech_INV_load_pF)
+#undef DFF_load_pF
+#define DFF_load_pF (SIM_tech->tech_DFF_load_pF)
+#undef AOI_load_pF
+#define AOI_load_pF (SIM_tech->tech_AOI_load_pF)
+#undef MUX2_load_pF
+#define MUX2_load_pF (SIM_tech->tech_MUX2_load_pF)
+#undef NOR_int_J
+#define NOR_int_J (SIM_tech->tech_NOR_int_J)
+#undef INV_int_J
+#define INV_int_J (SIM_tech->tech_INV_int_J)
+#undef DFF_int_J
+#define DFF_int_J (SIM_tech->tech_DFF_int_J)
+#undef AOI_int_J
+#define AOI_int_J (SIM_tech->tech_AOI_int_J)
+#undef MUX2_int_J
+#define MUX2_int_J (SIM_tech->tech_MUX2_int_J)
+#endif /* SIM_TECH_TABLE */
+
+#endif /* _SIM_TECHNOLOGY_RUNTIME_H */
@@ -0,0 +1,123 @@
+/*-------------------------------------------------------------------------
+ *                             ORION 2.0 
+ *
+ *         					Copyright 2009 
+ *  	Princeton University, and Regents of the University of California 
+ *                         All Rights Reserved
+ *
+ *                         
+ *  ORION 2.0 was developed by Bin Li at Princeton University and Kambiz Samadi at
+ *  University of California, San Diego. ORION 2.0 was built on top of ORION 1.0. 
+ *  ORION 1.0 was developed by Hangsheng Wang, Xinping Zhu and Xuning Chen at 
+ *  Princeton University.
+ *
+ *  If your use of this software contributes to a published paper, we
+ *  request that you cite our paper that appears on our website 
+ *  http://www.princeton.edu/~peh/orion.html
+ *
+ *  Permission to use, copy, and modify this software and its documentation is
+ *  granted only under the following terms and conditions.  Both the
+ *  above copyright notice and this permission notice must appear in all copies
+ *  of the software, derivative works or modified versions, and any portions
+ *  thereof, and both notices must appear in supporting documentation.
+ *
+ *  This software may be distributed (but not offered for sale or transferred
+ *  for compensation) to third parties, provided such third parties agree to
+ *  abide by the terms and conditions of this notice.
+ *
+ *  This software is distributed in the hope that it will be useful to the
+ *  community, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  
+ *
+ *-----------------------------------------------------------------------*/
+
+
+/* The technology table of one node and transistor type, i.e., the values
+ * of the macros of SIM_technology_fields.h when PARM(TECH_POINT) and
+ * PARM(TRANSISTOR_TYPE) are those ones. The Makefile compiles this file
+ * once per node and type, giving them with -D; see
+ * SIM_technology_runtime.h. */
+
+#define SIM_TECH_TABLE
+#include "SIM_parameter.h"
+
+/* not given for all nodes */
+#ifndef Area_AND_um2
+#define Area_AND_um2	0
+#endif
+#ifndef Area_AOI_um2
+#define Area_AOI_um2	0
+#endif
+#ifndef NOR_leak_nW
+#define NOR_leak_nW		0
+#define INV_leak_nW		0
+#define DFF_leak_nW		0
+#define AOI_leak_nW		0
+#define MUX2_leak_nW	0
+#endif
+#ifndef NOR_load_pF
+#define NOR_load_pF		0
+#define INV_load_pF		0
+#define DFF_load_pF		0
+#define AOI_load_pF		0
+#define MUX2_load_pF	0
+#endif
+#ifndef NOR_int_J
+#define NOR_int_J		0
+#define INV_int_J		0
+#define DFF_int_J		0
+#define AOI_int_J		0
+#define MUX2_int_J		0
+#endif
+
+/* leakage currents, formerly of SIM_static.c */
+#if (PARM(TECH_POINT) == 90 && PARM(TRANSISTOR_TYPE) == LVT)
+#define NMOS_TAB_VALUES {19.9e-9}
+#define PMOS_TAB_VALUES {16.6e-9}
+#define NAND2_TAB_VALUES {7.8e-9, 24.6e-9, 14.1e-9, 34.3e-9}
+#define NOR2_TAB_VALUES {51.2e-9, 23.9e-9, 19.5e-9, 8.4e-9}
+#define DFF_TAB_VALUES {219.7e-9}
+#elif (PARM(TECH_POINT) == 90 && PARM(TRANSISTOR_TYPE) == NVT)
+#define NMOS_TAB_VALUES {15.6e-9}
+#define PMOS_TAB_VALUES {11.3e-9}
+#define NAND2_TAB_VALUES {2.8e-9, 19.6e-9, 10.4e-9, 29.3e-9}
+#define NOR2_TAB_VALUES {41.5e-9, 13.1e-9, 14.5e-9, 1.4e-9}
+#define DFF_TAB_VALUES {194.7e-9}
+#elif (PARM(TECH_POINT) == 90 && PARM(TRANSISTOR_TYPE) == HVT)
+#define NMOS_TAB_VALUES {12.2e-9}
+#define PMOS_TAB_VALUES {9.3e-9}
+#define NAND2_TAB_VALUES {1.8e-9, 12.4e-9, 8.9e-9, 19.3e-9}
+#define NOR2_TAB_VALUES {29.5e-9, 8.3e-9, 11.1e-9, 0.9e-9}
+#define DFF_TAB_VALUES {194.7e-9}
+#elif (PARM(TECH_POINT) <= 65 && PARM(TRANSISTOR_TYPE) == LVT) 
+#define NMOS_TAB_VALUES {311.7e-9}
+#define PMOS_TAB_VALUES {674.3e-9}
+#define NAND2_TAB_VALUES {303.0e-9, 423.0e-9, 498.3e-9, 626.3e-9}
+#define NOR2_TAB_VALUES {556.0e-9, 393.7e-9, 506.7e-9, 369.7e-9}
+#define DFF_TAB_VALUES {970.4e-9}
+#elif (PARM(TECH_POINT) <= 65 && PARM(TRANSISTOR_TYPE) == NVT) 
+#define NMOS_TAB_VALUES {115.1e-9}
+#define PMOS_TAB_VALUES {304.8e-9}
+#define NAND2_TAB_VALUES {111.4e-9, 187.2e-9, 230.7e-9, 306.9e-9}
+#define NOR2_TAB_VALUES {289.7e-9, 165.7e-9, 236.9e-9, 141.4e-9}
+#define DFF_TAB_VALUES {400.3e-9}
+#elif (PARM(TECH_POINT) <= 65 && PARM(TRANSISTOR_TYPE) == HVT) 
+#define NMOS_TAB_VALUES {18.4e-9}
+#define PMOS_TAB_VALUES {35.2e-9}
+#define NAND2_TAB_VALUES {19.7e-9, 51.3e-9, 63.0e-9, 87.6e-9}
+#define NOR2_TAB_VALUES {23.4e-9, 37.6e-9, 67.9e-9, 12.3e-9}
+#define DFF_TAB_VALUES {231.3e-9}
+#endif
+
+const SIM_technology_t SIM_TECH_NAME(PARM_TECH_POINT, PARM_TRANSISTOR_TYPE) = {
+	.tech_point = PARM(TECH_POINT),
+	.transistor_type = PARM(TRANSISTOR_TYPE),
+#define SIM_TECH_FIELD(n) .tech_ ## n = n,
+#include "SIM_technology_fields.h"
+#undef SIM_TECH_FIELD
+	.tech_NMOS_TAB = NMOS_TAB_VALUES,
+	.tech_PMOS_TAB = PMOS_TAB_VALUES,
+	.tech_NAND2_TAB = NAND2_TAB_VALUES,
+	.tech_NOR2_TAB = NOR2_TAB_VALUES,
+	.tech_DFF_TAB = DFF_TAB_VALUES,
+};
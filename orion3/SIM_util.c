@@ -39,6 +39,48 @@
 #include "SIM_util.h"
 #include "SIM_time.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void SIM_set_operating_point(double vdd, double freq)
+{
+	SIM_Vdd = vdd;
+	SIM_Freq = freq;
+}
+
+/* technology tables of the nodes and transistor types (see
+ * SIM_technology_table.c) */
+extern const SIM_technology_t SIM_TECH_NAME(90, LVT), SIM_TECH_NAME(90, NVT), SIM_TECH_NAME(90, HVT);
+extern const SIM_technology_t SIM_TECH_NAME(65, LVT), SIM_TECH_NAME(65, NVT), SIM_TECH_NAME(65, HVT);
+extern const SIM_technology_t SIM_TECH_NAME(45, LVT), SIM_TECH_NAME(45, NVT), SIM_TECH_NAME(45, HVT);
+extern const SIM_technology_t SIM_TECH_NAME(32, LVT), SIM_TECH_NAME(32, NVT), SIM_TECH_NAME(32, HVT);
+
+static const SIM_technology_t *SIM_technologies[] = {
+	&SIM_TECH_NAME(90, LVT), &SIM_TECH_NAME(90, NVT), &SIM_TECH_NAME(90, HVT),
+	&SIM_TECH_NAME(65, LVT), &SIM_TECH_NAME(65, NVT), &SIM_TECH_NAME(65, HVT),
+	&SIM_TECH_NAME(45, LVT), &SIM_TECH_NAME(45, NVT), &SIM_TECH_NAME(45, HVT),
+	&SIM_TECH_NAME(32, LVT), &SIM_TECH_NAME(32, NVT), &SIM_TECH_NAME(32, HVT)};
+
+/* context of each thread (see SIM_technology_runtime.h); the technology
+ * and operating point of SIM_port.h until they are set */
+__thread SIM_context_t SIM_context = {
+	&SIM_TECH_NAME(PARM_TECH_POINT, PARM_TRANSISTOR_TYPE), PARM(Vdd), PARM(Freq)};
+
+int SIM_set_technology(int tech_point, int transistor_type)
+{
+	u_int i;
+
+	for (i = 0; i < sizeof(SIM_technologies) / sizeof(SIM_technologies[0]); i++) {
+		if (SIM_technologies[i]->tech_point == tech_point &&
+		    SIM_technologies[i]->transistor_type == transistor_type) {
+			SIM_tech = SIM_technologies[i];
+			return 0;
+		}
+	}
+	return -1;
+}
+
 /* Hamming distance table */
 static u_char h_tab[256] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 3, 4, 4, 5, 4, 5, 5, 6, 4, 5, 5, 6, 5, 6, 6, 7, 4, 5, 5, 6, 5, 6, 6, 7, 5, 6, 6, 7, 6, 7, 7, 8};
 
@@ -88,16 +130,21 @@ int SIM_init(void)
 }
 
 
+/* number of 1 bits of x; the popcount instruction (or libgcc's popcount)
+ * with gcc, the Hamming distance table otherwise */
 /* assume LIB_Type_max_uint is u_int64_t */
-u_int SIM_Hamming(LIB_Type_max_uint old_val, LIB_Type_max_uint new_val, LIB_Type_max_uint mask)
+static inline u_int SIM_popcount(LIB_Type_max_uint x)
 {
+#ifdef __GNUC__
+	return __builtin_popcountll(x);
+#else
 	union {
 		LIB_Type_max_uint x;
 		u_char id[8];
 	} u;
 	u_int rval;
 
-	u.x = (old_val ^ new_val) & mask;
+	u.x = x;
 
 	rval = h_tab[u.id[0]];
 	rval += h_tab[u.id[1]];
@@ -108,6 +155,72 @@ u_int SIM_Hamming(LIB_Type_max_uint old_val, LIB_Type_max_uint new_val, LIB_Type
 	rval += h_tab[u.id[6]];
 	rval += h_tab[u.id[7]];
 
+	return rval;
+#endif
+}
+
+
+u_int SIM_Hamming(LIB_Type_max_uint old_val, LIB_Type_max_uint new_val, LIB_Type_max_uint mask)
+{
+	return SIM_popcount((old_val ^ new_val) & mask);
+}
+
+
+/* Hamming distance of two arrays of n_words words (e.g., the 64-bit words of
+ * a multi-word flit), i.e., the sum of SIM_Hamming of each pair of words;
+ * with AVX2, 4 words are done at once: the 1 bits of each nibble are looked
+ * up with a byte shuffle and the bytes are summed per word with sad */
+u_int SIM_Hamming_words(const LIB_Type_max_uint *old_val, const LIB_Type_max_uint *new_val, u_int n_words, LIB_Type_max_uint mask)
+{
+	u_int i = 0, rval = 0;
+
+#ifdef __AVX2__
+	if (n_words >= 4) {
+		const __m256i nibble_tab = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+		const __m256i mask_v = _mm256_set1_epi64x((long long)mask);
+		__m256i sum = _mm256_setzero_si256();
+		LIB_Type_max_uint sums[4];
+
+		for (; i + 4 <= n_words; i += 4) {
+			__m256i x = _mm256_and_si256(_mm256_xor_si256(
+				_mm256_loadu_si256((const __m256i *)(old_val + i)),
+				_mm256_loadu_si256((const __m256i *)(new_val + i))), mask_v);
+			__m256i lo = _mm256_shuffle_epi8(nibble_tab, _mm256_and_si256(x, low_nibbles));
+			__m256i hi = _mm256_shuffle_epi8(nibble_tab,
+				_mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibbles));
+			sum = _mm256_add_epi64(sum,
+				_mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+		}
+		_mm256_storeu_si256((__m256i *)sums, sum);
+		rval = sums[0] + sums[1] + sums[2] + sums[3];
+	}
+#endif
+
+	for (; i < n_words; i++)
+		rval += SIM_popcount((old_val[i] ^ new_val[i]) & mask);
+
+	return rval;
+}
+
+
+/* Hamming distance of two byte strings, i.e., the sum of SIM_Hamming of
+ * each pair of bytes with mask 0xFF; done 8 bytes at a time */
+u_int SIM_Hamming_bytes(const u_char *old_val, const u_char *new_val, u_int n_bytes)
+{
+	LIB_Type_max_uint old_w, new_w;
+	u_int i = 0, rval = 0;
+
+	for (; i + sizeof(LIB_Type_max_uint) <= n_bytes; i += sizeof(LIB_Type_max_uint)) {
+		memcpy(&old_w, old_val + i, sizeof(LIB_Type_max_uint));
+		memcpy(&new_w, new_val + i, sizeof(LIB_Type_max_uint));
+		rval += SIM_popcount(old_w ^ new_w);
+	}
+	for (; i < n_bytes; i++)
+		rval += SIM_popcount((LIB_Type_max_uint)(old_val[i] ^ new_val[i]));
+
 	return rval;
 }
 
@@ -259,9 +372,9 @@ int SIM_print_stat_energy(char *path, double Energy, int print_flag)
 
 int SIM_dump_tech_para(void)
 {
-	fprintf(stderr, "technology: 0.%dum\n", PARM(TECH_POINT));
+	fprintf(stderr, "technology: %dnm\n", SIM_TECH_POINT);
 	fprintf(stderr, "Vdd: %gV\n", Vdd);
-	fprintf(stderr, "frequency: %gHz\n", PARM(Freq));
+	fprintf(stderr, "frequency: %gHz\n", SIM_Freq);
 	fprintf(stderr, "minimal spacing metal capacitance: %gF/um\n", CCmetal);
 	fprintf(stderr, "2x minimal spacing metal capacitance: %gF/um\n", CC2metal);
 	fprintf(stderr, "distant metal capacitance: %gF/um\n", Cmetal);
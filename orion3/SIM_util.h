@@ -35,6 +35,8 @@
 #define _SIM_UTIL_H
 
 extern u_int SIM_Hamming(LIB_Type_max_uint old_val, LIB_Type_max_uint new_val, LIB_Type_max_uint mask);
+extern u_int SIM_Hamming_words(const LIB_Type_max_uint *old_val, const LIB_Type_max_uint *new_val, u_int n_words, LIB_Type_max_uint mask);
+extern u_int SIM_Hamming_bytes(const u_char *old_val, const u_char *new_val, u_int n_bytes);
 extern u_int SIM_Hamming_group(LIB_Type_max_uint d1_new, LIB_Type_max_uint d1_old, LIB_Type_max_uint d2_new, LIB_Type_max_uint d2_old, u_int width, u_int n_grp);
 
 /* statistical functions */
@@ -49,5 +51,17 @@ extern u_int SIM_logtwo(LIB_Type_max_uint x);
 extern int SIM_squarify(int rows, int cols);
 extern double SIM_driver_size(double driving_cap, double desiredrisetime);
 
+/* Vdd (V) and Freq (Hz) used by the models initialized next by the
+ * calling thread */
+extern void SIM_set_operating_point(double vdd, double freq);
+
+/* technology node (90, 65, 45 or 32) and transistor type (LVT, NVT or HVT)
+ * used by the models initialized next by the calling thread; returns -1
+ * if there is no table for them, 0 otherwise */
+extern int SIM_set_technology(int tech_point, int transistor_type);
+
+/* checksum of the sources and flags of the library; see Makefile */
+extern const char SIM_sources_fingerprint[];
+
 #endif /* _SIM_UTIL_H */
 
@@ -149,24 +149,30 @@ int main(int argc, char **argv)
 	
     if (ver == 2) {
         #include "SIM_router.h"
+        SIM_router_info_t SIM_info;
+        SIM_router_power_t SIM_power;
+        SIM_router_area_t SIM_area;
         //printf("Simulating Orion2\n");
         name = argv[optind];
-        SIM_router_init(&GLOB(SIM_router_info), &GLOB(SIM_router_power), NULL);
+        SIM_router_init(&SIM_info, &SIM_power, NULL);
 
-        SIM_router_stat_energy(&GLOB(SIM_router_info), &GLOB(SIM_router_power),
+        SIM_router_stat_energy(&SIM_info, &SIM_power,
             print_depth, name, max_flag, load, 1, PARM(Freq)); // plot_flag = 1
 
 
-        SIM_router_init(&GLOB(SIM_router_info), NULL, &GLOB(SIM_router_area));
+        SIM_router_init(&SIM_info, NULL, &SIM_area);
 
-        SIM_router_area(&GLOB(SIM_router_area));
+        SIM_router_area(&SIM_area);
 
     }
     else if(ver ==3){
 		#include "router.h"
+		router_info_t info;
+		router_power_t power;
+		router_area_t area;
 		if (rmodel ==1) {
-			router_initialize(&GLOB(router_info), &GLOB(router_power), NULL);
-			router_initialize(&GLOB(router_info), NULL, &GLOB(router_area));
+			router_initialize(&info, &power, NULL);
+			router_initialize(&info, NULL, &area);
 		} else 
 		{	
 			strcpy(path_Test, "sh print_params.sh ");
@@ -38,11 +38,6 @@ PATENT, TRADEMARK OR OTHER RIGHTS.
 
 #include "router.h"
 
-/* global variables */
-GLOBDEF(router_power_t, router_power);
-GLOBDEF(router_info_t, router_info);
-GLOBDEF(router_area_t, router_area);
-
 int router_initialize(router_info_t *info, router_power_t *router_power, router_area_t *router_area)
 {
 	/* PHASE 1: set parameters */
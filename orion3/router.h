@@ -92,11 +92,6 @@ typedef struct {
 } router_info_t;
 
 
-/* global variables */
-extern GLOBDEF(router_power_t, router_power);
-extern GLOBDEF(router_info_t, router_info);
-extern GLOBDEF(router_area_t, router_area);
-
 /*!
 \fn router_initialize
 \param router_info_t *info
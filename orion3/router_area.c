@@ -69,12 +69,8 @@ double get_router_area(router_area_t *router_area)
 	insts_outbuffer = router_area->a_outbuffer.get_instances(&router_area->a_outbuffer);
 	insts_clkctrl = router_area->a_clockctrl.get_instances(&router_area->a_clockctrl);
 
-#if( PARM(TECH_POINT) <= 90 )
 	fprintf(stdout, "INSTSinbuffer:%g\tINSTSoutbuffer:%g\t INSTScrossbar:%g\t INSTSswvc:%g\t INSTSclkctrl:%g\t Ainbuffer:%g\tAoutbuffer:%g\t Acrossbar:%g\t Aswvc:%g\t Aclkctrl:%g\t Atotal:%g\n", 
 	insts_inbuffer,insts_outbuffer,insts_xbar, insts_swvc, insts_clkctrl,a_inbuffer,a_outbuffer, a_xbar, a_swvc, a_clkctrl, a_total);	
 
-#else
-    fprintf(stderr, "Router area is only supported for 65nm and 45nm\n");
-#endif
 	return a_total;
 }
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// parallel_runs: runs several simulations at the same time, each in its own
+// thread with its own TOPOLOGY, EVENT_QUEUE and VNOC, and checks that their
+// results are the same as when they are run one by one; see "make test";
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// <thread> goes first; the min and max macros of vnoc_gui.h break it;
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sstream>
+#include <vector>
+#include "vnoc_topology.h"
+#include "vnoc_event.h"
+#include "vnoc_gui.h"
+#include "vnoc.h"
+
+
+using namespace std;
+
+
+// the configurations differ in what the Orion models and the simulation
+// engines keep per run: technology node, transistors, DVFS levels,
+// engine and topology;
+static const char *CONFIGS[] = {
+    "traffic: UNIFORM injection_rate: 0.02 cycles: 10000 do_dvfs: 0 tech_node: 32 transistor_type: NVT",
+    "traffic: UNIFORM injection_rate: 0.02 cycles: 10000 do_dvfs: 0 tech_node: 90",
+    "traffic: UNIFORM injection_rate: 0.03 cycles: 10000 do_dvfs: 1 inp_buf: 8 tech_node: 45 transistor_type: HVT",
+    "traffic: SELFSIMILAR ary_size: 8 injection_rate: 0.010 cycles: 10000 do_dvfs: 1 use_boost: 1 hist_window: 50",
+    "traffic: HOTSPOT injection_rate: 0.02 cycles: 10000 do_dvfs: 0 hotspots: 5 10 hotspot_percentage: 20",
+    "traffic: UNIFORM injection_rate: 0.02 cycles: 10000 do_dvfs: 0 engine: PDES threads: 2 nz: 2 ary_size: 4",
+    "traffic: UNIFORM injection_rate: 0.02 cycles: 10000 do_dvfs: 0 topology: TORUS routing: TXY tech_node: 65 transistor_type: HVT",
+};
+
+struct RUN_RESULT {
+    long injected;
+    double latency;
+    double power;
+    RUN_RESULT() : injected(-1), latency(0.0), power(0.0) {}
+};
+
+static void run_config( const string &config, RUN_RESULT *result)
+{
+    // same steps as main() of vnoc_main.cpp, without the gui;
+    vector<string> words( 1, "vnoc");
+    istringstream config_st( config);
+    string word;
+    while ( config_st >> word) {
+        words.push_back( word);
+    }
+    vector<char *> argv;
+    for ( long i = 0; i < long(words.size()); i++) {
+        argv.push_back( const_cast<char *>( words[i].c_str()));
+    }
+    argv.push_back( 0);
+
+    TOPOLOGY topology( int(words.size()), &argv[0]);
+    EVENT_QUEUE event_queue( 0, &topology);
+    VNOC vnoc( &topology, &event_queue, false);
+    event_queue.set_vnoc( &vnoc);
+    event_queue.insert_initial_events();
+    GUI_GRAPHICS gui( &topology, &vnoc);
+    vnoc.set_gui( &gui);
+    gui.set_graphics_state( false, 1);
+
+    vnoc.run_simulation();
+    vnoc.update_and_print_simulation_results();
+
+    result->injected = vnoc.total_packets_injected_count();
+    result->latency = vnoc.latency();
+    result->power = vnoc.power();
+}
+
+int main( int argc, char *argv[])
+{
+    // the reports of the runs go to stdout, interleaved; the verdict goes
+    // to stderr;
+    long configs_count = sizeof( CONFIGS) / sizeof( CONFIGS[0]);
+    long rounds = ( argc > 1) ? atol( argv[1]) : 2;
+
+    // (1) one by one;
+    vector<RUN_RESULT> expected( configs_count);
+    for ( long i = 0; i < configs_count; i++) {
+        run_config( CONFIGS[i], &expected[i]);
+    }
+
+    // (2) all at the same time, a few rounds; results must be exactly
+    // the same;
+    long mismatches = 0;
+    for ( long round = 0; round < rounds; round++) {
+        vector<RUN_RESULT> results( configs_count);
+        vector<thread> threads;
+        for ( long i = 0; i < configs_count; i++) {
+            threads.push_back( thread( run_config, string( CONFIGS[i]), &results[i]));
+        }
+        for ( long i = 0; i < configs_count; i++) {
+            threads[i].join();
+        }
+        for ( long i = 0; i < configs_count; i++) {
+            const RUN_RESULT &e = expected[i];
+            const RUN_RESULT &r = results[i];
+            bool same = ( r.injected == e.injected && r.latency == e.latency &&
+                r.power == e.power);
+            fprintf( stderr, "round %ld, run %ld: %s\n", round, i, same ? "OK" : "MISMATCH");
+            if ( !same) {
+                fprintf( stderr, "    %s\n", CONFIGS[i]);
+                fprintf( stderr, "    injected %ld vs %ld, latency %.10g vs %.10g, power %.10g vs %.10g\n",
+                    r.injected, e.injected, r.latency, e.latency, r.power, e.power);
+                mismatches ++;
+            }
+        }
+    }
+    fprintf( stderr, "parallel_runs: %ld mismatches in %ld runs\n",
+        mismatches, rounds * configs_count);
+    return ( mismatches == 0) ? 0 : 1;
+}
@@ -4,6 +4,10 @@
 #include <cstdio>
 #include <algorithm>
 #include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "vnoc.h"
 #include "vnoc_event.h"
@@ -36,7 +40,7 @@ void PREDICTOR_MODULE::maintain_for_prediction_SYNC(ROUTER *my_router)
     if ( _predictor_type == HISTORY) {
 
         // (a) maintain;
-        for (long i = 1; i < 5; i++) {
+        for (long i = 1; i < _ports_count; i++) {
              _BU_predicted_out_i[i] +=
                 my_router->compute_BU_for_downstream_driven_by_out_i( i);
         }
@@ -60,7 +64,7 @@ void PREDICTOR_MODULE::perform_prediction_SYNC(ROUTER *my_router)
     if ( _predictor_type == HISTORY) {
 
         // (b) perform; because we are at end of history window;
-        for ( long i = 1; i < 5; i++) {
+        for ( long i = 1; i < _ports_count; i++) {
             // ---> last cycle of this history window; 
             // finish eq.3 in Li Shang paper;
             _BU_predicted_out_i[i] = _BU_predicted_out_i[i] / 
@@ -179,7 +183,7 @@ void PREDICTOR_MODULE::maintain_or_perform_prediction_ASYNC(ROUTER *my_router)
         // (a) maintain;
         if (my_router->cycle_counter_4_prediction() < _history_window) { 
 
-            for (long i = 1; i < 5; i++) {
+            for (long i = 1; i < _ports_count; i++) {
                 // ---> compute input buffer occupancy of input buffer
                 // of downstream router and accumulate it; actual
                 // average (eq.3 in Li Shang paper) will be done in the
@@ -228,7 +232,7 @@ void PREDICTOR_MODULE::maintain_or_perform_prediction_ASYNC(ROUTER *my_router)
         // (b) perform; because we are at end of history window;
         else { 
 
-            for (long i = 1; i < 5; i++) {
+            for (long i = 1; i < _ports_count; i++) {
                 // ---> last cycle of this history window; 
                 // finish eq.3 in Li Shang paper;
                 _BU_predicted_out_i[i] = _BU_predicted_out_i[i] / 
@@ -371,7 +375,7 @@ void PREDICTOR_MODULE::update_DVFS_settings_throttle_only( ROUTER *my_router)
         double TL_low = 0.3, TL_high = 0.4;
         double TH_low = 0.6, TH_high = 0.7;
         double T_low = 0.0, T_high = 0.0;
-        for (long i = 1; i < 5; i++) {
+        for (long i = 1; i < _ports_count; i++) {
             if ( _BU_predicted_out_i[i] < 0.5) {
                 T_low = TL_low;
                 T_high = TL_high;
@@ -425,7 +429,7 @@ void PREDICTOR_MODULE::update_DVFS_settings_throttle_only( ROUTER *my_router)
     else {
         long num_of_congestion_low_signals = 0;
         long num_of_congestion_high_signals = 0;
-        for (long i = 1; i < 5; i++) {
+        for (long i = 1; i < _ports_count; i++) {
             if ( _BU_predicted_out_i[i] > 0.65) {
                 // the prediction done locally here at the output of this
                 // router about the BU of the downstream input-port router
@@ -486,7 +490,7 @@ void PREDICTOR_MODULE::update_DVFS_settings_throttle_and_boost( ROUTER *my_route
         double TL_low = 0.3, TL_high = 0.4;
         double TH_low = 0.6, TH_high = 0.7;
         double T_low = 0.0, T_high = 0.0;
-        for (long i = 1; i < 5; i++) {
+        for (long i = 1; i < _ports_count; i++) {
             if ( _BU_predicted_out_i[i] < 0.5) {
                 T_low = TL_low;
                 T_high = TL_high;
@@ -543,7 +547,7 @@ void PREDICTOR_MODULE::update_DVFS_settings_throttle_and_boost( ROUTER *my_route
     else {
         long num_of_congestion_low_signals = 0;
         long num_of_congestion_high_signals = 0;
-        for (long i = 1; i < 5; i++) {
+        for (long i = 1; i < _ports_count; i++) {
             if ( _BU_predicted_out_i[i] > 0.65) {
                 // the prediction done locally here at the output of this
                 // router about the BU of the downstream input-port router
@@ -585,27 +589,147 @@ void PREDICTOR_MODULE::update_DVFS_settings_throttle_and_boost( ROUTER *my_route
 
 ////////////////////////////////////////////////////////////////////////////////
 //
-// POWER_MODULE
+// POWER_MODEL
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-POWER_MODULE::POWER_MODULE( long physical_ports_count, long vc_count,
-                            long flit_size, double link_length) :
-    _flit_size( flit_size),
+POWER_MODEL::POWER_MODEL( long physical_ports_count, long vc_count,
+                          double link_length, int arbiter_model,
+                          double vdd, double freq, const TOPOLOGY *topology) :
     _router_info(),
     _router_power(),
-    _router_area(),
     _arbiter_vc_power(),
     _link_power(),
-    _buffer_write(),
-    _buffer_read(),
-    _crossbar_read(),
-    _crossbar_write(),
-    _link_traversal(),
-    _crossbar_input(),
-    _arbiter_vc_req(),
-    _arbiter_vc_grant()
+    _clock_energy(0.0),
+    _buffer_write_mask(0),
+    _buffer_read_mask(0),
+    _crossbar_mask(0),
+    _link_mask(0)
+{
+    const string &cache_dir = topology->power_cache_dir();
+    if ( cache_dir.empty()) {
+        init_orion( physical_ports_count, vc_count, link_length, arbiter_model,
+            vdd, freq, topology);
+        return;
+    }
+    // the file has a text header, which must be the same as the one
+    // of this configuration and build of Orion, then the saved parts;
+    char name_t[256], header_t[512];
+    sprintf( name_t, "/orion_%ld_%ld_%g_%d_%gV_%gHz_%ldnm_%d_%ld_%ld.bin",
+        physical_ports_count, vc_count, link_length, arbiter_model, vdd, freq,
+        topology->tech_node(), int(topology->transistor_type()),
+        topology->input_buffer_size(), topology->output_buffer_size());
+    sprintf( header_t, "vnoc power model\n%s\n%ld %ld %.17g %d %.17g %.17g %ld %d %ld %ld\n", 
+        SIM_sources_fingerprint, physical_ports_count, vc_count,
+        link_length, arbiter_model, vdd, freq,
+        topology->tech_node(), int(topology->transistor_type()),
+        topology->input_buffer_size(), topology->output_buffer_size());
+    string file_name = cache_dir + name_t;
+    if ( !load( file_name, header_t)) {
+        init_orion( physical_ports_count, vc_count, link_length, arbiter_model,
+            vdd, freq, topology);
+        save( cache_dir, file_name, header_t);
+    }
+}
+
+void POWER_MODEL::saved_parts( vector<pair<char *, size_t> > &parts)
+{
+    // Orion's structs have no pointers other than the get_* functions
+    // of SIM_array_info_t, which are NULL for the arrays of routers;
+    parts.push_back( make_pair( (char *) &_router_info, sizeof( _router_info)));
+    parts.push_back( make_pair( (char *) &_router_power, sizeof( _router_power)));
+    parts.push_back( make_pair( (char *) &_arbiter_vc_power, sizeof( _arbiter_vc_power)));
+    parts.push_back( make_pair( (char *) &_link_power, sizeof( _link_power)));
+    parts.push_back( make_pair( (char *) &_clock_energy, sizeof( _clock_energy)));
+    parts.push_back( make_pair( (char *) &_buffer_write_mask, sizeof( _buffer_write_mask)));
+    parts.push_back( make_pair( (char *) &_buffer_read_mask, sizeof( _buffer_read_mask)));
+    parts.push_back( make_pair( (char *) &_crossbar_mask, sizeof( _crossbar_mask)));
+    parts.push_back( make_pair( (char *) &_link_mask, sizeof( _link_mask)));
+}
+
+bool POWER_MODEL::load( const string &file_name, const string &header)
+{
+    // returns false if there is no file or it is not of this
+    // configuration and build of Orion;
+    int fd = open( file_name.c_str(), O_RDONLY);
+    if ( fd < 0) {
+        return false;
+    }
+    struct stat file_stat;
+    if ( fstat( fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close( fd);
+        return false;
+    }
+    size_t file_size = file_stat.st_size;
+    void *mapped = mmap( 0, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close( fd);
+    if ( mapped == MAP_FAILED) {
+        return false;
+    }
+    const char *data = (const char *) mapped;
+    vector<pair<char *, size_t> > parts;
+    saved_parts( parts);
+    size_t size = header.size();
+    for ( long i = 0; i < long(parts.size()); i++) {
+        size += parts[i].second;
+    }
+    bool valid = ( file_size == size &&
+        memcmp( data, header.data(), header.size()) == 0);
+    if ( valid) {
+        data += header.size();
+        for ( long i = 0; i < long(parts.size()); i++) {
+            memcpy( parts[i].first, data, parts[i].second);
+            data += parts[i].second;
+        }
+    }
+    munmap( mapped, file_size);
+    return valid;
+}
+
+void POWER_MODEL::save( const string &cache_dir, const string &file_name,
+    const string &header)
 {
+    // written to a temporary file first, so that runs started at the same
+    // time never load a partial file; not being able to save is not an error;
+    mkdir( cache_dir.c_str(), 0755);
+    char suffix_t[32];
+    sprintf( suffix_t, ".%ld", (long) getpid());
+    string temp_name = file_name + suffix_t;
+    FILE *file = fopen( temp_name.c_str(), "wb");
+    if ( file == NULL) {
+        printf("Warning:  cannot write power model to %s.\n", temp_name.c_str());
+        return;
+    }
+    vector<pair<char *, size_t> > parts;
+    saved_parts( parts);
+    bool written = ( fwrite( header.data(), 1, header.size(), file) == header.size());
+    for ( long i = 0; i < long(parts.size()); i++) {
+        written = written &&
+            ( fwrite( parts[i].first, 1, parts[i].second, file) == parts[i].second);
+    }
+    written = ( fclose( file) == 0) && written;
+    if ( !written || rename( temp_name.c_str(), file_name.c_str()) != 0) {
+        printf("Warning:  cannot write power model to %s.\n", file_name.c_str());
+        remove( temp_name.c_str());
+    }
+}
+
+void POWER_MODEL::init_orion( long physical_ports_count, long vc_count,
+    double link_length, int arbiter_model, double vdd, double freq,
+    const TOPOLOGY *topology)
+{
+    // Orion sizes drivers and computes energies with these; see SIM_util.c;
+    // the technology tables must be selected first, as the operating point
+    // checks Vdd against them; both are of this thread only, so VNOC's of
+    // other threads can build their models at the same time;
+    int transistor_types[] = { LVT, NVT, HVT };
+    if ( SIM_set_technology( topology->tech_node(), 
+        transistor_types[ topology->transistor_type()]) != 0) {
+        printf("Error:  Orion has no technology tables for %ldnm.\n",
+            topology->tech_node());
+        exit(1);
+    }
+    SIM_set_operating_point( vdd, freq);
 
     // () buffer init
 
@@ -619,10 +743,22 @@ POWER_MODULE::POWER_MODULE( long physical_ports_count, long vc_count,
     //    NULL, // router_power_t *router_power
     //    &_router_area); // router_area_t *router_area
     // orion2:
-    SIM_router_init( // see SIM_router.c
+    // the ports other than the PE port; i.e., 4 in the 2D mesh, as
+    // PARM(in_port) and PARM(out_port) of SIM_port.h, 6 in the 3D mesh;
+    // vc's and buffer sizes as those of the simulation, instead of the
+    // PARM(v_channel), PARM(in_buf_set) and PARM(out_buf_set) defaults;
+    SIM_router_parm_t router_parm;
+    SIM_router_parm_default( &router_parm);
+    router_parm.n_in = physical_ports_count - 1;
+    router_parm.n_out = physical_ports_count - 1;
+    router_parm.n_v_channel = vc_count;
+    router_parm.in_buf_set = topology->input_buffer_size();
+    router_parm.out_buf_set = topology->output_buffer_size();
+    SIM_router_init_with_parm( // see SIM_router.c
         &_router_info, // SIM_router_info_t *info
         &_router_power, // SIM_router_power_t *SIM_router_power
-        NULL); // SIM_router_area_t *SIM_router_area
+        NULL, // SIM_router_area_t *SIM_router_area
+        &router_parm); // const SIM_router_parm_t *parm
     // the above calls SIM_router_power_init():
     //SIM_router_power_init( // see SIM_router_power.c
     //    &_router_info, // SIM_router_info_t *info
@@ -634,35 +770,15 @@ POWER_MODULE::POWER_MODULE( long physical_ports_count, long vc_count,
     // orion1:
     //FUNC(SIM_router_power_init, &_router_info, &_router_power);
 
-    _buffer_write.resize( physical_ports_count);
-    _buffer_read.resize( physical_ports_count);
-    _crossbar_read.resize( physical_ports_count);
-    _crossbar_write.resize( physical_ports_count);
-    _link_traversal.resize( physical_ports_count);
-    _crossbar_input.resize( physical_ports_count,0);
-    for (long i = 0; i < physical_ports_count; i ++) {
-        _buffer_write[i].resize( _flit_size, 0);
-        _buffer_read[i].resize( _flit_size, 0);
-        _crossbar_read[i].resize( _flit_size, 0);
-        _crossbar_write[i].resize( _flit_size, 0);
-        _link_traversal[i].resize( _flit_size, 0);
-    }
-
 
     // () arbiter init
     SIM_arbiter_init(
         &_arbiter_vc_power, // SIM_arbiter_t *arb
-        1, // int arbiter_model 
+        arbiter_model, // int arbiter_model; RR_ARBITER, MATRIX_ARBITER
         1, // int ff_model
         physical_ports_count * vc_count, // u_int req_width
         0, // double length
         NULL); // SIM_array_info_t *info
-    _arbiter_vc_req.resize( physical_ports_count);
-    _arbiter_vc_grant.resize( physical_ports_count);
-    for (long i = 0; i < physical_ports_count; i ++) {
-        _arbiter_vc_req[i].resize( vc_count, 1);
-        _arbiter_vc_grant[i].resize( vc_count, 1);
-    }
 
 
     // () crossbar init
@@ -694,29 +810,151 @@ POWER_MODULE::POWER_MODULE( long physical_ports_count, long vc_count,
         link_length, // double length
         0); // double time; rise and fall time, 0 means using default transistor sizes
 
+    // () clock energy of 4 cycles; it does not depend on the activity;
+    _clock_energy = SIM_total_clockEnergy( // see SIM_clock.c
+        &_router_info, // SIM_router_info_t *info
+        &_router_power); // SIM_router_power_t *SIM_router_power
+
+    // () bits that Orion counts toggles of;
+    _buffer_write_mask = SIM_buf_power_data_write_mask();
+    _buffer_read_mask = SIM_buf_power_data_read_mask( &( _router_info.in_buf_info));
+    _crossbar_mask = _router_power.crossbar.mask;
+    _link_mask = _link_power.bus_mask;
+}
+
+double POWER_MODEL::buffer_energy( const POWER_ACTIVITY &activity) const
+{
+    // Orion only reads the info structs;
+    SIM_array_info_t *info = const_cast<SIM_array_info_t *>( &( _router_info.in_buf_info));
+    SIM_array_t in_buf = _router_power.in_buf;
+    SIM_buf_power_data_write_batch( // see SIM_router.c
+        info, // SIM_array_info_t *info
+        &in_buf, // SIM_array_t *arr
+        activity._buffer_writes, // LIB_Type_max_uint n_write
+        activity._buffer_write_toggles); // LIB_Type_max_uint n_toggles
+    SIM_buf_power_data_read_batch( // see SIM_router.c
+        info, // SIM_array_info_t *info
+        &in_buf, // SIM_array_t *arr
+        activity._buffer_reads, // LIB_Type_max_uint n_read
+        activity._buffer_read_ones); // LIB_Type_max_uint n_ones
+    // power of array only;
+    return SIM_array_power_report( info, &in_buf); // see SIM_array_l.c
+}
+
+double POWER_MODEL::crossbar_energy( const POWER_ACTIVITY &activity) const
+{
+    SIM_crossbar_t crossbar = _router_power.crossbar;
+    SIM_crossbar_record_batch( // see SIM_crossbar.c
+        &crossbar, // SIM_crossbar_t *xb
+        activity._crossbar_in_toggles, // LIB_Type_max_uint n_chg_in
+        activity._crossbar_out_toggles, // LIB_Type_max_uint n_chg_out
+        activity._crossbar_port_changes); // LIB_Type_max_uint n_chg_ctr
+    return SIM_crossbar_report( &crossbar);
+}
+
+double POWER_MODEL::arbiter_energy( const POWER_ACTIVITY &activity) const
+{
+    SIM_arbiter_t arbiter = _arbiter_vc_power;
+    SIM_arbiter_record_batch( // see SIM_arbiter.c
+        &arbiter, // SIM_arbiter_t *arb
+        activity._arbiter_records, // LIB_Type_max_uint n_record
+        activity._arbiter_req_toggles, // LIB_Type_max_uint n_chg_req
+        activity._arbiter_grant_changes); // LIB_Type_max_uint n_chg_grant
+    return SIM_arbiter_report( &arbiter);
+}
+
+double POWER_MODEL::link_energy( const POWER_ACTIVITY &activity) const
+{
+    SIM_bus_t link = _link_power;
+    SIM_bus_record_batch( // see SIM_misc.c
+        &link, // SIM_bus_t *bus
+        activity._link_toggles); // LIB_Type_max_uint n_switch
+    return SIM_bus_report( &link);
+}
+
+double POWER_MODEL::clock_energy( const POWER_ACTIVITY &activity) const
+{
+    // as SIM_total_during_n_cycles_clockEnergy() of SIM_clock.c, which
+    // counts cycles in an int;
+    int cycles = (int) activity._cycles;
+    return (cycles / 4) * _clock_energy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// POWER_MODULE
+//
+////////////////////////////////////////////////////////////////////////////////
+
+POWER_MODULE::POWER_MODULE( const vector<const POWER_MODEL *> &models,
+                            long physical_ports_count,
+                            long vc_count, long flit_size) :
+    _models( models),
+    _flit_size( flit_size),
+    _buffer_write(),
+    _buffer_read(),
+    _crossbar_read(),
+    _crossbar_write(),
+    _link_traversal(),
+    _crossbar_input(),
+    _arbiter_vc_req(),
+    _arbiter_vc_grant(),
+    _activities( DVFS_LEVELS_COUNT),
+    _dvfs_level( DVFS_BASE)
+{
+    _buffer_write.resize( physical_ports_count);
+    _buffer_read.resize( physical_ports_count);
+    _crossbar_read.resize( physical_ports_count);
+    _crossbar_write.resize( physical_ports_count);
+    _link_traversal.resize( physical_ports_count);
+    _crossbar_input.resize( physical_ports_count,0);
+    for (long i = 0; i < physical_ports_count; i ++) {
+        _buffer_write[i].resize( _flit_size, 0);
+        _buffer_read[i].resize( _flit_size, 0);
+        _crossbar_read[i].resize( _flit_size, 0);
+        _crossbar_write[i].resize( _flit_size, 0);
+        _link_traversal[i].resize( _flit_size, 0);
+    }
+
+    // requests are as wide as physical_ports_count * vc_count; they are
+    // kept in chunks of 64 bits;
+    long req_words_count = ( physical_ports_count * vc_count + 63) / 64;
+    _arbiter_vc_req.resize( physical_ports_count);
+    _arbiter_vc_grant.resize( physical_ports_count);
+    for (long i = 0; i < physical_ports_count; i ++) {
+        _arbiter_vc_req[i].resize( vc_count);
+        for (long j = 0; j < vc_count; j ++) {
+            _arbiter_vc_req[i][j].resize( req_words_count, 0);
+            _arbiter_vc_req[i][j][0] = 1;
+        }
+        _arbiter_vc_grant[i].resize( vc_count, 1);
+    }
+
     // () DVFS related;
     _scaled_energy = 0.0;
-    _prev_unscaled_energy = 0.0;
     _scaled_energy_buffer = 0.0;
-    _prev_unscaled_energy_buffer = 0.0;
     _scaled_energy_crossbar = 0.0;
-    _prev_unscaled_energy_crossbar = 0.0;
     _scaled_energy_arbiter = 0.0;
-    _prev_unscaled_energy_arbiter = 0.0;
     _scaled_energy_link = 0.0;
-    _prev_unscaled_energy_link = 0.0;
     _scaled_energy_clock = 0.0;
-    _prev_unscaled_energy_clock = 0.0;
 
-    _current_vdd = VDD_BASE; 
-    _current_period = PIPE_DELAY_BASE;
-    _energy_scaling_factor = SCALING_BASE; 
+    _current_period = ticks_to_cycles( PIPE_DELAY_BASE);
 }
 
 
-void POWER_MODULE::power_buffer_write(long in_port, DATA &write_d)
+void POWER_MODULE::power_buffer_write(long in_port, const DATA_ATOMIC_UNIT *write_d)
 {
-    // orion2:
+    POWER_ACTIVITY &activity = _activities[ _dvfs_level];
+    // count only; energy is computed from the counts on reports;
+    activity._buffer_writes += _flit_size;
+    activity._buffer_write_toggles += SIM_Hamming_words( // see SIM_util.c
+        (const LIB_Type_max_uint *) &_buffer_write[in_port][0],
+        (const LIB_Type_max_uint *) write_d, _flit_size, _models[ DVFS_BASE]->buffer_write_mask());
+    for (long i = 0; i < _flit_size; i ++) {
+        _buffer_write[in_port][i] = write_d[i];
+    }
+    /*---
+    // orion2, each word recorded right away:
     for (long i = 0; i < _flit_size; i ++) {
         DATA_ATOMIC_UNIT old_d = _buffer_write[in_port][i];
         DATA_ATOMIC_UNIT new_d = write_d[i];
@@ -729,6 +967,7 @@ void POWER_MODULE::power_buffer_write(long in_port, DATA &write_d)
             (u_char *) (&new_d)); // u_char *new_data
         _buffer_write[in_port][i] = write_d[i];
     }
+    ---*/
     /*---
     // debugging purposes only:
     for (long i = 0; i < _flit_size; i ++) {
@@ -765,9 +1004,17 @@ void POWER_MODULE::power_buffer_write(long in_port, DATA &write_d)
     //}
 }
 
-void POWER_MODULE::power_buffer_read(long in_port, DATA &read_d)
+void POWER_MODULE::power_buffer_read(long in_port, const DATA_ATOMIC_UNIT *read_d)
 {
-    // orion2:
+    POWER_ACTIVITY &activity = _activities[ _dvfs_level];
+    // count only; energy is computed from the counts on reports;
+    activity._buffer_reads += _flit_size;
+    for (long i = 0; i < _flit_size; i++) {
+        activity._buffer_read_ones += __builtin_popcountll( read_d[i] & _models[ DVFS_BASE]->buffer_read_mask());
+        _buffer_read[in_port][i] = read_d[i];
+    }
+    /*---
+    // orion2, each word recorded right away:
     for (long i = 0; i < _flit_size; i++) {
         // eqivalent of: FUNC(SIM_buf_power_data_read,...) from orion1;
         SIM_buf_power_data_read( // see SIM_router.c
@@ -776,6 +1023,7 @@ void POWER_MODULE::power_buffer_read(long in_port, DATA &read_d)
             read_d[i]); // LIB_Type_max_uint data
         _buffer_read[in_port][i] = read_d[i];
     }
+    ---*/
     /*---
     // debugging purposes only:
     for (long i = 0; i < _flit_size; i++) {
@@ -801,16 +1049,19 @@ void POWER_MODULE::power_buffer_read(long in_port, DATA &read_d)
 }
 
 void POWER_MODULE::power_vc_arbit(long pc, long vc,
-    DATA_ATOMIC_UNIT req, unsigned long gra)
+    const BIT_VECTOR &req, unsigned long gra)
 {
-    // orion2:
-    SIM_arbiter_record(
-        &_arbiter_vc_power, // SIM_arbiter_t *arb
-        (LIB_Type_max_uint) req, // LIB_Type_max_uint new_req
-        (LIB_Type_max_uint) _arbiter_vc_req[pc][vc], // LIB_Type_max_uint old_req
-        (u_int) gra, // u_int new_grant
-        (u_int) _arbiter_vc_grant[pc][vc]); // u_int old_grant
-    _arbiter_vc_req[pc][vc] = req;
+    POWER_ACTIVITY &activity = _activities[ _dvfs_level];
+    // count only; energy is computed from the counts on reports; requests
+    // have no bits past the request width, so no mask is needed; 
+    vector<DATA_ATOMIC_UNIT> &old_req = _arbiter_vc_req[pc][vc];
+    activity._arbiter_records ++;
+    for (long w = 0; w < req.words_count(); w ++) {
+        activity._arbiter_req_toggles += __builtin_popcountll( req.word(w) ^ old_req[w]);
+        old_req[w] = req.word(w);
+    }
+    // compared as u_int, as Orion does;
+    activity._arbiter_grant_changes += ((u_int) gra != (u_int) _arbiter_vc_grant[pc][vc]);
     _arbiter_vc_grant[pc][vc] = gra;
     // orion1:
     //SIM_arbiter_record( &_arbiter_vc_power, req, 
@@ -820,28 +1071,26 @@ void POWER_MODULE::power_vc_arbit(long pc, long vc,
     //_arbiter_vc_grant[pc][vc] = gra;
 }
 
-void POWER_MODULE::power_crossbar_trav(long in_port, long out_port, DATA &trav_d)
+void POWER_MODULE::power_crossbar_trav(long in_port, long out_port, 
+    const DATA_ATOMIC_UNIT *trav_d)
 {
-    // orion2:
+    POWER_ACTIVITY &activity = _activities[ _dvfs_level];
+    // count only; energy is computed from the counts on reports; all
+    // words of the flit at once; the port changes only for the first word;
+    activity._crossbar_in_toggles += SIM_Hamming_words( // see SIM_util.c
+        (const LIB_Type_max_uint *) trav_d,
+        (const LIB_Type_max_uint *) &_crossbar_read[in_port][0],
+        _flit_size, _models[ DVFS_BASE]->crossbar_mask());
+    activity._crossbar_out_toggles += SIM_Hamming_words(
+        (const LIB_Type_max_uint *) trav_d,
+        (const LIB_Type_max_uint *) &_crossbar_write[out_port][0],
+        _flit_size, _models[ DVFS_BASE]->crossbar_mask());
+    activity._crossbar_port_changes += ( _crossbar_input[out_port] != in_port);
     for (long i = 0; i < _flit_size; i++) {
-        SIM_crossbar_record(
-            &( _router_power.crossbar), // SIM_crossbar_t *xb
-            1, // int io 
-            (LIB_Type_max_uint) trav_d[i], // LIB_Type_max_uint new_data
-            (LIB_Type_max_uint) _crossbar_read[in_port][i], // LIB_Type_max_uint old_data
-            1, // u_int new_port
-            1); // u_int old_port
-        SIM_crossbar_record(
-            &( _router_power.crossbar), 
-            0, 
-            (LIB_Type_max_uint) trav_d[i],
-            (LIB_Type_max_uint) _crossbar_write[out_port][i],
-            (u_int) _crossbar_input[out_port], 
-            (u_int) in_port);
         _crossbar_read[in_port][i] = trav_d[i];
         _crossbar_write[out_port][i] = trav_d[i];
-        _crossbar_input[out_port] = in_port;
     }
+    _crossbar_input[out_port] = in_port;
     // orion1:
     //for (long i = 0; i < _flit_size; i++) {
     //    SIM_crossbar_record(
@@ -857,16 +1106,15 @@ void POWER_MODULE::power_crossbar_trav(long in_port, long out_port, DATA &trav_d
     //}
 }
 
-void POWER_MODULE::power_link_traversal(long in_port, DATA &read_d)
+void POWER_MODULE::power_link_traversal(long in_port, const DATA_ATOMIC_UNIT *read_d)
 {
-    // orion2:
+    POWER_ACTIVITY &activity = _activities[ _dvfs_level];
+    // count only; energy is computed from the counts on reports;
+    activity._link_toggles += SIM_Hamming_words( // see SIM_util.c
+        (const LIB_Type_max_uint *) read_d,
+        (const LIB_Type_max_uint *) &_link_traversal[in_port][0],
+        _flit_size, _models[ DVFS_BASE]->link_mask());
     for (long i = 0; i < _flit_size; i++) {
-        DATA_ATOMIC_UNIT old_d = _link_traversal[in_port][i];
-        DATA_ATOMIC_UNIT new_d = read_d[i];
-        SIM_bus_record(
-            &_link_power, // SIM_bus_t *bus
-            (LIB_Type_max_uint) old_d, // LIB_Type_max_uint old_state
-            (LIB_Type_max_uint) new_d); // LIB_Type_max_uint new_state
         _link_traversal[in_port][i] = read_d[i];
     }
     // orion1:
@@ -878,10 +1126,10 @@ void POWER_MODULE::power_link_traversal(long in_port, DATA &read_d)
     //}
 }
 
-void POWER_MODULE::power_clock_record()
+void POWER_MODULE::power_clock_record( long cycles)
 {
-    // record a simulation cycle of the NoC;
-    SIM_simulation_cycles_record( &_router_info); // SIM_router_info_t *info
+    // record simulation cycles of the NoC; counted only;
+    _activities[ _dvfs_level]._cycles += cycles;
 }
 
 
@@ -917,10 +1165,8 @@ double POWER_MODULE::power_buffer_report()
         NULL, // char *path
         2e9); // int max_avg; PARM(Freq)
     ---*/
-    // power of array only;
-    buffer_energy = SIM_array_power_report( // see SIM_array_l.c
-        &( _router_info.in_buf_info), // &( SIM_array_info_t in_buf_info)
-        &( _router_power.in_buf)); // &( SIM_array_t in_buf)
+    // power of array only; see POWER_MODEL;
+    buffer_energy = _models[ DVFS_BASE]->buffer_energy( total_activity());
     //printf("\n buffer_energy: %g", buffer_energy); 
     // orion1:
     //return SIM_array_power_report(
@@ -931,12 +1177,12 @@ double POWER_MODULE::power_buffer_report()
 
 double POWER_MODULE::power_arbiter_report()
 {
-    return SIM_arbiter_report( &_arbiter_vc_power);
+    return _models[ DVFS_BASE]->arbiter_energy( total_activity());
 }
 
 double POWER_MODULE::power_crossbar_report()
 {
-    return SIM_crossbar_report( &( _router_power.crossbar));
+    return _models[ DVFS_BASE]->crossbar_energy( total_activity());
 }
 
 double POWER_MODULE::power_link_report()
@@ -945,55 +1191,50 @@ double POWER_MODULE::power_link_report()
     // Note: the way orion2 computes energy is: n_switch * e_switch
     // where e_switch = EnergyFactor * (TCap), where EnergyFactor = Vdd^2
     // and TCap = CC2metal * length [F/um * um]; 
-    return SIM_bus_report( &_link_power);
+    return _models[ DVFS_BASE]->link_energy( total_activity());
 }
 
 double POWER_MODULE::power_clock_report()
 {
     double clock_energy = 0.0;
-    // Note: this repots actually energy in J; this is a function that calls
-    // SIM_total_clockEnergy();
-    clock_energy = SIM_total_during_n_cycles_clockEnergy(
-        &_router_info, // SIM_router_info_t *info
-        &_router_power); // SIM_router_power_t *SIM_router_power
+    // Note: this repots actually energy in J; as what
+    // SIM_total_during_n_cycles_clockEnergy() would return;
+    clock_energy = _models[ DVFS_BASE]->clock_energy( total_activity());
     //printf("\n clock_energy: %g", clock_energy); 
     return clock_energy;
 }
 
+POWER_ACTIVITY POWER_MODULE::total_activity() const
+{
+    POWER_ACTIVITY total;
+    for ( long l = 0; l < DVFS_LEVELS_COUNT; l++) {
+        total.add( _activities[ l]);
+    }
+    return total;
+}
+
 void POWER_MODULE::scale_and_accumulate_energy()
 {
     // used for DVFS; read detailed comments in declaration of this class;
 
-    // retrieve Orion power and compute "delta" energy consumed since
-    // last call of this routine;
-    double curr_unscaled_energy =
-        power_buffer_report() + power_crossbar_report() +
-        power_arbiter_report() + power_link_report() +
-        power_clock_report();       
-    double delta_unscaled_energy =
-        curr_unscaled_energy - _prev_unscaled_energy;
-    _prev_unscaled_energy = curr_unscaled_energy; // prepare for next time;
-
-    // accumulate and store locally the total scaled energy consumed so far;
-    _scaled_energy += (delta_unscaled_energy * _energy_scaling_factor);
-
-    // compute also individual components;
-    _scaled_energy_buffer += 
-        ((power_buffer_report() - _prev_unscaled_energy_buffer) * _energy_scaling_factor);  
-    _scaled_energy_crossbar += 
-        ((power_crossbar_report() - _prev_unscaled_energy_crossbar) * _energy_scaling_factor);  
-    _scaled_energy_arbiter += 
-        ((power_arbiter_report() - _prev_unscaled_energy_arbiter) * _energy_scaling_factor);
-    _scaled_energy_link += 
-        ((power_link_report() - _prev_unscaled_energy_link) * _energy_scaling_factor);  
-    _scaled_energy_clock += 
-        ((power_clock_report() - _prev_unscaled_energy_clock) * _energy_scaling_factor); 
-
-    _prev_unscaled_energy_buffer = power_buffer_report();
-    _prev_unscaled_energy_crossbar = power_crossbar_report();
-    _prev_unscaled_energy_arbiter = power_arbiter_report();
-    _prev_unscaled_energy_link = power_link_report();
-    _prev_unscaled_energy_clock = power_clock_report();
+    // the activity of each level priced by the Orion models of its Vdd
+    // and freq.; activity is kept since the start, so this is the total
+    // energy so far, not a delta;
+    _scaled_energy_buffer = 0.0;
+    _scaled_energy_crossbar = 0.0;
+    _scaled_energy_arbiter = 0.0;
+    _scaled_energy_link = 0.0;
+    _scaled_energy_clock = 0.0;
+    for ( long l = 0; l < DVFS_LEVELS_COUNT; l++) {
+        const POWER_MODEL *model = _models[ l];
+        _scaled_energy_buffer += model->buffer_energy( _activities[ l]);
+        _scaled_energy_crossbar += model->crossbar_energy( _activities[ l]);
+        _scaled_energy_arbiter += model->arbiter_energy( _activities[ l]);
+        _scaled_energy_link += model->link_energy( _activities[ l]);
+        _scaled_energy_clock += model->clock_energy( _activities[ l]);
+    }
+    _scaled_energy = _scaled_energy_buffer + _scaled_energy_crossbar +
+        _scaled_energy_arbiter + _scaled_energy_link + _scaled_energy_clock;
 }
 
 
@@ -1004,20 +1245,20 @@ void POWER_MODULE::scale_and_accumulate_energy()
 ////////////////////////////////////////////////////////////////////////////////
 
 VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
-    _gen_4_poisson_level1(),
-    _poisson_level1( 600), // mean of 600 cycles; TODO: make it a parameter;
-    _rvt_level1(_gen_4_poisson_level1, _poisson_level1),
     // Generator is to aggregate traffic from 128 sources and to generate
     // the load of "injection_rate" on a link with rate that
     // I "cooked" to 8.0E-6 such that inside the vnoc_pareto.h to have
     // a ByteTime of 1, which is my simulation cycle;
     //_gen_pareto_level2(8.0E-6, topology->injection_rate(), 128),
-    _routers(),
-    _traffic_injectors(),
+    _verbose(verbose),
     _total_packets_injected_count(0),
     _packets_arrived_count_after_wu(0),
     _input_file_st(),
-    _verbose(verbose)
+    _traffic_injectors(),
+    _flit_pool(),
+    _network(),
+    _power_models(),
+    _routers()
 {
     _topology = topology; // get topology first, 'coz lots of things depend on it;
     _event_queue = event_queue;
@@ -1027,26 +1268,21 @@ VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
     _power = 0.0;
     _packets_per_cycle = 0.0;
     _warmup_done = false; // will be set true after warmup cycles;
+    _dormant_routers_allowed = _topology->dormant_routers();
 
-    // set seed of generator for poisson distr;
-    _gen_4_poisson_level1.seed( _topology->rng_seed()); // time(NULL)
-
-    long ary_size = _topology->ary_size(); // "network size" in one dimension;
-    long cube_size = _topology->cube_size();
     long vc_number = _topology->virtual_channel_number();
     long buffer_size = _topology->input_buffer_size();
     long output_buffer_size = _topology->output_buffer_size();
     long flit_size = _topology->flit_size();
     double injection_rate = _topology->injection_rate(); // packet generation rate;
 
-    // + 1 means, one for injection;
-    long phy_ports_t = cube_size * 2 + 1;
-    _routers_count = ary_size;
-    for ( long i = 0; i < cube_size - 1; i++) {
-        _routers_count = _routers_count * ary_size;
-    }
+    // () compile the topology: neighbors of all routers and the routes
+    // of the routing algo; routers use them from now on;
+    _network.compile( _topology);
+    _routers_count = _network.routers_count();
     // set also _nx and _ny;
-    _nx = _ny = ary_size; // working with 2D meshes only;
+    _nx = _topology->nx();
+    _ny = _topology->ny();
 
 
     // Note: this is the way routers are indexed for a 4x4 NoC:
@@ -1064,24 +1300,25 @@ VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
     // () create all routers;
     // create also all traffic injectors and hook them up at the same time
     // to their individual router;
-    // Note: we work only with 2D regular mesh networks for
-    // the time being; so, address has only 2 ints;
-    ADDRESS add_t;
-    add_t.resize( cube_size, 0);
+    // Note: addresses have 2 ints in 2D and 3 in 3D (the last one is z);
+    // routers of a topology file get addresses too, but they are not used;
     for ( long i = 0; i < _routers_count; i++) {
         _routers.push_back( // add this router;
-            ROUTER(phy_ports_t, vc_number, buffer_size,
-                output_buffer_size, add_t, ary_size, flit_size, // add_t is (0,0) for i=0;
+            // + 1 port for injection, i.e., cube_size * 2 + 1 in the mesh;
+            ROUTER(_network.router_ports_count( i), vc_number, buffer_size,
+                output_buffer_size, _topology->router_address( i), flit_size,
                 this, i, _topology->link_length(),
                 _topology->predictor_type()) );
+    }
 
-
-        // compute the address of the router will be inserted in next iteration;
-        add_t[cube_size - 1]++;
-        for ( long j = cube_size - 1; j > 0; j--) {
-            if ( add_t[j] == ary_size) {
-                add_t[j] = 0;
-                add_t[j-1]++;
+    // () connect the links between neighbor routers; ports without a
+    // neighbor (e.g., at the edges of the mesh) have no link;
+    for ( long i = 0; i < _routers_count; i++) {
+        for ( long p = 1; p < _network.router_ports_count( i); p++) {
+            long neighbor_id = _network.neighbor_router( i, p);
+            if ( neighbor_id >= 0) {
+                _routers[i].connect_to_neighbor( p, &_routers[neighbor_id],
+                    _network.neighbor_port( i, p));
             }
         }
     }
@@ -1089,11 +1326,12 @@ VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
 
     // () create the traffic injectors and hook'em up to routers;
     for ( long i = 0; i < _routers_count; i++) {
-        // id = x * ny + y because of the way routers are indexed in the 2D mesh;
+        // x and y are used by the transpose traffics, which are 2D only;
+        ADDRESS a = _topology->router_address( i);
         _traffic_injectors.push_back(
             TRAFFIC_INJECTOR( i,
-                (i / ary_size), // x; assume just 2D mesh;
-                (i % ary_size), // y; assume just 2D mesh;
+                a[0], // x;
+                a[1], // y;
                 _traffic_type, 
                 injection_rate,
                 _topology->rng_seed(),
@@ -1126,7 +1364,7 @@ VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
         // (at the beginning of VNOC::receive_EVENT_PE());
         // in this case the first packet injected may be a bit later than 0.0,
         // we read it from the tracefile;
-        _event_queue->add_event( EVENT(EVENT::PE, event_time_t));
+        _event_queue->add_event( EVENT(EVENT::PE, cycles_to_ticks( event_time_t)));
     }
     else if ( _traffic_type == IPCORE_TRAFFIC) {
 
@@ -1136,7 +1374,7 @@ VNOC::VNOC( TOPOLOGY *topology, EVENT_QUEUE *event_queue, bool verbose) :
         // traffic injectors hooked to each router); which will kick of the simulation 
         // and insertion of additional events PE later on; we start all
         // simulations at time 0.0;
-        _event_queue->add_event( EVENT(EVENT::PE, 0.0));
+        _event_queue->add_event( EVENT(EVENT::PE, 0));
 
         // selfsimilar traffic requires additional initializations;
         // select randomly about 1/4 of all routers to operate as sources;
@@ -1194,26 +1432,12 @@ void VNOC::select_randomly_sources_for_selfsimilar_traffic()
 
 ROUTER & VNOC::router( const ADDRESS &a)
 {
-    // Note: this works because .end() positions 
-    // the pointer immediately after the last item;
-    ADDRESS::const_iterator first = a.begin(); // x;
-    ADDRESS::const_iterator last = a.end(); // y;
-    long i = (* first); first++;
-    for (; first != last; first++) {
-        i = i * _topology->ary_size() + (*first); // id = x * ny + y 
-    }
-    return ( _routers[i]);
+    return ( _routers[ _topology->router_id( a)]);
 }
 
 const ROUTER & VNOC::router( const ADDRESS &a) const
 {
-    ADDRESS::const_iterator first = a.begin();
-    ADDRESS::const_iterator last = a.end();
-    long i = (* first); first++;
-    for (; first != last; first++) {
-        i = i * _topology->ary_size() + (*first);
-    }
-    return ( _routers[i]);
+    return ( _routers[ _topology->router_id( a)]);
 }
 
 bool VNOC::check_address(const ADDRESS &a) const 
@@ -1223,26 +1447,53 @@ bool VNOC::check_address(const ADDRESS &a) const
         return false;
     }
     for ( long i = 0; i < a.size(); i++) {
-        if ((a[i] >= _topology->ary_size()) || (a[i] < 0)) {
+        if ((a[i] >= _topology->dimension_size( i)) || (a[i] < 0)) {
             return false;
         }
     }
     return true;
 }
 
+vector<const POWER_MODEL *> VNOC::power_models( long physical_ports_count,
+    long vc_count, double link_length, int arbiter_model)
+{
+    // Orion init is done once per configuration and operating point;
+    // all routers of a mesh or torus have the same ports (the unused ones
+    // of border routers included), so there is one model per DVFS level;
+    // routers of a topology file may differ in ports count; called only
+    // while routers are created, before any thread starts; map elements
+    // do not move, so routers can keep the pointers; without dvfs only the
+    // base level is used, but its models are still made, so that reports
+    // are the same;
+    vector<const POWER_MODEL *> models;
+    for ( long l = 0; l < DVFS_LEVELS_COUNT; l++) {
+        double vdd = _topology->dvfs_vdd( DVFS_LEVEL(l));
+        double freq = _topology->dvfs_freq( DVFS_LEVEL(l)) * 1e9;
+        POWER_MODEL_KEY key( physical_ports_count, vc_count, link_length,
+            arbiter_model, vdd, freq);
+        map<POWER_MODEL_KEY, POWER_MODEL>::iterator it = _power_models.find( key);
+        if ( it == _power_models.end()) {
+            it = _power_models.insert( make_pair( key, POWER_MODEL( physical_ports_count,
+                vc_count, link_length, arbiter_model, vdd, freq,
+                _topology))).first;
+        }
+        models.push_back( &( it->second));
+    }
+    return models;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // processing of events from the simulation-queue
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-bool VNOC::receive_EVENT_PE( EVENT this_event)
+bool VNOC::receive_EVENT_PE( const EVENT &this_event)
 {
 
     ADDRESS src_addr_t;
     ADDRESS des_addr_t;
     long pack_size_t;
-    long ary_size = _topology->ary_size();
     long cube_size = _topology->cube_size();
     long num_packets_inj_here = 0;
 
@@ -1259,13 +1510,13 @@ bool VNOC::receive_EVENT_PE( EVENT this_event)
             assert( !_input_file_st.eof());
             src_addr_t.push_back(t);
         }
-        assert( src_addr_t[0] < ary_size && src_addr_t[1] < ary_size);
+        assert( check_address( src_addr_t));
         for ( long i = 0; i < cube_size; i++) {
             long t; _input_file_st >> t;
             assert( !_input_file_st.eof());
             des_addr_t.push_back(t);
         }
-        assert( des_addr_t[0] < ary_size && des_addr_t[1] < ary_size);
+        assert( check_address( des_addr_t));
         _input_file_st >> pack_size_t;
         assert( !_input_file_st.eof());
 
@@ -1296,7 +1547,7 @@ bool VNOC::receive_EVENT_PE( EVENT this_event)
             if ( !_input_file_st.eof()) {
                 // here we keep adding PE events until no more packets are 
                 // in trace files that need be injected;
-                _event_queue->add_event( EVENT(EVENT::PE, event_time_t));
+                _event_queue->add_event( EVENT(EVENT::PE, cycles_to_ticks( event_time_t)));
             }
         }
     }
@@ -1328,31 +1579,36 @@ bool VNOC::receive_EVENT_PE( EVENT this_event)
         // period irrespective of what the DVFS settinsg of routers inside the network
         // are; that is because I want the application to stay the same and see
         // how the NoC behaves when some of its routers and links are throttled;
-        double delay = PIPE_DELAY_BASE; // should be clock delay;
+        SIM_TIME delay = PIPE_DELAY_BASE; // should be clock delay;
         _event_queue->add_event( EVENT(EVENT::PE, this_event.start_time() + delay));
     }   
     
+    return true;
 }
 
 
-void VNOC::receive_EVENT_SYNC_PREDICT_DVFS_SET( EVENT this_event)
+void VNOC::receive_EVENT_SYNC_PREDICT_DVFS_SET( const EVENT &this_event)
 {
     // perform prediction and possibly change the its dvfs settings
     // for each router; this is the second part (the first part was
     // the maintainance or bookeeping);
 
+    // dormant routers must first do the bookeeping of the cycles
+    // skipped so far;
+    catch_up_dormant_routers();
+
     for ( long i = 0; i < _routers_count; i++) {
         _routers[ i].perform_prediction_SYNC();
     }
 
     // add new SYNC_PREDICT_DVFS_SET event; will do the same
     // in "history_window" base cycles;
-    double delay = double(_topology->history_window());
+    SIM_TIME delay = _topology->history_window() * TICKS_PER_CYCLE;
     _event_queue->add_event( EVENT(EVENT::SYNC_PREDICT_DVFS_SET,
         this_event.start_time() + delay));
 }
 
-void VNOC::receive_EVENT_ROUTER_SINGLE( EVENT this_event)
+void VNOC::receive_EVENT_ROUTER_SINGLE( const EVENT &this_event)
 {
     // it's the one used currrently!
     // a modified version of VNOC::receive_EVENT_ROUTER() to be able to use
@@ -1364,6 +1620,38 @@ void VNOC::receive_EVENT_ROUTER_SINGLE( EVENT this_event)
     //printf(" %d", router_id);
 
     DVFS_LEVEL this_dvfs_level_prev = _routers[ router_id].dvfs_level_prev();
+    SIM_TIME delay = simulate_router_cycle( router_id);
+
+    // a router with nothing to do is not simulated anymore until a flit
+    // is sent to it or a packet from its PE arrives; clock energy is recorded 
+    // only after warmup, so that's when routers can go dormant;
+    if ( _warmup_done && _dormant_routers_allowed &&
+         _routers[ router_id].is_quiescent()) {
+        _routers[ router_id].go_dormant( this_event.start_time(),
+            this_event.start_time() + delay);
+        return;
+    }
+
+    // routers stepped by clock domains; a router that stays at its level
+    // goes back to a domain (see CLOCK_DOMAIN);
+    if ( _topology->clock_domain_stepping() &&
+         _routers[ router_id].dvfs_level() == this_dvfs_level_prev) {
+        move_router_to_clock_domain( router_id, this_event.start_time() + delay);
+        return;
+    }
+
+    // add event for this router's simulation next time;
+    _routers[ router_id].event_queue()->add_event( EVENT(EVENT::ROUTER_SINGLE,
+        this_event.start_time() + delay, router_id));
+}
+
+
+SIM_TIME VNOC::simulate_router_cycle( long router_id)
+{
+    // one clock cycle of a router; returns the time till its next cycle;
+    // called by receive_EVENT_ROUTER_SINGLE() and directly by the 
+    // cycle-driven engine;
+    DVFS_LEVEL this_dvfs_level_prev = _routers[ router_id].dvfs_level_prev();
 
     
     _routers[ router_id].simulate_one_router(); // possibly sets new dvfs;
@@ -1376,129 +1664,159 @@ void VNOC::receive_EVENT_ROUTER_SINGLE( EVENT this_event)
 
     _routers[ router_id].set_dvfs_level_prev(_routers[ router_id].dvfs_level());
 
+    return _routers[ router_id].clock_period( this_dvfs_level_prev);
+}
 
-    double delay = 0.0;
-    if ( this_dvfs_level_prev == DVFS_BOOST) {
-        delay = PIPE_DELAY_BOOST;
-    }
-    if ( this_dvfs_level_prev == DVFS_BASE) {
-        delay = PIPE_DELAY_BASE;
-    }
-    if ( this_dvfs_level_prev == DVFS_THROTTLE_1) {
-        delay = PIPE_DELAY_THROTTLE_1;
-    }
-    if ( this_dvfs_level_prev == DVFS_THROTTLE_2) {
-        delay = PIPE_DELAY_THROTTLE_2;
+void VNOC::catch_up_dormant_routers()
+{
+    // bring all dormant routers up to date with the current event; 
+    // must be called before looking at their clock energy or dvfs predictor;
+    for ( long i = 0; i < _routers_count; i++) {
+        if ( _routers[ i].dormant()) {
+            _routers[ i].catch_up_dormant_cycles( 
+                _event_queue->current_event_key());
+        }
     }
-
-    // add event for this router's simulation next time;
-    _event_queue->add_event( EVENT(EVENT::ROUTER_SINGLE,
-        this_event.start_time() + delay, router_id));
 }
 
-
-bool VNOC::receive_EVENT_ROUTER( EVENT this_event)
+void VNOC::disable_dormant_routers()
 {
-    // not used currently!
-    // this is the function called when the simulation-queue
-    // got extracted and it's the turn of processing all routers
-    // for simulation purposes; so that data is pushed thru;
-    
-    DVFS_LEVEL this_dvfs_level_prev;
-    bool there_are_routers_at_boost = false;
-    bool there_are_routers_at_base = false;
-    bool there_are_routers_at_throttle_1 = false; 
-    bool there_are_routers_at_throttle_2 = false;
+    // wake up all dormant routers and keep them awake from now on;
+    // used at the end of simulation, so that the last cycles are
+    // simulated as usual;
+    _dormant_routers_allowed = false;
     for ( long i = 0; i < _routers_count; i++) {
-        this_dvfs_level_prev = _routers[i].dvfs_level_prev();
-
-        // this router must be processed only if its DVFS settings
-        // are in agreement with the type of ROUTER event; in this way
-        // I achieve the trick of simulating in the case of say
-        // EVENT::ROUTER_THROTTLE_1 only the routers that have that
-        // VDD and freq. of THROTTLE_1 case;
-        if ( this_event.type() == EVENT::ROUTER_BOOST && this_dvfs_level_prev != DVFS_BOOST) continue;
-        if ( this_event.type() == EVENT::ROUTER && this_dvfs_level_prev != DVFS_BASE) continue;
-        if ( this_event.type() == EVENT::ROUTER_THROTTLE_1 && this_dvfs_level_prev != DVFS_THROTTLE_1) continue;
-        if ( this_event.type() == EVENT::ROUTER_THROTTLE_2 && this_dvfs_level_prev != DVFS_THROTTLE_2) continue;
-
-        // this will add events of type: CREDIT (when flit is consumed or
-        // moved from input buffer to output buffer), LINK (when flit is 
-        // taken from output buffer and sent to downstream router via link);
-        // Note: processing of router can result in having its DVFS
-        // settings changed!
-        _routers[i].simulate_one_router(); // including power;
-
-        // record this "simulation cycle" of this router for the purpose
-        // of estimating clock energy consumption;
-        if ( _warmup_done) {
-            _routers[i].power_module().power_clock_record();
+        if ( _routers[ i].dormant()) {
+            _routers[ i].wake_up();
         }
-        
-        // do the trick for dvfs; after a dvfs change one more cycle
-        // was simulated to old/prev frequency; this makes sure flits 
-        // go in-order on links;
-        _routers[i].set_dvfs_level_prev( _routers[i].dvfs_level());
-        
-        // see if after processing this router has any of the three
-        // DVFS settings; if so record it for to know later to insert 
-        // the appropriate ROUTER event;
-        if (_routers[i].dvfs_level() == DVFS_BOOST) {
-            there_are_routers_at_boost = true;
-        } 
-        if (_routers[i].dvfs_level() == DVFS_BASE) {
-            there_are_routers_at_base = true;
-        } 
-        if (_routers[i].dvfs_level() == DVFS_THROTTLE_1) {
-            there_are_routers_at_throttle_1 = true;    
-        } 
-        if (_routers[i].dvfs_level() == DVFS_THROTTLE_2) {
-            there_are_routers_at_throttle_2 = true;    
-        }         
     }
+}
 
-    // add new ROUTER event, which will trigger resimulation of all routers
-    // after pipe delay later;
-    double delay = 0.0;
-    if ( there_are_routers_at_boost) {
-        delay = PIPE_DELAY_BOOST;
-        _event_queue->add_event( EVENT(EVENT::ROUTER_BOOST, this_event.start_time() + delay));
+bool VNOC::receive_EVENT_ROUTER( const EVENT &this_event)
+{
+    // clock-domain engine; this is the function called when the 
+    // simulation-queue got extracted and it's the turn of processing all
+    // routers of one clock domain (of the dvfs level of the type of ROUTER
+    // event); so that data is pushed thru;
+    DVFS_LEVEL level = DVFS_BASE;
+    if ( this_event.type() == EVENT::ROUTER_BOOST) {
+        level = DVFS_BOOST;
+    } else if ( this_event.type() == EVENT::ROUTER_THROTTLE_1) {
+        level = DVFS_THROTTLE_1;
+    } else if ( this_event.type() == EVENT::ROUTER_THROTTLE_2) {
+        level = DVFS_THROTTLE_2;
     }
-    if ( there_are_routers_at_base) {
-        delay = PIPE_DELAY_BASE;
-        _event_queue->add_event( EVENT(EVENT::ROUTER, this_event.start_time() + delay));
+    SIM_TIME current_time = this_event.start_time();
+    CLOCK_DOMAIN &domain = clock_domain( level, current_time);
+    assert( domain._scheduled);
+
+    // () routers that joined for this cycle become members;
+    long k = 0;
+    while ( k < long(domain._joining.size())) {
+        if ( domain._joining[k].second == current_time) {
+            long router_id = domain._joining[k].first;
+            domain._members.insert( lower_bound( domain._members.begin(),
+                domain._members.end(), router_id), router_id);
+            domain._joining[k] = domain._joining.back();
+            domain._joining.pop_back();
+        } else {
+            k ++;
+        }
     }
-    // Note: initially I had the next two gated by "if ( _warmup_done) {"
-    // assuming that throttling was done only after warmup; removed it;
-    if ( there_are_routers_at_throttle_1) {
-        delay = PIPE_DELAY_THROTTLE_1;
-        _event_queue->add_event( EVENT(EVENT::ROUTER_THROTTLE_1, this_event.start_time() + delay));
+
+    // () simulate all members; this will add credits (when flit is
+    // consumed or moved from input buffer to output buffer) and flits 
+    // (when flit is taken from output buffer and sent to downstream router)
+    // to links;
+    // each router has the key its ROUTER_SINGLE event would have had; 
+    // it leaves the domain if it goes dormant or its DVFS settings 
+    // changed; the latter does its next cycle at the frequency of this
+    // domain, with its own ROUTER_SINGLE event;
+    long members_kept = 0;
+    for ( k = 0; k < long(domain._members.size()); k++) {
+        long router_id = domain._members[k];
+        EVENT_KEY router_key( current_time, 
+            ( current_time == 0) ? 0 : current_time - domain._period,
+            ( current_time == 0) ? -1 : router_id);
+        if ( _event_queue->start_router_cycle( router_key, router_id) == false) {
+            return false;
+        }
+        assert( _routers[ router_id].dvfs_level_prev() == level);
+        SIM_TIME delay = simulate_router_cycle( router_id);
+        assert( delay == domain._period);
+        if ( _warmup_done && _dormant_routers_allowed &&
+             _routers[ router_id].is_quiescent()) {
+            _routers[ router_id].go_dormant( current_time, current_time + delay);
+        } else if ( _routers[ router_id].dvfs_level() == level) {
+            domain._members[ members_kept] = router_id;
+            members_kept ++;
+        } else {
+            _event_queue->add_event( EVENT(EVENT::ROUTER_SINGLE,
+                current_time + delay, router_id));
+        }
+    }
+    domain._members.resize( members_kept);
+
+    // () add new ROUTER event for the next cycle of this domain, unless 
+    // no router is left in it; it's issued by no router, so that it comes
+    // before the events its routers issued for that time;
+    if ( domain.empty()) {
+        domain._scheduled = false;
+    } else {
+        EVENT domain_event( this_event.type(), current_time + domain._period);
+        domain_event.set_issued( current_time, -1);
+        _event_queue->add_issued_event( domain_event);
     }
-    if ( there_are_routers_at_throttle_2) {
-        delay = PIPE_DELAY_THROTTLE_2;
-        _event_queue->add_event( EVENT(EVENT::ROUTER_THROTTLE_2, this_event.start_time() + delay));
+    return true;
+}
+
+CLOCK_DOMAIN &VNOC::clock_domain( DVFS_LEVEL level, SIM_TIME time)
+{
+    // the domain of the level with a cycle at time; made if needed;
+    SIM_TIME period = _topology->dvfs_clock_period( level);
+    pair<long, SIM_TIME> key( level, time % period);
+    map<pair<long, SIM_TIME>, CLOCK_DOMAIN>::iterator it = 
+        _clock_domains.find( key);
+    if ( it == _clock_domains.end()) {
+        it = _clock_domains.insert( make_pair( key, 
+            CLOCK_DOMAIN( level, period, time % period))).first;
     }
+    return it->second;
 }
 
-bool VNOC::receive_EVENT_LINK( EVENT this_event)
+void VNOC::move_router_to_clock_domain( long router_id, SIM_TIME first_time)
 {
-    //ADDRESS des_t = this_event.des_addr();
-    long router_id = this_event.to_router_id();
-    long pc_t = this_event.pc(); // port count or port id;
-    long vc_t = this_event.vc(); // vc count or vc index;
-    FLIT &flit = this_event.flit();
-    //router(des_t).receive_flit_from_upstream(pc_t, vc_t, flit);
-    _routers[router_id].receive_flit_from_upstream(pc_t, vc_t, flit);
+    // the router joins the domain of its current level that has a cycle
+    // at first_time, i.e., its next cycle; an idle domain starts then;
+    CLOCK_DOMAIN &domain = clock_domain( _routers[ router_id].dvfs_level(),
+        first_time);
+    domain._joining.push_back( pair<long, SIM_TIME>( router_id, first_time));
+    if ( !domain._scheduled) {
+        EVENT::EVENT_TYPE type = EVENT::ROUTER;
+        if ( domain._level == DVFS_BOOST) {
+            type = EVENT::ROUTER_BOOST;
+        } else if ( domain._level == DVFS_THROTTLE_1) {
+            type = EVENT::ROUTER_THROTTLE_1;
+        } else if ( domain._level == DVFS_THROTTLE_2) {
+            type = EVENT::ROUTER_THROTTLE_2;
+        }
+        // issued by no router, like the events of the other cycles;
+        EVENT domain_event( type, first_time);
+        domain_event.set_issued( 
+            ( first_time == 0) ? 0 : first_time - domain._period, -1);
+        _event_queue->add_issued_event( domain_event);
+        domain._scheduled = true;
+    }
 }
 
-bool VNOC::receive_EVENT_CREDIT( EVENT this_event)
+void VNOC::insert_clock_domain_events()
 {
-    //ADDRESS des_t = this_event.des_addr();
-    long router_id = this_event.to_router_id();
-    long pc_t = this_event.pc();
-    long vc_t = this_event.vc();
-    // router(des_t).receive_credit(pc_t, vc_t);
-    _routers[router_id].receive_credit(pc_t, vc_t);
+    // all routers start in the domain of their level, with their first 
+    // cycle at time 0;
+    _clock_domains.clear();
+    for ( long i = 0; i < _routers_count; i++) {
+        move_router_to_clock_domain( i, 0);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1588,7 +1906,7 @@ void VNOC::update_and_print_simulation_results( bool verbose)
     // total time elapsed since after the warmup was done;
     // note that we recorded events thru the power module only
     // after the warmup was done;
-    double delta_time = _event_queue->current_sim_time() - 
+    double delta_time = _event_queue->current_sim_cycles() - 
         _topology->warmup_cycles_count();
     // compute power averages here from the energy data;
     total_power = 
@@ -1741,7 +2059,8 @@ long TRAFFIC_INJECTOR::inject_selsimilar_traffic_or_update_task_duration(void)
 
     // () then, if this is a src, we check to see if we are during or inside 
     // "task duration";
-    double current_sim_time = _vnoc->event_queue()->current_sim_time();
+    // task and injection times are in cycles, as made by the generators;
+    double current_sim_time = _vnoc->event_queue()->current_sim_cycles();
     if ( current_sim_time >= _task_start_time &&
         current_sim_time <= _task_stop_time) {
         // if we are during a task-duration for this source, then 
@@ -1778,12 +2097,12 @@ long TRAFFIC_INJECTOR::inject_selsimilar_traffic_or_update_task_duration(void)
             //printf("\n (%f) _prev_num_injected_packets: %d", 
             //    _prev_injection_time, _prev_num_injected_packets);
             
-            if ( drand48() < _injection_rate) { // mimic Poisson arrival
+            if ( _rng.flat_d(0.0, 1.0) < _injection_rate) { // mimic Poisson arrival
 
                 // first pick randomly a destination different from itself;
-                dest_id = _vnoc->get_a_router_id_randomly();
+                dest_id = _vnoc->get_a_router_id_randomly( _rng);
                 while ( dest_id == _id) {
-                    dest_id = _vnoc->get_a_router_id_randomly();
+                    dest_id = _vnoc->get_a_router_id_randomly( _rng);
                 }
                 bool injected_a_packet_here = false;
                 for (long i = 0; i < _prev_num_injected_packets; i++) {
@@ -1816,16 +2135,14 @@ long TRAFFIC_INJECTOR::inject_selsimilar_traffic_or_update_task_duration(void)
             // and, we should generate here new start,stop times for the next
             // task-duration;
 
-            // Note: _poisson_distr_level1 is initialized so that it generates
-            // samples form Poisson distr. with mean 600 cycles; this initialization is
-            // done in the constructor of VNOC;
+            // Note: samples are from a Poisson distr. with mean 600 cycles;
             _task_start_time = current_sim_time + 
-                double( _vnoc->generate_new_task_start_time_from_poisson());
+                double( _vnoc->generate_new_task_start_time_from_poisson( _rng));
 
             // the stop time is generated as a random number between 600-2000;
             // TODO: make 600-2000 as parameters;
             _task_stop_time = _task_start_time + 
-                double(_vnoc->topology()->rng().flat_l(600, 2000));
+                double(_rng.flat_l(600, 2000));
 
             //printf("\n (%d) _task_start_time: %f _task_stop_time: %f", _id,
             //    _task_start_time, _task_stop_time);
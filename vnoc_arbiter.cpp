@@ -0,0 +1,82 @@
+#include "vnoc_arbiter.h"
+#include <assert.h>
+
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// ARBITER
+//
+////////////////////////////////////////////////////////////////////////////////
+
+ARBITER::ARBITER( ARBITER_TYPE type, long size) :
+    _type(type),
+    _size(size),
+    _rng(),
+    _pointer(0),
+    _beaten_by()
+{
+    if ( _type == MATRIX_ARB) {
+        // initially, lower index requesters have priority over
+        // higher index ones;
+        _beaten_by.resize( _size, BIT_VECTOR( _size));
+        for ( long a = 0; a < _size; a++) {
+            for ( long b = 0; b < a; b++) {
+                _beaten_by[a].set(b);
+            }
+        }
+    }
+}
+
+long ARBITER::arbitrate( const BIT_VECTOR &requests)
+{
+    assert( requests.size() == _size);
+
+    if ( _type == RANDOM_ARB) {
+        // Note: the rng is called only if there is more than one request;
+        long requests_count = requests.count();
+        if ( requests_count == 0) {
+            return -1;
+        } else if ( requests_count == 1) {
+            return requests.find_first();
+        }
+        return requests.find_nth( _rng.flat_l(0, requests_count));
+    }
+    else if ( _type == ROUND_ROBIN_ARB) {
+        long winner = requests.find_from( _pointer);
+        if ( winner < 0) {
+            winner = requests.find_first(); // wrap around;
+        }
+        return winner;
+    }
+    else { // MATRIX_ARB
+        // the winner is the requester that is not beaten by any other
+        // requester; there is exactly one as priorities form a total order;
+        for ( long a = requests.find_first(); a >= 0; a = requests.find_next(a)) {
+            if ( !_beaten_by[a].intersects( requests)) {
+                return a;
+            }
+        }
+        return -1;
+    }
+}
+
+void ARBITER::update( long winner)
+{
+    assert( winner >= 0 && winner < _size);
+
+    if ( _type == ROUND_ROBIN_ARB) {
+        _pointer = (winner + 1 < _size) ? winner + 1 : 0;
+    }
+    else if ( _type == MATRIX_ARB) {
+        // winner gets the lowest priority: everybody else beats it and
+        // it does not beat anybody anymore;
+        for ( long b = 0; b < _size; b++) {
+            if ( b != winner) {
+                _beaten_by[winner].set(b);
+                _beaten_by[b].reset(winner);
+            }
+        }
+    }
+}
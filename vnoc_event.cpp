@@ -1,42 +1,178 @@
 #include "vnoc_event.h"
 #include "vnoc_gui.h"
+#include "vnoc_pdes.h"
 #include <assert.h>
+#include <float.h>
+#include <limits.h>
+#include <algorithm>
 
 
 using namespace std;
 
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// CALENDAR_QUEUE
+//
+////////////////////////////////////////////////////////////////////////////////
+
+CALENDAR_QUEUE::CALENDAR_QUEUE() :
+    _pool(),
+    _free_indices(),
+    _buckets( CALENDAR_BUCKETS_COUNT),
+    _overflow(),
+    _base_slot(0),
+    _wheel_events_count(0),
+    _seq(0)
+{
+}
+
+void CALENDAR_QUEUE::push( const EVENT &event)
+{
+    // (1) store the event itself into the pool; reuse a free slot if any;
+    long index = 0;
+    if ( _free_indices.empty()) {
+        index = _pool.size();
+        _pool.push_back( event);
+    } else {
+        index = _free_indices.back();
+        _free_indices.pop_back();
+        _pool[ index] = event;
+    }
+    CALENDAR_ENTRY entry( event.key(), _seq, index);
+    _seq ++;
+
+    // (2) place its entry into the wheel or into the overflow heap;
+    long long slot = slot_of( event.start_time());
+    if ( slot < _base_slot) {
+        // should not happen, as events are never scheduled in the past;
+        // but if it does, the base bucket still keeps them ordered;
+        slot = _base_slot;
+    }
+    if ( slot < _base_slot + CALENDAR_BUCKETS_COUNT) {
+        insert_into_wheel( slot, entry);
+    } else {
+        _overflow.push_back( entry);
+        push_heap( _overflow.begin(), _overflow.end(), 
+            greater<CALENDAR_ENTRY>());
+    }
+}
+
+const EVENT &CALENDAR_QUEUE::top()
+{
+    assert( size() > 0);
+    advance_to_first_event();
+    return _pool[ bucket_of( _base_slot).front()._index];
+}
+
+void CALENDAR_QUEUE::pop()
+{
+    assert( size() > 0);
+    advance_to_first_event();
+    vector<CALENDAR_ENTRY> &bucket = bucket_of( _base_slot);
+    _free_indices.push_back( bucket.front()._index);
+    pop_heap( bucket.begin(), bucket.end(), greater<CALENDAR_ENTRY>());
+    bucket.pop_back();
+    _wheel_events_count --;
+}
+
+void CALENDAR_QUEUE::insert_into_wheel( long long slot, 
+    const CALENDAR_ENTRY &entry)
+{
+    vector<CALENDAR_ENTRY> &bucket = bucket_of( slot);
+    bucket.push_back( entry);
+    push_heap( bucket.begin(), bucket.end(), greater<CALENDAR_ENTRY>());
+    _wheel_events_count ++;
+}
+
+void CALENDAR_QUEUE::advance_to_first_event()
+{
+    // move the base of the wheel forward until it points to the bucket
+    // that holds the earliest event; if the wheel is empty, jump directly
+    // to the slot of the earliest overflow event; every time the base moves,
+    // overflow events that are now inside the horizon go into the wheel;
+    while ( bucket_of( _base_slot).empty()) {
+        if ( _wheel_events_count == 0) {
+            assert( !_overflow.empty());
+            _base_slot = slot_of( _overflow.front()._key._start_time);
+        } else {
+            _base_slot ++;
+        }
+        while ( !_overflow.empty() && slot_of( _overflow.front()._key._start_time) <
+            _base_slot + CALENDAR_BUCKETS_COUNT) {
+            insert_into_wheel( slot_of( _overflow.front()._key._start_time), 
+                _overflow.front());
+            pop_heap( _overflow.begin(), _overflow.end(), 
+                greater<CALENDAR_ENTRY>());
+            _overflow.pop_back();
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // EVENT_QUEUE
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-EVENT_QUEUE::EVENT_QUEUE(double start_time, TOPOLOGY *topology) :
-    _event_count(0), 
-    _events()
+EVENT_QUEUE::EVENT_QUEUE(SIM_TIME start_time, TOPOLOGY *topology) :
+    _events(),
+    _calendar(),
+    _current_cycle(0),
+    _report_at_time(0),
+    _current_event_key( start_time, start_time, -1),
+    _current_origin(-1),
+    _event_count(0),
+    _queue_events_simulated(0),
+    _stop_requested(false),
+    _pdes_engine(0),
+    _cycle_engine(0)
 {
     _current_sim_time = start_time;
     _topology = topology;
+    _simulation_end_time = cycles_to_ticks( _topology->simulation_cycles_count());
+    _warmup_end_time = cycles_to_ticks( _topology->warmup_cycles_count());
+    _queue_type = _topology->event_queue_type();
+    _engine = _topology->simulation_engine();
+}
+
+EVENT_QUEUE::~EVENT_QUEUE()
+{
+    delete _pdes_engine;
+    delete _cycle_engine;
 }
 
 void EVENT_QUEUE::insert_initial_events()
 {
     // call only after vnoc object has been set;
-    for ( long i = 0; i < _vnoc->routers_count(); i++) {
-        add_event( EVENT(EVENT::ROUTER_SINGLE, 0.0, i));
+    // the cycle-driven engine simulates routers without events;
+    // the PDES engine puts them into the queues of their tiles;
+    if ( _engine == PARALLEL_ENGINE) {
+        _pdes_engine = new PDES_ENGINE( _vnoc);
+    }
+    if ( _engine == CYCLE_DRIVEN_ENGINE && _topology->threads_count() > 1) {
+        _cycle_engine = new PARALLEL_CYCLE_ENGINE( _vnoc);
+    }
+    if ( _topology->clock_domain_stepping()) {
+        _vnoc->insert_clock_domain_events();
+    } else if ( _engine != CYCLE_DRIVEN_ENGINE) {
+        for ( long i = 0; i < _vnoc->routers_count(); i++) {
+            _vnoc->router( i)->event_queue()->add_event( 
+                EVENT(EVENT::ROUTER_SINGLE, 0, i));
+        }
     }
     if ( _vnoc->topology()->dvfs_mode() == SYNC) {
+        // one tick after the routers' cycle, as it needs their bookkeeping;
         add_event( EVENT(EVENT::SYNC_PREDICT_DVFS_SET,
-            double(_vnoc->topology()->history_window()) + 0.001));
+            _vnoc->topology()->history_window() * TICKS_PER_CYCLE + 1));
     }
     
 }
 
 bool EVENT_QUEUE::run_simulation() 
 {
-    double report_at_time = 0;
     char msg[BUFFER_SIZE];
+    _report_at_time = 0;
     _queue_events_simulated = 0; // reset counter;
 
     if ( _topology->use_gui()) {
@@ -56,115 +192,438 @@ bool EVENT_QUEUE::run_simulation()
     // if all routers are set to operate at freq. throttle 2, total number of
     // such clock periods simulated will be less than the simulation cycles 
     // count, which is always measured in BASE clock cycles;
-    double simulation_cycles_count = _topology->simulation_cycles_count();
-    while ( _events.size() > 0 && _current_sim_time <= simulation_cycles_count) {
-
+    if ( _engine == CYCLE_DRIVEN_ENGINE && _cycle_engine != 0) {
+        run_parallel_cycle_loop();
+    } else if ( _engine == CYCLE_DRIVEN_ENGINE && !_topology->do_dvfs()) {
+        run_cycle_driven_loop();
+    } else if ( _engine == PARALLEL_ENGINE) {
+        run_pdes_loop();
+    } else {
+        // also the cycle-driven engine with dvfs, whose clock domains are
+        // stepped by their events (see TOPOLOGY::clock_domain_stepping());
+        run_event_driven_loop();
+    }
+    
+    // () gui to be or not to be;
+    if ( _topology->use_gui()) {
+        sprintf( msg, "FINAL - Time: %.2f  All packets injected: %ld  Packets arrived after warmup: %ld ",
+            current_sim_cycles(), _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
+        _vnoc->gui()->update_screen( PRIORITY_MAJOR, msg, ROUTERS);
+    }
 
-        // () check if warmup cycles are finished; only after this we should
-        // start computing latency statistics;
-        if ( _vnoc->warmup_done() == false && 
-            _current_sim_time >= _topology->warmup_cycles_count()) {
-            _vnoc->set_warmup_done(); // set it true; mark that warmup is done;
-        }
+    return true;
+}
 
+void EVENT_QUEUE::run_event_driven_loop()
+{
+    while ( _current_sim_time <= _simulation_end_time && !_stop_requested) {
 
+        // () only dormant routers may be left (e.g., after the last packet
+        // of a trace file); wake them up and keep them awake till the end,
+        // so that their cycles go on as if they never went dormant;
+        if ( event_queue_size() == 0) {
+            if ( _vnoc->dormant_routers_allowed() == false) {
+                break;
+            }
+            _vnoc->disable_dormant_routers();
+            continue;
+        }
 
         // () simulation: retrieve/consume events and process them; create
         // and add more events to queue;
-        EVENT this_event = *get_event();
+        EVENT this_event = get_event();
         remove_top_event();
-        _queue_events_simulated ++;
-        assert( _current_sim_time <= this_event.start_time() + S_ELPS);
-        // Note: when traffic is synthetic (uniform, transpose, hotspot)
-        // current_sim_time will be integer; when using tracefiles, injection
-        // times are real values; that are in between "clock cycles" that
-        // have edges as the times when events of type ROUTER are extracted
-        // from queue and simulated;
-        _current_sim_time = this_event.start_time();
-
-
-        if ( _current_sim_time > report_at_time) {
-            // early stop if we see that the avg. latency is too large
-            // it means that we are well beyond the saturation point and 
-            // continuing to run would be waste of time; avg. latency
-            // would end up being very high anyways;
-            if ( _vnoc->update_and_check_for_early_termination() == true) {
-                printf("\nError:  Simulation terminated due to avg. latency too large.");
-                break;
-            }            
-
-            if ( _vnoc->verbose()) {
-                printf("-------------------------------------------------------------");
-                printf("\nCurrent time: %.2f  Simulated queue-events: %ld",
-                       _current_sim_time, _queue_events_simulated);
-                printf("\nAll packets injected: %ld  Packets arrived after warmup: %ld\n",
-                       _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
-            }
-            printf("%.2f%% \n", (100 * _current_sim_time / simulation_cycles_count));
 
-            _vnoc->update_and_print_simulation_results( _vnoc->verbose());
+        // () simulation stops after the first event that is later than
+        // simulation cycles count; that event could have been a cycle of a
+        // dormant router (not in the queue); so, wake up all dormant routers
+        // and keep them awake till the end, and pick again;
+        if ( this_event.start_time() > _simulation_end_time &&
+             _vnoc->dormant_routers_allowed()) {
+            _vnoc->disable_dormant_routers();
+            add_issued_event( this_event);
+            continue;
+        }
 
-            report_at_time += REPORT_STATS_PERIOD;
+        // the event of a clock domain is not processed as such; each of
+        // its routers is, when its cycle starts (see start_router_cycle());
+        assert( _current_sim_time <= this_event.start_time());
+        long origin = ( this_event.type() == EVENT::ROUTER_SINGLE) ?
+            this_event.from_router_id() : -1;
+        if ( !this_event.clock_domain_event() &&
+             start_processing( this_event.key(), origin) == false) {
+            break;
+        }
 
-            if ( _topology->use_gui()) {
-                double left_time = _topology->simulation_cycles_count() - _current_sim_time;
-                sprintf( msg, "Current time: %.2f  Simulated queue-events: %ld  All packets injected: %ld  Packets arrived after warmup: %ld ",
-                    _current_sim_time, _queue_events_simulated,
-                    _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
-                _vnoc->gui()->update_screen( ( _topology->gui_step_by_step() ? 
-                    PRIORITY_MAJOR : PRIORITY_MINOR), msg, ROUTERS);
+        process_event( this_event);
+    }
+}
+
+void EVENT_QUEUE::run_cycle_driven_loop()
+{
+    // each cycle, merge the cycles of all routers and the events from the
+    // queue, in the same order the event-driven engine would process them
+    // (see EVENT_KEY); flits and credits are taken in by routers from
+    // their links;
+    long routers_count = _vnoc->routers_count();
+    for ( _current_cycle = 0; ; _current_cycle ++) {
+        long next_router = 0;
+
+        while ( true) {
+            bool take_router = ( next_router < routers_count);
+            bool take_queue = false;
+            EVENT_KEY next_key( (_current_cycle + 1) * TICKS_PER_CYCLE, 0, -1);
+            if ( take_router) {
+                next_key = router_cycle_key( _current_cycle, next_router);
+            }
+            // events from the queue (PE) are issued outside routers and come
+            // first on equal keys; ones between two cycles are processed
+            // once the earlier cycle is done;
+            if ( event_queue_size() > 0 && !( next_key < get_event().key())) {
+                take_queue = true;
+                take_router = false;
+            }
+            if ( !take_router && !take_queue) {
+                break; // done with this cycle;
             }
-        }
-        
 
-        // () this switch case is the main engine of the simulation;
-        
+            if ( _current_sim_time > _simulation_end_time) {
+                return;
+            }
 
-        switch ( this_event.type()) {
+            if ( take_queue) {
+                EVENT this_event = get_event();
+                remove_top_event();
+                if ( start_processing( this_event.key(), -1) == false) {
+                    return;
+                }
+                process_event( this_event);
+            } else {
+                if ( start_processing( router_cycle_key( _current_cycle, next_router),
+                    next_router) == false) {
+                    return;
+                }
+                SIM_TIME delay = _vnoc->simulate_router_cycle( next_router);
+                assert( delay == PIPE_DELAY_BASE);
+                next_router ++;
+            }
+        }
+    }
+}
 
-            case EVENT::PE :
-                // next function will call simulate_one_traffic_injector()
-                // for each injector in the network; if injecting from tracefile,
-                // then packets are read from tracefiles directly;
-                _vnoc->receive_EVENT_PE( this_event);
+void EVENT_QUEUE::run_parallel_cycle_loop()
+{
+    // each cycle, the main thread processes first the events from the queue
+    // (PE) that come before the routers' cycle; then, all routers do their
+    // cycle in parallel; as with the sequential loop, simulation stops 
+    // after the first event or router cycle later than simulation cycles
+    // count;
+    _cycle_engine->start_threads();
+    for ( _current_cycle = 0; ; _current_cycle ++) {
+        EVENT_KEY cycle_key = router_cycle_key( _current_cycle, 0);
+        bool stop = false;
+        while ( event_queue_size() > 0 && !( cycle_key < get_event().key())) {
+            if ( _current_sim_time > _simulation_end_time) {
                 break;
-
-            case EVENT::ROUTER_SINGLE :
-                assert(this_event.from_router_id() >= 0 && 
-                    this_event.from_router_id() < _vnoc->routers_count());
-                //printf(" %d", this_event.id());                
-                _vnoc->receive_EVENT_ROUTER_SINGLE( this_event);
+            }
+            EVENT this_event = get_event();
+            remove_top_event();
+            _cycle_engine->set_current_event( this_event.key(), -1);
+            if ( start_processing( this_event.key(), -1) == false) {
+                stop = true;
                 break;
-
-            case EVENT::SYNC_PREDICT_DVFS_SET :
-                // done only when dvfs mode is SYNC; done once every other
-                // "_history_window" base cycles;
-                _vnoc->receive_EVENT_SYNC_PREDICT_DVFS_SET( this_event);
+            }
+            process_event( this_event);
+        }
+        if ( stop || _current_sim_time > _simulation_end_time ||
+            start_processing( cycle_key, -1) == false) {
+            break;
+        }
+        // the last cycle or the one at the end of warmup: the first router
+        // alone, as the sequential loop checks both after each router;
+        long first_router = 0;
+        if ( _current_sim_time > _simulation_end_time ||
+            ( _vnoc->warmup_done() == false &&
+              _current_sim_time >= _warmup_end_time)) {
+            _cycle_engine->run_router_cycle( _current_cycle, 0);
+            first_router = 1;
+            if ( _current_sim_time > _simulation_end_time) {
                 break;
-
-            case EVENT::LINK :
-                _vnoc->receive_EVENT_LINK( this_event);
+            }
+            if ( first_router < _vnoc->routers_count() &&
+                start_processing( router_cycle_key( _current_cycle, 1), 1) == false) {
                 break;
+            }
+        }
+        _cycle_engine->run_cycle( _current_cycle, first_router);
+    }
+    _cycle_engine->stop_threads();
+}
 
-            case EVENT::CREDIT :
-                _vnoc->receive_EVENT_CREDIT( this_event);
+void EVENT_QUEUE::run_pdes_loop()
+{
+    // windows of tile events alternate with events of the main queue; the
+    // earliest event decides which comes next; a window ends at the first
+    // event that could have been sent by another tile, at the next event of
+    // the main queue or at the end of simulation, whichever comes first;
+    // as with the event-driven engine, simulation stops after the first
+    // event later than simulation cycles count;
+    EVENT_KEY end_key( _simulation_end_time, LLONG_MAX, LONG_MAX);
+    bool stopped = false;
+    _pdes_engine->start_threads();
+
+    while ( true) {
+        EVENT_KEY tile_key = end_key;
+        bool tile_events = _pdes_engine->earliest_event_key( tile_key);
+
+        if ( event_queue_size() == 0 && !tile_events) {
+            // only dormant routers are left; as with the event-driven 
+            // engine, they are woken up at the last event and kept awake;
+            if ( _vnoc->dormant_routers_allowed() == false) {
                 break;
+            }
+            EVENT_KEY last_key = current_event_key();
+            _pdes_engine->latest_event_key( last_key);
+            set_current_event( last_key, -1);
+            _pdes_engine->set_current_event( last_key, -1);
+            _vnoc->disable_dormant_routers();
+            continue;
+        }
 
-            default:
-                printf("DUMMY\n");
-                assert(0);
+        if ( event_queue_size() > 0 && 
+            ( !tile_events || !( tile_key < get_event().key()))) {
+            EVENT this_event = get_event();
+            if ( !( this_event.key() < end_key)) {
+                break;
+            }
+            remove_top_event();
+            _pdes_engine->set_current_event( this_event.key(), -1);
+            if ( start_processing( this_event.key(), -1) == false) {
+                stopped = true;
                 break;
+            }
+            process_event( this_event);
+            continue;
+        }
 
+        if ( !tile_events || !( tile_key < end_key)) {
+            break;
+        }
+        if ( start_processing( tile_key, -1) == false) {
+            stopped = true;
+            break;
+        }
+        EVENT_KEY bound( tile_key._start_time + _pdes_engine->lookahead(),
+            LLONG_MIN, LONG_MIN);
+        if ( event_queue_size() > 0 && get_event().key() < bound) {
+            bound = get_event().key();
+        }
+        if ( end_key < bound) {
+            bound = end_key;
+        }
+        // start_processing() must also see the events that the event-driven
+        // engine reports at and the one after the first event of the end
+        // of warmup; so, windows end before them, but keep their first event;
+        EVENT_KEY next_key( tile_key._start_time, tile_key._issue_time,
+            tile_key._origin + 1);
+        EVENT_KEY report_key( _report_at_time + 1, LLONG_MIN, LONG_MIN);
+        if ( report_key < bound) {
+            bound = ( report_key < next_key) ? next_key : report_key;
         }
+        if ( _vnoc->warmup_done() == false) {
+            EVENT_KEY warmup_key( _warmup_end_time, LLONG_MIN, LONG_MIN);
+            if ( warmup_key < bound) {
+                bound = ( warmup_key < next_key) ? next_key : warmup_key;
+            }
+        }
+        _pdes_engine->run_window( bound);
+    }
 
+    EVENT_KEY tile_key = end_key;
+    bool tile_events = false;
+    if ( !stopped) {
+        // dormant routers catch up with the last cycles and are kept awake,
+        // as with the event-driven engine; then, the first event later 
+        // than simulation cycles count, from the main queue or a tile;
+        set_current_event( end_key, -1);
+        _pdes_engine->set_current_event( end_key, -1);
+        if ( _vnoc->dormant_routers_allowed()) {
+            _vnoc->disable_dormant_routers();
+        }
+        tile_events = _pdes_engine->earliest_event_key( tile_key);
+        if ( event_queue_size() > 0 && 
+            ( !tile_events || !( tile_key < get_event().key()))) {
+            EVENT this_event = get_event();
+            remove_top_event();
+            _pdes_engine->set_current_event( this_event.key(), -1);
+            if ( start_processing( this_event.key(), -1)) {
+                process_event( this_event);
+            }
+        } else if ( tile_events && start_processing( tile_key, -1)) {
+            // a window of this event only; keys of routers are unique;
+            _pdes_engine->run_window( EVENT_KEY( tile_key._start_time,
+                tile_key._issue_time, tile_key._origin + 1));
+        }
+    }
+    _pdes_engine->stop_threads();
+}
+
+void EVENT_QUEUE::run_tile_window( const EVENT_KEY &bound)
+{
+    // called by the thread of this tile;
+    while ( event_queue_size() > 0 && get_event().key() < bound) {
+        EVENT this_event = get_event();
+        remove_top_event();
+        long origin = ( this_event.type() == EVENT::ROUTER_SINGLE) ?
+            this_event.from_router_id() : -1;
+        set_current_event( this_event.key(), origin);
+        _queue_events_simulated ++;
+        process_event( this_event);
     }
+}
+
+EVENT_KEY EVENT_QUEUE::router_cycle_key( long cycle, long router_id) const
+{
+    // key of the ROUTER_SINGLE event of this cycle of the router with the
+    // event-driven engine; cycles at time 0 are added by 
+    // insert_initial_events(), the others by the previous cycle;
+    if ( cycle == 0) {
+        return EVENT_KEY( 0, 0, -1);
+    }
+    SIM_TIME time = cycle * TICKS_PER_CYCLE;
+    return EVENT_KEY( time, time - PIPE_DELAY_BASE, router_id);
+}
+
+bool EVENT_QUEUE::start_router_cycle( const EVENT_KEY &key, long router_id)
+{
+    // routers of a clock domain are simulated by one event; events (e.g., 
+    // PE or ROUTER_SINGLE) between the cycles of its routers are processed
+    // here, so that each router sees them as it would with its own 
+    // ROUTER_SINGLE event; as with the event-driven loop, simulation stops
+    // after the first of them that is later than simulation cycles count;
+    while ( event_queue_size() > 0 && get_event().key() < key) {
+        if ( _current_sim_time > _simulation_end_time) {
+            _stop_requested = true;
+            return false;
+        }
+        EVENT this_event = get_event();
+        remove_top_event();
+        long origin = ( this_event.type() == EVENT::ROUTER_SINGLE) ?
+            this_event.from_router_id() : -1;
+        if ( start_processing( this_event.key(), origin) == false) {
+            _stop_requested = true;
+            return false;
+        }
+        process_event( this_event);
+    }
+    if ( _current_sim_time > _simulation_end_time ||
+         start_processing( key, router_id) == false) {
+        _stop_requested = true;
+        return false;
+    }
+    return true;
+}
+
+bool EVENT_QUEUE::start_processing( const EVENT_KEY &key, long origin)
+{
+    // bookkeeping done before processing each event (or router cycle with
+    // the cycle-driven engine); returns false if simulation must stop;
+    char msg[BUFFER_SIZE];
+
+
+    // () check if warmup cycles are finished; only after this we should
+    // start computing latency statistics;
+    if ( _vnoc->warmup_done() == false && 
+        _current_sim_time >= _warmup_end_time) {
+        _vnoc->set_warmup_done(); // set it true; mark that warmup is done;
+    }
+
+    _queue_events_simulated ++;
+    // Note: when traffic is synthetic (uniform, transpose, hotspot)
+    // current_sim_time will be a whole number of cycles; when using 
+    // tracefiles, injection times are real values (rounded to ticks) that
+    // are in between "clock cycles" that have edges as the times when 
+    // events of type ROUTER are extracted from queue and simulated;
+    _current_sim_time = key._start_time;
+    _current_event_key = key;
+    _current_origin = origin;
+
+
+    if ( _current_sim_time > _report_at_time) {
+        // early stop if we see that the avg. latency is too large
+        // it means that we are well beyond the saturation point and 
+        // continuing to run would be waste of time; avg. latency
+        // would end up being very high anyways;
+        // dormant routers catch up with the cycles they skipped;
+        _vnoc->catch_up_dormant_routers();
+        if ( _vnoc->update_and_check_for_early_termination() == true) {
+            printf("\nError:  Simulation terminated due to avg. latency too large.");
+            return false;
+        }            
+
+        if ( _vnoc->verbose()) {
+            printf("-------------------------------------------------------------");
+            printf("\nCurrent time: %.2f  Simulated queue-events: %ld",
+                   current_sim_cycles(), _queue_events_simulated);
+            printf("\nAll packets injected: %ld  Packets arrived after warmup: %ld\n",
+                   _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
+        }
+        printf("%.2f%% \n", (100 * current_sim_cycles() / _topology->simulation_cycles_count()));
+
+        _vnoc->update_and_print_simulation_results( _vnoc->verbose());
+
+        _report_at_time += REPORT_STATS_PERIOD * TICKS_PER_CYCLE;
+
+        if ( _topology->use_gui()) {
+            sprintf( msg, "Current time: %.2f  Simulated queue-events: %ld  All packets injected: %ld  Packets arrived after warmup: %ld ",
+                current_sim_cycles(), _queue_events_simulated,
+                _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
+            _vnoc->gui()->update_screen( ( _topology->gui_step_by_step() ? 
+                PRIORITY_MAJOR : PRIORITY_MINOR), msg, ROUTERS);
+        }
+    }
+    return true;
+}
+
+void EVENT_QUEUE::process_event( EVENT &this_event)
+{
+    // () this switch case is the main engine of the simulation;
     
 
+    switch ( this_event.type()) {
+
+        case EVENT::PE :
+            // next function will call simulate_one_traffic_injector()
+            // for each injector in the network; if injecting from tracefile,
+            // then packets are read from tracefiles directly;
+            _vnoc->receive_EVENT_PE( this_event);
+            break;
+
+        case EVENT::ROUTER_SINGLE :
+            assert(this_event.from_router_id() >= 0 && 
+                this_event.from_router_id() < _vnoc->routers_count());
+            //printf(" %d", this_event.id());                
+            _vnoc->receive_EVENT_ROUTER_SINGLE( this_event);
+            break;
+
+        case EVENT::ROUTER_BOOST :
+        case EVENT::ROUTER :
+        case EVENT::ROUTER_THROTTLE_1 :
+        case EVENT::ROUTER_THROTTLE_2 :
+            // clock-domain engine only;
+            _vnoc->receive_EVENT_ROUTER( this_event);
+            break;
+
+        case EVENT::SYNC_PREDICT_DVFS_SET :
+            // done only when dvfs mode is SYNC; done once every other
+            // "_history_window" base cycles;
+            _vnoc->receive_EVENT_SYNC_PREDICT_DVFS_SET( this_event);
+            break;
+
+        default:
+            printf("DUMMY\n");
+            assert(0);
+            break;
 
-    // () gui to be or not to be;
-    if ( _topology->use_gui()) {
-        sprintf( msg, "FINAL - Time: %.2f  All packets injected: %ld  Packets arrived after warmup: %ld ",
-            _current_sim_time, _vnoc->total_packets_injected_count(), _vnoc->packets_arrived_count_after_wu());
-        _vnoc->gui()->update_screen( PRIORITY_MAJOR, msg, ROUTERS);
     }
 }
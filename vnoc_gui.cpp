@@ -183,8 +183,8 @@ void GUI_GRAPHICS::init_draw_coords ( float router_width_val,
     long routers_count = _vnoc->routers_count();
     long i = 0;
 
-    long nx = _topology->ary_size();
-    long ny = nx;
+    long nx = _topology->nx();
+    long ny = _topology->ny();
     // set now numerical values of interest for dimensions and coloring
     // to represent congestion;
     _router_width = router_width_val;
@@ -226,8 +226,8 @@ void GUI_GRAPHICS::draw_routers (void)
     float pe_width_height = _router_width / 4;
     long i=0, j=0;
     char buf[BUFFER_SIZE];
-    long nx = _topology->ary_size();
-    long ny = nx;
+    long nx = _topology->nx();
+    long ny = _topology->ny();
 
     setlinewidth(0);
 
@@ -237,7 +237,7 @@ void GUI_GRAPHICS::draw_routers (void)
         x2 = x1 + _router_width;
         for ( j = 0; j < ny; j++) {
 
-            long this_router_id = i * nx + j;
+            long this_router_id = i * ny + j; // id = x * ny + y;
             y1 = _y_router_bottom[j];
             y2 = y1 + _router_width;
             if ( _router_occupancy[ this_router_id] > 0) {
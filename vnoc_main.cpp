@@ -55,7 +55,7 @@ int main( int argc, char *argv[])
     TOPOLOGY topology( argc, argv);
     // create queue object, which is the primary engine of running the 
     // event-driven simulation;
-    EVENT_QUEUE event_queue( 0.0, &topology); // start time = 0.0;
+    EVENT_QUEUE event_queue( 0, &topology); // start time = 0;
     // create network's host; also open the main trace file where in 
     // addition an event type PE is added to the simulation-queue,
     // which will kick of the simulation and insertion of additional
@@ -0,0 +1,514 @@
+#include "vnoc_network.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// NETWORK
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void NETWORK::compile( TOPOLOGY *topology)
+{
+    _vc_number = topology->virtual_channel_number();
+    long stages = topology->pipeline_stages_per_link();
+
+    // (1) routers, ports and links;
+    if ( topology->topology_file().empty()) {
+        _routers_count = topology->routers_count();
+        _ports_count = topology->cube_size() * 2 + 1; // + 1 for the PE;
+        _router_ports_counts.assign( _routers_count, _ports_count);
+        resize_tables();
+        build_cube_neighbors( topology, stages);
+    } else {
+        load_topology_file( topology->topology_file(), stages);
+    }
+
+    // (2) routes; the dimension order routes of the mesh and torus are
+    // deadlock free by construction; only up*/down* routes, which are
+    // used for topology files, are checked;
+    if ( topology->routing_algo() == UP_DOWN) {
+        build_up_down_routes();
+        check_routes();
+    } else {
+        build_cube_routes( topology);
+    }
+}
+
+long NETWORK::min_link_stages() const
+{
+    long min_stages = -1;
+    for ( long i = 0; i < long(_link_stages.size()); i++) {
+        if ( _neighbor_routers[ i] >= 0 &&
+            ( min_stages < 0 || _link_stages[ i] < min_stages)) {
+            min_stages = _link_stages[ i];
+        }
+    }
+    return ( min_stages < 0) ? 0 : min_stages;
+}
+
+void NETWORK::resize_tables()
+{
+    _neighbor_routers.assign( _routers_count * _ports_count, -1);
+    _neighbor_ports.assign( _routers_count * _ports_count, -1);
+    _link_stages.assign( _routers_count * _ports_count, 0);
+}
+
+void NETWORK::add_link( long router_id, long port_id,
+    long other_id, long other_port_id, long stages)
+{
+    // both ways;
+    long k = router_id * _ports_count + port_id;
+    _neighbor_routers[ k] = other_id;
+    _neighbor_ports[ k] = other_port_id;
+    _link_stages[ k] = stages;
+    k = other_id * _ports_count + other_port_id;
+    _neighbor_routers[ k] = router_id;
+    _neighbor_ports[ k] = port_id;
+    _link_stages[ k] = stages;
+}
+
+void NETWORK::build_cube_neighbors( TOPOLOGY *topology, long stages)
+{
+    // along dimension d, port 2*d+1 goes toward smaller coordinates and
+    // port 2*d+2 toward larger ones; i.e., 1 is West, 2 is East, 3 is South,
+    // 4 is North, 5 is Down and 6 is Up; routers at the edges of the mesh
+    // have no link on the ports that face outside; in the torus, these
+    // ports are linked by the wraparound links;
+    long cube_size = topology->cube_size();
+    for ( long i = 0; i < _routers_count; i++) {
+        ADDRESS a = topology->router_address( i);
+        for ( long d = 0; d < cube_size; d++) {
+            long size = topology->dimension_size( d);
+            ADDRESS b = a;
+            b[d] = a[d] + 1;
+            if ( b[d] == size) {
+                if ( !topology->torus()) {
+                    continue;
+                }
+                b[d] = 0;
+            }
+            add_link( i, 2 * d + 2, topology->router_id( b), 2 * d + 1, stages);
+        }
+    }
+}
+
+void NETWORK::load_topology_file( const string &file_name, long stages)
+{
+    // see README.txt for the format; links are kept till the port
+    // counts of all routers are known;
+    ifstream file_st( file_name.c_str());
+    if ( !file_st) {
+        printf("Error:  Cannot open topology file %s.\n", file_name.c_str());
+        exit(1);
+    }
+    vector<long> links_t; // five numbers for each link;
+    string line;
+    long line_number = 0;
+    _routers_count = 0;
+    while ( getline( file_st, line)) {
+        line_number ++;
+        size_t comment = line.find('#');
+        if ( comment != string::npos) {
+            line.erase( comment);
+        }
+        istringstream line_st( line);
+        string keyword;
+        if ( !(line_st >> keyword)) {
+            continue; // empty line;
+        }
+        bool ok = true;
+        if ( keyword == "routers") {
+            ok = (line_st >> _routers_count) && _routers_count >= 2 &&
+                _router_ports_counts.empty();
+            if ( ok) {
+                _router_ports_counts.assign( _routers_count, 1);
+            }
+        } else if ( keyword == "router") {
+            long id = -1, ports = 0;
+            ok = (line_st >> id >> ports) && id >= 0 && id < _routers_count &&
+                ports >= 1 && ports <= 64;
+            if ( ok) {
+                _router_ports_counts[ id] = ports;
+            }
+        } else if ( keyword == "link") {
+            long a = -1, pa = -1, b = -1, pb = -1, latency = stages + 1;
+            ok = (line_st >> a >> pa >> b >> pb) && a >= 0 && a < _routers_count &&
+                b >= 0 && b < _routers_count && a != b && pa >= 1 && pb >= 1;
+            if ( ok && !(line_st >> latency)) {
+                latency = stages + 1;
+            }
+            ok = ok && latency >= 1 && latency <= 33;
+            if ( ok) {
+                long link_t[] = { a, pa, b, pb, latency - 1};
+                links_t.insert( links_t.end(), link_t, link_t + 5);
+            }
+        } else if ( keyword == "root") {
+            ok = (line_st >> _root_id) && _root_id >= 0 && _root_id < _routers_count;
+        } else {
+            ok = false;
+        }
+        string extra;
+        if ( !ok || (line_st >> extra)) {
+            printf("Error:  Topology file %s, line %ld: '%s' is not valid.\n",
+                file_name.c_str(), line_number, line.c_str());
+            exit(1);
+        }
+    }
+    file_st.close();
+    if ( _routers_count < 2) {
+        printf("Error:  Topology file %s has no 'routers' line.\n", file_name.c_str());
+        exit(1);
+    }
+
+    // ports used by links count too, when not given by "router" lines;
+    for ( long k = 0; k < long(links_t.size()); k += 5) {
+        for ( long e = 0; e < 4; e += 2) {
+            long id = links_t[ k + e];
+            long port = links_t[ k + e + 1];
+            if ( _router_ports_counts[ id] <= port) {
+                _router_ports_counts[ id] = port + 1;
+            }
+        }
+    }
+    _ports_count = 1;
+    for ( long i = 0; i < _routers_count; i++) {
+        _ports_count = max( _ports_count, _router_ports_counts[ i]);
+    }
+    resize_tables();
+    for ( long k = 0; k < long(links_t.size()); k += 5) {
+        long a = links_t[k], pa = links_t[k+1], b = links_t[k+2], pb = links_t[k+3];
+        if ( neighbor_router( a, pa) >= 0 || neighbor_router( b, pb) >= 0) {
+            printf("Error:  Topology file %s connects port %ld of router %ld "
+                "or port %ld of router %ld twice.\n",
+                file_name.c_str(), pa, a, pb, b);
+            exit(1);
+        }
+        add_link( a, pa, b, pb, links_t[k+4]);
+    }
+}
+
+long NETWORK::add_route_list( map<vector<VC_PAIR>, long> &list_ids,
+    const vector<VC_PAIR> &routes)
+{
+    // equal candidate lists are stored only once;
+    map<vector<VC_PAIR>, long>::iterator it = list_ids.find( routes);
+    if ( it == list_ids.end()) {
+        it = list_ids.insert( make_pair( routes, long(_route_lists.size()))).first;
+        _route_lists.push_back( routes);
+    }
+    return it->second;
+}
+
+void NETWORK::build_cube_routes( TOPOLOGY *topology)
+{
+    // routes between all pairs of coordinates of each dimension, of
+    // addresses that differ in that dimension only; one class of input
+    // ports; list 0 is the empty one, of a router to itself;
+    map<vector<VC_PAIR>, long> list_ids;
+    vector<VC_PAIR> routes_t;
+    _port_classes_count = 1;
+    _port_classes.assign( _routers_count * _ports_count, 0);
+    _route_ids.clear();
+    _route_lists.clear();
+    add_route_list( list_ids, routes_t);
+    long cube_size = topology->cube_size();
+    _dimension_sizes.resize( cube_size);
+    _dimension_route_ids.resize( cube_size);
+    for ( long d = 0; d < cube_size; d++) {
+        long size = topology->dimension_size( d);
+        _dimension_sizes[ d] = size;
+        _dimension_route_ids[ d].assign( size * size, 0);
+        ADDRESS a( cube_size, 0), des_a( cube_size, 0);
+        for ( long i = 0; i < size; i++) {
+            for ( long j = 0; j < size; j++) {
+                if ( i == j) {
+                    continue;
+                }
+                a[d] = i;
+                des_a[d] = j;
+                routes_t.clear();
+                dimension_order_routes( topology, a, des_a,
+                    topology->routing_algo() == TXY, routes_t);
+                _dimension_route_ids[ d][ i * size + j] =
+                    add_route_list( list_ids, routes_t);
+            }
+        }
+    }
+}
+
+void NETWORK::dimension_order_routes( TOPOLOGY *topology, const ADDRESS &a,
+    const ADDRESS &des_a, bool torus_routes, vector<VC_PAIR> &routes) const
+{
+    // dimensions are routed from the last one (i.e., y before x in 2D);
+    // (1) XY (XY on mesh); any vc of the output port;
+    // (2) TXY (XY on torus); the shorter way around each ring; to break
+    // the cycle of each ring, flits that still have to cross its dateline
+    // (the wraparound link) use the lower half of the vc's and the others
+    // the upper half;
+    for ( long d = long(a.size()) - 1; d >= 0; d--) {
+        long offset = des_a[d] - a[d];
+        if ( offset == 0) {
+            continue;
+        }
+        long first_vc = 0, vcs_count = _vc_number;
+        bool plus = ( offset > 0);
+        if ( torus_routes) {
+            long size = topology->dimension_size( d);
+            if ( labs( offset) * 2 > size) {
+                plus = !plus; // the other way around is shorter;
+            }
+            // the dateline is crossed if the destination is behind us;
+            bool crosses_dateline = plus ? ( des_a[d] < a[d]) : ( des_a[d] > a[d]);
+            vcs_count = _vc_number / 2;
+            first_vc = crosses_dateline ? 0 : vcs_count;
+            if ( !crosses_dateline) {
+                vcs_count = _vc_number - vcs_count;
+            }
+        }
+        long out_port = plus ? ( 2 * d + 2) : ( 2 * d + 1);
+        for ( long j = first_vc; j < first_vc + vcs_count; j++) {
+            routes.push_back( VC_PAIR( out_port, j));
+        }
+        return;
+    }
+}
+
+void NETWORK::distances_from( long router_id, vector<long> &distances) const
+{
+    // hops of the shortest paths from router_id; -1 if not connected;
+    distances.assign( _routers_count, -1);
+    vector<long> queue_t( 1, router_id);
+    distances[ router_id] = 0;
+    for ( long k = 0; k < long(queue_t.size()); k++) {
+        long r = queue_t[ k];
+        for ( long p = 1; p < _router_ports_counts[ r]; p++) {
+            long n = neighbor_router( r, p);
+            if ( n >= 0 && distances[ n] < 0) {
+                distances[ n] = distances[ r] + 1;
+                queue_t.push_back( n);
+            }
+        }
+    }
+}
+
+void NETWORK::build_up_down_routes()
+{
+    // up*/down* routing: a link goes up if it goes to a router closer to
+    // the root or, at the same distance, to a smaller id; routes go up
+    // zero or more links and then down zero or more links; so, they can
+    // never close a cycle of channel dependencies; of these, only the
+    // shortest ones are candidates, with any vc;
+
+    // (1) the root; by default, the router with the smallest eccentricity;
+    vector<long> level;
+    long root_id = _root_id;
+    if ( root_id < 0) {
+        long best_eccentricity = -1;
+        for ( long r = 0; r < _routers_count; r++) {
+            distances_from( r, level);
+            long eccentricity = 0;
+            for ( long i = 0; i < _routers_count; i++) {
+                // not connected routers are reported below;
+                eccentricity = max( eccentricity,
+                    ( level[i] < 0) ? _routers_count : level[i]);
+            }
+            if ( best_eccentricity < 0 || eccentricity < best_eccentricity) {
+                best_eccentricity = eccentricity;
+                root_id = r;
+            }
+        }
+    }
+    distances_from( root_id, level);
+    for ( long i = 0; i < _routers_count; i++) {
+        if ( level[i] < 0) {
+            printf("Error:  Router %ld is not connected to the network.\n", i);
+            exit(1);
+        }
+    }
+    #define GOES_UP(a, b) ( level[b] < level[a] || ( level[b] == level[a] && (b) < (a)))
+
+    // (2) input ports that links come down to; there, flits can only
+    // go down;
+    _port_classes_count = 2;
+    _port_classes.assign( _routers_count * _ports_count, 0);
+    for ( long r = 0; r < _routers_count; r++) {
+        for ( long p = 1; p < _router_ports_counts[ r]; p++) {
+            long u = neighbor_router( r, p);
+            if ( u >= 0 && !GOES_UP( u, r)) {
+                _port_classes[ r * _ports_count + p] = 1;
+            }
+        }
+    }
+
+    // (3) for each destination, the hops of the shortest legal routes to
+    // it from each router, while up links may still be taken (phase 0) or
+    // not (phase 1); then, the candidates are the links that take one hop
+    // off them;
+    map<vector<VC_PAIR>, long> list_ids;
+    vector<VC_PAIR> routes_t;
+    _dimension_sizes.clear();
+    _dimension_route_ids.clear();
+    _route_ids.resize( _routers_count * 2 * _routers_count);
+    _route_lists.clear();
+    vector<long> hops[2];
+    vector<pair<long, long> > queue_t;
+    for ( long d = 0; d < _routers_count; d++) {
+        hops[0].assign( _routers_count, -1);
+        hops[1].assign( _routers_count, -1);
+        hops[0][d] = hops[1][d] = 0;
+        queue_t.clear();
+        queue_t.push_back( make_pair( d, 0L));
+        queue_t.push_back( make_pair( d, 1L));
+        for ( long k = 0; k < long(queue_t.size()); k++) {
+            long y = queue_t[k].first;
+            long phase = queue_t[k].second;
+            for ( long p = 1; p < _router_ports_counts[ y]; p++) {
+                // the link x -> y and the phases at x it can be taken in;
+                long x = neighbor_router( y, p);
+                if ( x < 0) {
+                    continue;
+                }
+                bool up = GOES_UP( x, y);
+                for ( long x_phase = 0; x_phase < 2; x_phase++) {
+                    bool legal = up ? ( phase == 0 && x_phase == 0) : ( phase == 1);
+                    if ( legal && hops[x_phase][x] < 0) {
+                        hops[x_phase][x] = hops[phase][y] + 1;
+                        queue_t.push_back( make_pair( x, x_phase));
+                    }
+                }
+            }
+        }
+        for ( long r = 0; r < _routers_count; r++) {
+            for ( long c = 0; c < 2; c++) {
+                routes_t.clear();
+                for ( long p = 1; r != d && hops[c][r] > 0 &&
+                    p < _router_ports_counts[ r]; p++) {
+                    long y = neighbor_router( r, p);
+                    if ( y < 0) {
+                        continue;
+                    }
+                    bool up = GOES_UP( r, y);
+                    long y_hops = up ? ( c == 0 ? hops[0][y] : -1) : hops[1][y];
+                    if ( y_hops >= 0 && y_hops + 1 == hops[c][r]) {
+                        for ( long j = 0; j < _vc_number; j++) {
+                            routes_t.push_back( VC_PAIR( p, j));
+                        }
+                    }
+                }
+                _route_ids[ (r * 2 + c) * _routers_count + d] =
+                    int( add_route_list( list_ids, routes_t));
+            }
+        }
+    }
+    #undef GOES_UP
+}
+
+void NETWORK::follow_routes( long router_id, long in_port_id, long des_router_id,
+    long from, vector<vector<long> > &dependencies, vector<char> &depends,
+    vector<char> &reached, vector<long> &stack_t) const
+{
+    // the channels that flits at input port in_port_id of router_id (in
+    // channel "from"; -1 for the PE port) may take next toward des_router_id;
+    // these are reached thru the output ports of router_id, so depends has
+    // one flag for each (output port, vc) of each channel;
+    const vector<VC_PAIR> &routes_t = routes( router_id, in_port_id, des_router_id);
+    if ( routes_t.empty()) {
+        printf("Error:  No route from router %ld (input port %ld) to router %ld.\n",
+            router_id, in_port_id, des_router_id);
+        exit(1);
+    }
+    for ( long k = 0; k < long(routes_t.size()); k++) {
+        long q = routes_t[k].first;
+        long n = ( q > 0 && q < _router_ports_counts[ router_id]) ?
+            neighbor_router( router_id, q) : -1;
+        if ( n < 0) {
+            printf("Error:  Route from router %ld to router %ld takes port %ld, "
+                "which has no link.\n",
+                router_id, des_router_id, q);
+            exit(1);
+        }
+        long to = (n * _ports_count + neighbor_port( router_id, q)) * _vc_number +
+            routes_t[k].second;
+        long k_depends = (from * _ports_count + q) * _vc_number + routes_t[k].second;
+        if ( from >= 0 && !depends[ k_depends]) {
+            depends[ k_depends] = 1;
+            dependencies[from].push_back( to);
+        }
+        if ( !reached[to]) {
+            reached[to] = 1;
+            stack_t.push_back( to);
+        }
+    }
+}
+
+void NETWORK::check_routes() const
+{
+    // channels are the vc's of input ports, i.e., of the links flits come
+    // thru; a flit in a channel may wait for any channel its routes give
+    // it next; so, the routes are deadlock free if these dependencies
+    // have no cycle; they are found by following the routes from all
+    // routers to each destination;
+    long channels_count = _routers_count * _ports_count * _vc_number;
+    vector<vector<long> > dependencies( channels_count);
+    vector<char> depends( channels_count * _ports_count * _vc_number, 0);
+    vector<char> reached;
+    vector<long> stack_t;
+    for ( long d = 0; d < _routers_count; d++) {
+        reached.assign( channels_count, 0);
+        for ( long r = 0; r < _routers_count; r++) {
+            if ( r != d) {
+                follow_routes( r, 0, d, -1, dependencies, depends, reached, stack_t);
+            }
+        }
+        while ( !stack_t.empty()) {
+            long from = stack_t.back();
+            stack_t.pop_back();
+            long r = from / (_ports_count * _vc_number);
+            if ( r != d) {
+                follow_routes( r, (from / _vc_number) % _ports_count, d, from,
+                    dependencies, depends, reached, stack_t);
+            }
+        }
+    }
+
+    // depth first search for a cycle; 1 is on the current path, 2 is done;
+    vector<char> color( channels_count, 0);
+    vector<pair<long, long> > path_t;
+    for ( long c = 0; c < channels_count; c++) {
+        if ( color[c] != 0) {
+            continue;
+        }
+        color[c] = 1;
+        path_t.push_back( make_pair( c, 0L));
+        while ( !path_t.empty()) {
+            long u = path_t.back().first;
+            long k = path_t.back().second;
+            if ( k == long(dependencies[u].size())) {
+                color[u] = 2;
+                path_t.pop_back();
+                continue;
+            }
+            path_t.back().second ++;
+            long v = dependencies[u][k];
+            if ( color[v] == 1) {
+                printf("Error:  Routes are not deadlock free; channel dependency "
+                    "cycle thru router %ld, input port %ld, vc %ld.\n",
+                    v / (_ports_count * _vc_number), (v / _vc_number) % _ports_count,
+                    v % _vc_number);
+                exit(1);
+            } else if ( color[v] == 0) {
+                color[v] = 1;
+                path_t.push_back( make_pair( v, 0L));
+            }
+        }
+    }
+}
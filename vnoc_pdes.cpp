@@ -0,0 +1,355 @@
+#include "vnoc_pdes.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+using namespace std;
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// WORKER_POOL
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void WORKER_POOL::run_step()
+{
+    // three barriers: workers start the first phase, all workers are done
+    // with it (and posting), all workers are done with the second phase;
+    // the middle one only if there is a second phase;
+    if ( _workers_count == 1) {
+        run_first_phase( 0);
+        if ( _second_phase) {
+            run_second_phase( 0);
+        }
+        return;
+    }
+    pthread_barrier_wait( &_barrier);
+    run_first_phase( 0);
+    if ( _second_phase) {
+        pthread_barrier_wait( &_barrier);
+        run_second_phase( 0);
+    }
+    pthread_barrier_wait( &_barrier);
+}
+
+void WORKER_POOL::run_worker( long worker_id)
+{
+    while ( true) {
+        pthread_barrier_wait( &_barrier);
+        if ( _stop) {
+            break;
+        }
+        run_first_phase( worker_id);
+        if ( _second_phase) {
+            pthread_barrier_wait( &_barrier);
+            run_second_phase( worker_id);
+        }
+        pthread_barrier_wait( &_barrier);
+    }
+}
+
+void *WORKER_POOL::worker_entry( void *arg)
+{
+    WORKER *worker = (WORKER *)arg;
+    worker->_pool->run_worker( worker->_id);
+    return 0;
+}
+
+void WORKER_POOL::start_threads()
+{
+    // worker 0 is the main thread;
+    if ( _workers_count == 1 || _threads_running) {
+        return;
+    }
+    pthread_barrier_init( &_barrier, 0, _workers_count);
+    _stop = false;
+    _workers.clear();
+    for ( long w = 0; w < _workers_count; w++) {
+        _workers.push_back( WORKER( this, w));
+    }
+    _threads.resize( _workers_count - 1);
+    for ( long w = 1; w < _workers_count; w++) {
+        if ( pthread_create( &_threads[ w - 1], 0,
+            &WORKER_POOL::worker_entry, &_workers[ w]) != 0) {
+            printf("\nError: Cannot create thread %ld.\n", w);
+            exit(1);
+        }
+    }
+    _threads_running = true;
+}
+
+void WORKER_POOL::stop_threads()
+{
+    if ( _threads_running == false) {
+        return;
+    }
+    _stop = true;
+    pthread_barrier_wait( &_barrier);
+    for ( long w = 1; w < _workers_count; w++) {
+        pthread_join( _threads[ w - 1], 0);
+    }
+    pthread_barrier_destroy( &_barrier);
+    _threads_running = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PDES_ENGINE
+//
+////////////////////////////////////////////////////////////////////////////////
+
+PDES_ENGINE::PDES_ENGINE( VNOC *vnoc) :
+    _vnoc(vnoc),
+    _tiles(),
+    _router_tiles(),
+    _lookahead(0),
+    _window_bound( 0, 0, -1)
+{
+    // routers of different tiles talk only thru links; with dvfs any
+    // router may be boosted and send with the shortest delays;
+    TOPOLOGY *topology = _vnoc->topology();
+    if ( topology->do_dvfs()) {
+        _lookahead = topology->min_dvfs_clock_period();
+    } else {
+        _lookahead = min( WIRE_DELAY_BASE, CREDIT_DELAY_BASE);
+    }
+    _lookahead *= _vnoc->network()->min_link_stages() + 1;
+
+    partition();
+    find_boundary_routers();
+
+    // each tile gets its own simulation-queue; its routers add their events
+    // to it from now on;
+    for ( long t = 0; t < _workers_count; t++) {
+        EVENT_QUEUE *tile_queue = new EVENT_QUEUE( 0, topology);
+        tile_queue->set_vnoc( _vnoc);
+        _tiles[ t]._event_queue = tile_queue;
+        for ( long i = 0; i < long(_tiles[ t]._router_ids.size()); i++) {
+            _vnoc->router( _tiles[ t]._router_ids[ i])->set_event_queue( tile_queue);
+        }
+    }
+}
+
+PDES_ENGINE::~PDES_ENGINE()
+{
+    stop_threads();
+    for ( long t = 0; t < _workers_count; t++) {
+        delete _tiles[ t]._event_queue;
+    }
+}
+
+void PDES_ENGINE::partition()
+{
+    // cut the nx x ny mesh into tx x ty rectangles, as close to squares
+    // as possible, so that few links cross tiles; at most one tile per
+    // thread and no empty tiles; in 3D, tiles take all routers along z;
+    // routers of a topology file are cut into ranges of consecutive ids;
+    long nx = _vnoc->topology()->nx();
+    long ny = _vnoc->topology()->ny();
+    long nz = _vnoc->topology()->nz();
+    long threads = _vnoc->topology()->threads_count();
+    if ( !_vnoc->topology()->topology_file().empty()) {
+        long routers_count = _vnoc->routers_count();
+        _workers_count = min( threads, routers_count);
+        for ( long t = 0; t < _workers_count; t++) {
+            _tiles.push_back( PDES_TILE( t));
+        }
+        _router_tiles.resize( routers_count, 0);
+        for ( long id = 0; id < routers_count; id++) {
+            long t = id * _workers_count / routers_count;
+            _router_tiles[ id] = t;
+            _tiles[ t]._router_ids.push_back( id);
+        }
+        return;
+    }
+    long tx = 1, ty = 1;
+    for ( long x = 1; x <= nx; x++) {
+        long y = min( ny, threads / x);
+        if ( y < 1) {
+            break;
+        }
+        if ( x * y > tx * ty ||
+            ( x * y == tx * ty && labs(x - y) < labs(tx - ty))) {
+            tx = x;
+            ty = y;
+        }
+    }
+    _workers_count = tx * ty;
+
+    for ( long t = 0; t < _workers_count; t++) {
+        _tiles.push_back( PDES_TILE( t));
+    }
+    _router_tiles.resize( _vnoc->routers_count(), 0);
+    for ( long id = 0; id < _vnoc->routers_count(); id++) {
+        long x = id / (ny * nz);
+        long y = (id / nz) % ny;
+        long t = (x * tx / nx) * ty + (y * ty / ny);
+        _router_tiles[ id] = t;
+        _tiles[ t]._router_ids.push_back( id);
+    }
+}
+
+void PDES_ENGINE::find_boundary_routers()
+{
+    // routers with a neighbor in another tile, i.e., that may be sent
+    // flits by another thread;
+    const NETWORK *network = _vnoc->network();
+    for ( long id = 0; id < _vnoc->routers_count(); id++) {
+        long t = _router_tiles[ id];
+        for ( long p = 1; p < network->ports_count(); p++) {
+            long neighbor_id = network->neighbor_router( id, p);
+            if ( neighbor_id >= 0 && _router_tiles[ neighbor_id] != t) {
+                _tiles[ t]._boundary_router_ids.push_back( id);
+                break;
+            }
+        }
+    }
+}
+
+bool PDES_ENGINE::earliest_event_key( EVENT_KEY &key)
+{
+    bool found = false;
+    for ( long t = 0; t < _workers_count; t++) {
+        EVENT_QUEUE *tile_queue = _tiles[ t]._event_queue;
+        if ( tile_queue->event_queue_size() > 0) {
+            EVENT_KEY tile_key = tile_queue->get_event().key();
+            if ( !found || tile_key < key) {
+                key = tile_key;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+void PDES_ENGINE::latest_event_key( EVENT_KEY &key)
+{
+    for ( long t = 0; t < _workers_count; t++) {
+        const EVENT_KEY &tile_key = _tiles[ t]._event_queue->current_event_key();
+        if ( key < tile_key) {
+            key = tile_key;
+        }
+    }
+}
+
+void PDES_ENGINE::set_current_event( const EVENT_KEY &key, long origin)
+{
+    // used for events processed by the main thread, which may touch routers
+    // of all tiles (e.g., wake them up);
+    for ( long t = 0; t < _workers_count; t++) {
+        _tiles[ t]._event_queue->set_current_event( key, origin);
+    }
+}
+
+void PDES_ENGINE::run_window( const EVENT_KEY &bound)
+{
+    _window_bound = bound;
+    run_step();
+}
+
+void PDES_ENGINE::run_first_phase( long tile_id)
+{
+    _tiles[ tile_id]._event_queue->run_tile_window( _window_bound);
+}
+
+void PDES_ENGINE::run_second_phase( long tile_id)
+{
+    // flits sent by other tiles during the window arrive after it; routers
+    // of this tile that were dormant when flits were sent to them wake up 
+    // now, as if at the end of the window; their skipped cycles are before
+    // the arrivals, so they are the same as if they woke up then;
+    PDES_TILE &tile = _tiles[ tile_id];
+    for ( long i = 0; i < long(tile._boundary_router_ids.size()); i++) {
+        ROUTER *router = _vnoc->router( tile._boundary_router_ids[ i]);
+        if ( router->dormant() && !router->flit_links_empty()) {
+            tile._event_queue->set_current_event( _window_bound, -1);
+            router->wake_up();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PARALLEL_CYCLE_ENGINE
+//
+////////////////////////////////////////////////////////////////////////////////
+
+PARALLEL_CYCLE_ENGINE::PARALLEL_CYCLE_ENGINE( VNOC *vnoc) :
+    _vnoc(vnoc),
+    _first_routers(),
+    _event_queues(),
+    _current_cycle(0),
+    _first_router_id(0)
+{
+    // ranges of consecutive router ids (i.e., rows of the mesh); each worker
+    // has its own queue, which gives its routers their current time;
+    // flits and credits sent in a cycle are already on their links, where
+    // receivers take them in; so, there is no second phase;
+    TOPOLOGY *topology = _vnoc->topology();
+    long routers_count = _vnoc->routers_count();
+    _workers_count = min( topology->threads_count(), routers_count);
+    _second_phase = false;
+    for ( long w = 0; w <= _workers_count; w++) {
+        _first_routers.push_back( w * routers_count / _workers_count);
+    }
+    for ( long w = 0; w < _workers_count; w++) {
+        EVENT_QUEUE *worker_queue = new EVENT_QUEUE( 0, topology);
+        worker_queue->set_vnoc( _vnoc);
+        _event_queues.push_back( worker_queue);
+        for ( long id = _first_routers[ w]; id < _first_routers[ w + 1]; id++) {
+            _vnoc->router( id)->set_event_queue( worker_queue);
+        }
+    }
+}
+
+PARALLEL_CYCLE_ENGINE::~PARALLEL_CYCLE_ENGINE()
+{
+    stop_threads();
+    for ( long w = 0; w < _workers_count; w++) {
+        delete _event_queues[ w];
+    }
+}
+
+void PARALLEL_CYCLE_ENGINE::set_current_event( const EVENT_KEY &key, long origin)
+{
+    // used for events processed by the main thread, which may touch routers
+    // of all workers (e.g., inject packets);
+    for ( long w = 0; w < _workers_count; w++) {
+        _event_queues[ w]->set_current_event( key, origin);
+    }
+}
+
+void PARALLEL_CYCLE_ENGINE::run_cycle( long cycle, long first_router_id)
+{
+    _current_cycle = cycle;
+    _first_router_id = first_router_id;
+    run_step();
+}
+
+void PARALLEL_CYCLE_ENGINE::run_router_cycle( long cycle, long router_id)
+{
+    long w = 0;
+    while ( _first_routers[ w + 1] <= router_id) {
+        w ++;
+    }
+    EVENT_QUEUE *worker_queue = _event_queues[ w];
+    worker_queue->set_current_event( 
+        worker_queue->router_cycle_key( cycle, router_id), router_id);
+    SIM_TIME delay = _vnoc->simulate_router_cycle( router_id);
+    assert( delay == PIPE_DELAY_BASE);
+}
+
+void PARALLEL_CYCLE_ENGINE::run_first_phase( long worker_id)
+{
+    // one cycle of each router of this worker, in the order of their ids;
+    EVENT_QUEUE *worker_queue = _event_queues[ worker_id];
+    for ( long id = max( _first_routers[ worker_id], _first_router_id); 
+        id < _first_routers[ worker_id + 1]; id++) {
+        worker_queue->set_current_event( 
+            worker_queue->router_cycle_key( _current_cycle, id), id);
+        SIM_TIME delay = _vnoc->simulate_router_cycle( id);
+        assert( delay == PIPE_DELAY_BASE);
+    }
+}
@@ -11,8 +11,66 @@
 
 using namespace std;
 
-// I should encapsulate this one inside _vnoc;
-unsigned long VC_MASK[10] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512};
+////////////////////////////////////////////////////////////////////////////////
+//
+// FLIT_POOL
+//
+////////////////////////////////////////////////////////////////////////////////
+
+FLIT_POOL::FLIT_POOL():
+    _slabs( FLIT_SLABS_MAX, (FLIT *)0),
+    _slabs_count(0),
+    _free_handles()
+{
+    pthread_mutex_init( &_mutex, NULL);
+}
+
+FLIT_POOL::~FLIT_POOL()
+{
+    for ( long i = 0; i < _slabs_count; i++) {
+        delete [] _slabs[i];
+    }
+    pthread_mutex_destroy( &_mutex);
+}
+
+void FLIT_POOL::add_slab()
+{
+    // called with the lock taken;
+    if ( _slabs_count == FLIT_SLABS_MAX) {
+        printf("\nError: Too many flits in flight (more than %d).\n",
+            FLIT_SLABS_MAX * FLIT_SLAB_SIZE);
+        exit(1);
+    }
+    _slabs[ _slabs_count] = new FLIT[ FLIT_SLAB_SIZE];
+    // hand out handles of a new slab in increasing order;
+    FLIT_HANDLE first = FLIT_HANDLE(_slabs_count) << FLIT_SLAB_BITS;
+    for ( long k = FLIT_SLAB_SIZE - 1; k >= 0; k--) {
+        _free_handles.push_back( first + k);
+    }
+    _slabs_count ++;
+}
+
+void FLIT_POOL::get_batch( vector<FLIT_HANDLE> &handles)
+{
+    pthread_mutex_lock( &_mutex);
+    if ( _free_handles.size() < FLIT_BATCH_SIZE) {
+        add_slab();
+    }
+    handles.insert( handles.end(), 
+        _free_handles.end() - FLIT_BATCH_SIZE, _free_handles.end());
+    _free_handles.resize( _free_handles.size() - FLIT_BATCH_SIZE);
+    pthread_mutex_unlock( &_mutex);
+}
+
+void FLIT_POOL::put_batch( vector<FLIT_HANDLE> &handles)
+{
+    assert( handles.size() >= FLIT_BATCH_SIZE);
+    pthread_mutex_lock( &_mutex);
+    _free_handles.insert( _free_handles.end(),
+        handles.end() - FLIT_BATCH_SIZE, handles.end());
+    pthread_mutex_unlock( &_mutex);
+    handles.resize( handles.size() - FLIT_BATCH_SIZE);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 //
@@ -23,31 +81,42 @@ unsigned long VC_MASK[10] = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512};
 ROUTER_INPUT::ROUTER_INPUT():
     _input_buff(),
     _vc_state(),
+    _vc_state_masks(),
+    _vc_count(0),
     _routing(),
     _selected_routing(),
     _injection_buff_full(false)
 {
 }
 
-ROUTER_INPUT::ROUTER_INPUT(long physical_ports_count, long vc_count):
+ROUTER_INPUT::ROUTER_INPUT(long physical_ports_count, long vc_count,
+                           long buffer_size):
     _input_buff(),
     _vc_state(),
+    _vc_state_masks( HOME + 1, BIT_VECTOR( physical_ports_count * vc_count)),
+    _vc_count( vc_count),
     _routing(),
     _selected_routing(),
     _injection_buff_full(false)
 {
     long i = 0;
+    // buffers of ports other than the PE one never hold more than 
+    // buffer_size flits (credit based flow control); the PE injection 
+    // buffers may hold up to about BUFF_BOUND flits and grow as needed;
     _input_buff.resize( physical_ports_count);
     for ( i = 0; i < physical_ports_count; i++) {
-        _input_buff[i].resize( vc_count);
+        _input_buff[i].resize( vc_count, RING_QUEUE<FLIT_HANDLE>( buffer_size));
     }
     _vc_state.resize( physical_ports_count);
     for ( i = 0; i < physical_ports_count; i++) {
         _vc_state[i].resize( vc_count, IDLE);
+        for ( long j = 0; j < vc_count; j++) {
+            _vc_state_masks[IDLE].set( i * vc_count + j);
+        }
     }
     _routing.resize( physical_ports_count);
     for ( i = 0; i < physical_ports_count; i++) {
-        _routing[i].resize( vc_count);
+        _routing[i].resize( vc_count, 0);
     }
     _selected_routing.resize( physical_ports_count);
     for ( i = 0; i < physical_ports_count; i++) {
@@ -101,9 +170,11 @@ ROUTER_OUTPUT::ROUTER_OUTPUT(long physical_ports_count, long vc_count,
     for ( long i = 0; i < physical_ports_count; i++) {
         _vc_usage[i].resize( vc_count, ROUTER_OUTPUT::FREE);
     }
-    _out_buffer.resize( physical_ports_count);
+    _out_buffer.resize( physical_ports_count, 
+        RING_QUEUE<FLIT_HANDLE>( output_buffer_size));
     _flit_state.resize( physical_ports_count);
-    _out_addr.resize( physical_ports_count);
+    _out_addr.resize( physical_ports_count, 
+        RING_QUEUE<VC_PAIR>( output_buffer_size));
     // each of the output ports has initially output_buffer_size 
     // space available;
     _local_counter.resize( physical_ports_count, output_buffer_size);
@@ -111,7 +182,7 @@ ROUTER_OUTPUT::ROUTER_OUTPUT(long physical_ports_count, long vc_count,
 
 void ROUTER_OUTPUT::remove_flit( long i)
 { 
-    _out_buffer[i].erase( _out_buffer[i].begin());
+    _out_buffer[i].pop_front();
     if ( _flit_state[i].size() > 0) { // this fixed a bug in the original vnoc;
         _flit_state[i].erase( _flit_state[i].begin() );
     }
@@ -125,35 +196,83 @@ void ROUTER_OUTPUT::remove_flit( long i)
 ////////////////////////////////////////////////////////////////////////////////
 
 ROUTER::ROUTER( long physical_ports_count, long vc_number, long buffer_size,
-                long out_buffer_size, const ADDRESS &address, long ary_size,
-                long flit_size, VNOC *owner_vnoc, long id, double link_length,
+                long out_buffer_size, const ADDRESS &address, long flit_size,
+                 VNOC *owner_vnoc, long id, double link_length,
                 PREDICTOR_TYPE predictor_type):
     _id(id),
     _address(address),
-    _input(physical_ports_count, vc_number),
+    _input(physical_ports_count, vc_number, buffer_size),
     _output(physical_ports_count, vc_number, buffer_size, out_buffer_size),
-    _power_module(physical_ports_count, vc_number, flit_size, link_length),
+    _power_module(owner_vnoc->power_models( physical_ports_count, vc_number,
+        link_length, (owner_vnoc->topology()->arbiter_type() == MATRIX_ARB) ? 
+        MATRIX_ARBITER : RR_ARBITER), physical_ports_count, vc_number, flit_size),
     _predictor_module( predictor_type, 
         owner_vnoc->topology()->control_period(),
-        owner_vnoc->topology()->history_window()),
-    _ary_size(ary_size), // "network size" in one dimension;
+        owner_vnoc->topology()->history_window(), physical_ports_count),
     _flit_size(flit_size),
     _physical_ports_count(physical_ports_count),
     _vc_number(vc_number),
     _buffer_size(buffer_size),
     _out_buffer_size(out_buffer_size),
     _total_delay(0.0),
-    _local_injection_time(0.0), // used only with tracefile traffic;
-    _local_injection_file()
+    _local_injection_time(0), // used only with tracefile traffic;
+    _local_injection_file(),
+    _vc_ab_requests( physical_ports_count * vc_number, 
+        BIT_VECTOR( physical_ports_count * vc_number)),
+    _vc_ab_out_mask( physical_ports_count * vc_number),
+    _vc_ab_request_vector( physical_ports_count * vc_number),
+    _vc_sel_candidates( physical_ports_count * vc_number),
+    _sw_ab_eligible( physical_ports_count, BIT_VECTOR( vc_number)),
+    _sw_ab_in_mask( physical_ports_count),
+    _sw_ab_requests( physical_ports_count, BIT_VECTOR( physical_ports_count)),
+    _sw_ab_out_mask( physical_ports_count),
+    _sw_ab_in_vc( physical_ports_count, 0),
+    _sw_ab_grants( physical_ports_count, BIT_VECTOR( physical_ports_count)),
+    _sw_ab_in_matched( physical_ports_count),
+    _sw_ab_out_matched( physical_ports_count),
+    _sw_ab_port_scratch( physical_ports_count),
+    _sw_ab_vc_scratch( vc_number),
+    _vc_sel_arbiters(),
+    _vc_ab_arbiters(),
+    _sw_in_arbiters(),
+    _sw_out_arbiters(),
+    _sw_accept_arbiters(),
+    _sw_wavefront_priority(0)
 {
     _vnoc = owner_vnoc;
+    _event_queue = _vnoc->event_queue();
+    _flit_pool = _vnoc->flit_pool();
+    long seed = _vnoc->topology()->rng_seed();
+    _rng.set_seed( seed, rng_stream( ROUTER_RNG_STREAM, id));
+
+    // arbiters of the allocators;
+    ARBITER_TYPE arbiter_type = _vnoc->topology()->arbiter_type();
+    long all_vcs = physical_ports_count * vc_number;
+    _vc_sel_arbiters.resize( all_vcs, ARBITER( arbiter_type, all_vcs));
+    _vc_ab_arbiters.resize( all_vcs, ARBITER( arbiter_type, all_vcs));
+    _sw_in_arbiters.resize( physical_ports_count, 
+        ARBITER( arbiter_type, vc_number));
+    _sw_out_arbiters.resize( physical_ports_count, 
+        ARBITER( arbiter_type, physical_ports_count));
+    _sw_accept_arbiters.resize( physical_ports_count, 
+        ARBITER( arbiter_type, physical_ports_count));
+    vector<ARBITER> *arbiters[] = { &_vc_sel_arbiters, &_vc_ab_arbiters,
+        &_sw_in_arbiters, &_sw_out_arbiters, &_sw_accept_arbiters };
+    long arbiter_index = 0;
+    for ( long k = 0; k < 5; k++) {
+        for ( long i = 0; i < long(arbiters[k]->size()); i++) {
+            (*arbiters[k])[i].set_rng_stream( seed, 
+                rng_stream( ARBITER_RNG_STREAM, (id << 16) + arbiter_index));
+            arbiter_index ++;
+        }
+    }
     _init_data.resize( flit_size);
     for (long i = 0; i < flit_size; i++) {
-        _init_data[i] = _vnoc->topology()->rng().flat_ull(0, ULLONG_MAX);
+        _init_data[i] = _rng.flat_ull(0, ULLONG_MAX);
     }
 
-    // set the routing algo for this router as required by user;
-    _routing_algo = _vnoc->topology()->routing_algo();
+    // routes of the routing algo required by user;
+    _network = _vnoc->network();
 
 
     // compute _overall_size_input_buffs; do not include local PE buffer;
@@ -168,7 +287,7 @@ ROUTER::ROUTER( long physical_ports_count, long vc_number, long buffer_size,
         // of these local files to each router are "conglomerated" into the
         // the "main" trace file too tests/bench;
         init_local_injection_file();
-        local_injection_file() >> _local_injection_time;
+        read_local_injection_time();
     }
     else if ( _vnoc->traffic_type() == IPCORE_TRAFFIC) {
 
@@ -192,8 +311,18 @@ ROUTER::ROUTER( long physical_ports_count, long vc_number, long buffer_size,
     // the links driven by output ports; only output ports 1..4 drive links;
     _can_send_on_link_after_time.resize( _physical_ports_count);
     for ( long i = 0; i < _physical_ports_count; i++) {
-        _can_send_on_link_after_time[i] = 0.0;
+        _can_send_on_link_after_time[i] = 0;
     }
+    // links are connected by the owner, once all routers are created;
+    _flit_links.resize( _physical_ports_count);
+    _credit_links.resize( _physical_ports_count);
+    _downstream_flit_links.resize( _physical_ports_count, 0);
+    _upstream_credit_links.resize( _physical_ports_count, 0);
+
+    // () routers start awake, with their first cycle at time 0;
+    _dormant = false;
+    _last_tick_time = 0;
+    _next_tick_time = 0;
 
     // stats about injected packets at this router;
     _inj_packet_counter = 0;
@@ -217,6 +346,15 @@ void ROUTER::init_local_injection_file()
     }
 }
 
+void ROUTER::read_local_injection_time()
+{
+    // injection times in trace files are in cycles; they are converted
+    // to ticks here, once;
+    double injection_time = 0.0;
+    local_injection_file() >> injection_time;
+    _local_injection_time = cycles_to_ticks( injection_time);
+}
+
 long ROUTER::receive_packet_from_local_trace_file()
 {
     // retrieve packets from individual trace files named for example
@@ -233,7 +371,7 @@ long ROUTER::receive_packet_from_local_trace_file()
     // stamps as start-time for thsoe flits from tracefile); 
     // this way makes for no flit actualy to be dropped;
     long num_packets_inj_here = 0;
-    double injection_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME injection_time = _event_queue->current_sim_time();
     long cube_size = _vnoc->topology()->cube_size();
     ADDRESS src_addr;
     ADDRESS des_addr;
@@ -250,7 +388,7 @@ long ROUTER::receive_packet_from_local_trace_file()
     // code difficult to understand; 
 
     while ( ( _input.injection_buff_full() == false) && 
-            ( _local_injection_time <= injection_time + S_ELPS)) {
+            ( _local_injection_time <= injection_time)) {
 
         src_addr.clear();
         des_addr.clear();
@@ -261,7 +399,7 @@ long ROUTER::receive_packet_from_local_trace_file()
             if ( local_injection_file().eof()) { return num_packets_inj_here; }
             src_addr.push_back(t);
         }
-        assert( src_addr[0] < _ary_size && src_addr[1] < _ary_size);
+        assert( _vnoc->check_address( src_addr));
 
         // read destination address;
         for ( long i = 0; i < cube_size; i++) {
@@ -269,15 +407,15 @@ long ROUTER::receive_packet_from_local_trace_file()
             if ( local_injection_file().eof()) { return num_packets_inj_here; }
             des_addr.push_back(t);
         }
-        assert( des_addr[0] < _ary_size && des_addr[1] < _ary_size);
+        assert( _vnoc->check_address( des_addr));
 
         // read packet size;
         local_injection_file() >> packet_size;
 
         // inject this packet: src_addr -> des_addr;
         inject_packet( _inj_packet_counter,
-            src_addr, 
-            des_addr, 
+            _vnoc->topology()->router_id( src_addr), 
+            _vnoc->topology()->router_id( des_addr), 
             _local_injection_time, packet_size);
         // tracks packets injected at this router across the entire simulation;
         _inj_packet_counter ++;
@@ -289,7 +427,7 @@ long ROUTER::receive_packet_from_local_trace_file()
         // get the local time as the first info on the next line
         // in the local-to-this router trace file;
         if ( !local_injection_file().eof()) {
-            local_injection_file() >> _local_injection_time;
+            read_local_injection_time();
             if ( local_injection_file().eof()) { return num_packets_inj_here; }
         }
     }
@@ -304,22 +442,18 @@ bool ROUTER::receive_packet_from_local_traffic_injector(long dest_id)
     // TRAFFIC_INJECTOR::simulate_one_traffic_injector();
 
     bool injected_a_packet_here = false;
-    double injection_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME injection_time = _event_queue->current_sim_time();
     long packet_size = _vnoc->topology()->packet_size();
 
-    ADDRESS des_addr;
-    // id = x * ny + y because of the way routers are indexed in the 2D mesh;
-    des_addr.push_back( dest_id / _vnoc->ny()); // x of dest;
-    des_addr.push_back( dest_id % _vnoc->ny()); // y of dest;
-    assert( des_addr[0] < _ary_size && des_addr[1] < _ary_size);
+    assert( dest_id >= 0 && dest_id < _vnoc->routers_count());
     
 
     if ( _input.injection_buff_full() == false) {
         // inject this packet into the input-port buffer of this router: 
         // src_addr -> des_addr;
-        inject_packet( _inj_packet_counter, // used as flit id;
-                       _address, // source address is this router;
-                       des_addr, // destination address has been decided inside the injector;
+        inject_packet( _inj_packet_counter, // used as packet id;
+                       _id, // source is this router;
+                       dest_id, // destination has been decided inside the injector;
                        injection_time,
                        packet_size);
 
@@ -332,18 +466,22 @@ bool ROUTER::receive_packet_from_local_traffic_injector(long dest_id)
     return injected_a_packet_here;
 }
 
-void ROUTER::inject_packet( long flit_id, ADDRESS &sor_addr, ADDRESS &des_addr,
-    double time, long packet_size)
+void ROUTER::inject_packet( long packet_id, long src_router_id, long des_router_id,
+    SIM_TIME time, long packet_size)
 {
+    if ( _dormant) {
+        wake_up();
+    }
+
     VC_PAIR vc_pair;
     for ( long l = 0; l < packet_size; l++) {
 
-        DATA flit_data; // vector<unsigned long long>;
+        DATA_ATOMIC_UNIT flit_data[FLIT_MAX_SIZE];
         for ( long i = 0; i < _flit_size; i++) {
             // recall that, by default, I work with flit_size of 1;
             _init_data[i] = static_cast<DATA_ATOMIC_UNIT>( // "make up stuff";
-                _init_data[i] * CORR_EFF + _vnoc->topology()->rng().flat_ull(0, ULLONG_MAX));
-            flit_data.push_back( _init_data[i]);
+                _init_data[i] * CORR_EFF + _rng.flat_ull(0, ULLONG_MAX));
+            flit_data[i] = _init_data[i];
         }
 
         if ( l == 0) {
@@ -364,33 +502,59 @@ void ROUTER::inject_packet( long flit_id, ADDRESS &sor_addr, ADDRESS &des_addr,
             if ( _input.input_buff(0, vc_pair.first).size() > BUFF_BOUND) {
                 _input.set_injection_buff_full();
             }
-            _input.add_flit( 0, (vc_pair.first),
-                             FLIT(flit_id, FLIT::HEADER, sor_addr, des_addr, time, flit_data));
-        }
-        else if ( l < packet_size - 1) {
-            _input.add_flit( 0, (vc_pair.first),
-                             FLIT(flit_id, FLIT::BODY, sor_addr, des_addr, time, flit_data));
         }
-        else { // l == packet_size - 1
-            _input.add_flit( 0, (vc_pair.first),
-                             FLIT(flit_id, FLIT::TAIL, sor_addr, des_addr, time, flit_data));
+        // the flit is written here, into the pool, once; from now on only
+        // its handle moves thru buffers and links;
+        FLIT::FLIT_TYPE flit_type = FLIT::BODY;
+        if ( l == 0) {
+            flit_type = FLIT::HEADER;
+        } else if ( l == packet_size - 1) {
+            flit_type = FLIT::TAIL;
         }
+        FLIT_HANDLE flit_h = new_flit();
+        flit( flit_h) = FLIT(l, packet_id, flit_type, src_router_id, des_router_id,
+                             time, flit_data, _flit_size);
+        _input.add_flit( 0, (vc_pair.first), flit_h);
         // power module writing here;
         if ( _vnoc->warmup_done() == true)
             _power_module.power_buffer_write(0, flit_data);
     }
 }
 
-void ROUTER::receive_flit_from_upstream(long port_id, long vc_id, FLIT &flit)
+FLIT_HANDLE ROUTER::new_flit()
 {
-    // receive flit from upstream (neighboring) router;
-    _input.add_flit( port_id, vc_id, flit);
+    // take a free handle; get more from the pool if none left;
+    if ( _free_flits.empty()) {
+        _flit_pool->get_batch( _free_flits);
+    }
+    FLIT_HANDLE flit_h = _free_flits.back();
+    _free_flits.pop_back();
+    return flit_h;
+}
 
-    // power module writing here;
-    if ( _vnoc->warmup_done() == true)
-        _power_module.power_buffer_write( port_id, flit.data());
+void ROUTER::delete_flit( FLIT_HANDLE flit_h)
+{
+    // routers that consume more than they inject give handles back;
+    _free_flits.push_back( flit_h);
+    if ( _free_flits.size() >= 2 * FLIT_BATCH_SIZE) {
+        _flit_pool->put_batch( _free_flits);
+    }
+}
+
+void ROUTER::receive_flit_from_upstream(long port_id, long vc_id, FLIT_HANDLE flit_h,
+    SIM_TIME arrival_time)
+{
+    // receive flit from upstream (neighboring) router; it is taken in at
+    // the cycle after its arrival;
+    _input.add_flit( port_id, vc_id, flit_h);
+    const FLIT &flit_t = flit( flit_h);
 
-    if ( flit.type() == FLIT::HEADER) {
+    // power module writing here; the buffer is written at arrival, which 
+    // may have been before warmup ended;
+    if ( arrival_time >= _event_queue->warmup_end_time())
+        _power_module.power_buffer_write( port_id, flit_t.data());
+
+    if ( flit_t.type() == FLIT::HEADER) {
         if ( _input.input_buff(port_id, vc_id).size() == 1) {
             // all right, we just added/stored this flit her in this
             // input-port id, vc index buffer; before this this vc buffer
@@ -423,26 +587,130 @@ void ROUTER::receive_flit_from_upstream(long port_id, long vc_id, FLIT &flit)
     }
 }
 
-void ROUTER::consume_flit(double time, const FLIT &flit)
+void ROUTER::consume_flit(SIM_TIME time, FLIT_HANDLE flit_h)
 {
     // receive (i.e., consume) one flit at the destination router;
-    if ( flit.type() == FLIT::TAIL) {
+    // its slot in the pool is freed;
+    const FLIT &flit_t = flit( flit_h);
+    if ( flit_t.type() == FLIT::TAIL) {
 
         if ( _vnoc->warmup_done()) {
             _vnoc->incr_packets_arrived_count_after_wu();
             // Note: flit.start_time() is the real time when this flit
             // was injected into the PE input buffer at the source router;
-            double delta_delay = time - flit.start_time();
+            double delta_delay = ticks_to_cycles( time - flit_t.start_time());
             update_total_delay( delta_delay);
         }
     }
+    delete_flit( flit_h);
 }
 
 void ROUTER::receive_credit(long i, long j)
 {
+    // Note: dormant routers have no credits pending;
     _output.counter_next_r_inc(i, j);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// links
+//
+////////////////////////////////////////////////////////////////////////////////
+
+void LINK::init( unsigned long capacity, ROUTER *receiver, long receiver_port,
+    long stages)
+{
+    // capacity must be a power of 2;
+    assert( (capacity & (capacity - 1)) == 0);
+    _slots.assign( capacity, LINK_SLOT());
+    _mask = capacity - 1;
+    _head = 0;
+    _tail = 0;
+    _receiver = receiver;
+    _receiver_port = receiver_port;
+    _stages = stages;
+}
+
+void LINK::push( const LINK_SLOT &slot)
+{
+    // sender side; the slot is written before the new tail is published;
+    unsigned long tail = _tail;
+    unsigned long head = __atomic_load_n( &_head, __ATOMIC_ACQUIRE);
+    if ( tail - head > _mask) {
+        printf("\nError: link to port %ld of router %ld is full.\n",
+            _receiver_port, _receiver->id());
+        exit(1);
+    }
+    _slots[ tail & _mask] = slot;
+    __atomic_store_n( &_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+void ROUTER::connect_to_neighbor( long port_id, ROUTER *neighbor, long neighbor_port_id)
+{
+    // flits from output port "port_id" of this router go to input port
+    // "neighbor_port_id" of the neighbor; credits from input port "port_id"
+    // go back to output port "neighbor_port_id" of the neighbor; both 
+    // links belong to the neighbor, which takes in what comes thru them;
+    unsigned long capacity = 1;
+    while ( capacity < (unsigned long)(_vc_number * _buffer_size)) {
+        capacity *= 2;
+    }
+    long stages = _network->link_stages( _id, port_id);
+    neighbor->flit_link( neighbor_port_id).init( capacity, neighbor, 
+        neighbor_port_id, stages);
+    neighbor->credit_link( neighbor_port_id).init( capacity, neighbor, 
+        neighbor_port_id, stages);
+    _downstream_flit_links[ port_id] = &neighbor->flit_link( neighbor_port_id);
+    _upstream_credit_links[ port_id] = &neighbor->credit_link( neighbor_port_id);
+}
+
+void ROUTER::send_on_link( LINK *link, long vc, FLIT_HANDLE flit_h, SIM_TIME delay)
+{
+    // the flit (or credit) arrives after "delay" for each stage of the 
+    // link plus one; a new flit can be sent after one wire delay; a
+    // dormant receiver simulated by this same thread (i.e., with the
+    // same simulation-queue) wakes up now and does empty cycles till
+    // then; others are woken up by their engine (see PDES_ENGINE);
+    SIM_TIME current_sim_time = _event_queue->current_sim_time();
+    link->push( LINK_SLOT( current_sim_time + (link->stages() + 1) * delay,
+        current_sim_time, _id, vc, flit_h));
+    ROUTER *receiver = link->receiver();
+    if ( receiver->event_queue() == _event_queue && receiver->dormant()) {
+        receiver->wake_up();
+    }
+}
+
+void ROUTER::receive_from_links()
+{
+    // take in the flits and credits that come before this cycle in the
+    // order of the simulation-queue (see EVENT_KEY); each link keeps
+    // them in the order they were sent;
+    const EVENT_KEY &cycle_key = _event_queue->current_event_key();
+    for ( long i = 1; i < _physical_ports_count; i++) {
+        const LINK_SLOT *slot;
+        while ( ( slot = _flit_links[i].front()) != 0 &&
+            EVENT_KEY( slot->_arrival_time, slot->_sent_time, slot->_sender_id) < cycle_key) {
+            receive_flit_from_upstream( i, slot->_vc, slot->_flit, slot->_arrival_time);
+            _flit_links[i].pop();
+        }
+        while ( ( slot = _credit_links[i].front()) != 0 &&
+            EVENT_KEY( slot->_arrival_time, slot->_sent_time, slot->_sender_id) < cycle_key) {
+            receive_credit( i, slot->_vc);
+            _credit_links[i].pop();
+        }
+    }
+}
+
+bool ROUTER::flit_links_empty() const
+{
+    for ( long i = 1; i < _physical_ports_count; i++) {
+        if ( !_flit_links[i].empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // simulation of one router
@@ -462,20 +730,23 @@ void ROUTER::simulate_one_router()
     // it is this trick of calling these function in reverse order that makes for 
     // the data to go thru router pipe stages in order and taking each a clock cycle;
 
+    // () flits and credits that arrived since the previous cycle;
+    receive_from_links();
+
     // () stage 5: 
     // flits (if any) from output ports of this router are sent out 
     // to their downstream router destinations; flits travel on physical 
     // links here;
-    // Note: it inserts link-events into simulation queue; these events will
-    // be consumed later, after wire-delay, to "mimic" real delay on wire;
+    // Note: it adds flits to the links; the downstream routers take them 
+    // in later, after wire-delay, to "mimic" real delay on wire;
     send_flits_via_physical_link();
 
     // () stage 4: 
     // get flits (if any) from input buffers of this router, from their
     // vc's, and get them thru the crossbar switch to the output ports buffers
     // where they must be routed;
-    // Note: it inserts credit-events into simulation queue; these credit events will
-    // be consumed later, after credit-delay, to "mimic" real delay of credit
+    // Note: it adds credits to the links; the upstream routers take them 
+    // in later, after credit-delay, to "mimic" real delay of credit
     // signal flying back on control-wires to the upstream router;
     send_flit_to_out_buffer_SW_TR();
 
@@ -495,13 +766,17 @@ void ROUTER::simulate_one_router()
 
 
     // () stage 1: routing computation decision;
-    // Note: it inserts credit-events into simulation queue; these credit events will
-    // be consumed later, after credit-delay, to "mimic" real delay of credit
+    // Note: it adds credits to the links; the upstream routers take them 
+    // in later, after credit-delay, to "mimic" real delay of credit
     // signal flying back on control-wires to the upstream router;
     routing_decision_stage_RC();
 
 
+    maintain_dvfs_prediction();
+}
 
+void ROUTER::maintain_dvfs_prediction()
+{
     if ( _vnoc->topology()->do_dvfs() == true) {
 
         // () make prediction for what's gonna be like in the next 
@@ -519,13 +794,118 @@ void ROUTER::simulate_one_router()
 
 
         // for debugging only;
-        //if (_vnoc->event_queue()->current_sim_time() > 5000)
+        //if (_event_queue->current_sim_time() > 5000)
         //set_frequencies_and_vdd( DVFS_THROTTLE_2);
         //_predictor_module.update_DVFS_settings( this);
     }
 
 }
 
+SIM_TIME ROUTER::clock_period( DVFS_LEVEL level) const
+{
+    // time between two consecutive simulation cycles of a router;
+    return _vnoc->topology()->dvfs_clock_period( level);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// dormant routers
+//
+////////////////////////////////////////////////////////////////////////////////
+
+bool ROUTER::is_quiescent() const
+{
+    // a router has nothing to do if all its input and output buffers are
+    // empty, no flit is on its way here and it does not wait for any 
+    // credits (i.e., all downstream input buffers are seen as empty); then,
+    // it stays like this until a flit is sent to it or a packet is 
+    // injected by its PE;
+    if ( !flit_links_empty()) {
+        return false;
+    }
+    for ( long i = 0; i < _physical_ports_count; i++) {
+        if ( _output.out_buffer(i).size() > 0) {
+            return false;
+        }
+        for ( long j = 0; j < _vc_number; j++) {
+            if ( _input.input_buff(i, j).size() > 0 ||
+                 _output.counter_next_r(i, j) != _buffer_size) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ROUTER::go_dormant( SIM_TIME last_tick_time, SIM_TIME next_tick_time)
+{
+    // called instead of adding the ROUTER_SINGLE event for the next cycle
+    // of this router; the cycles it skips are "simulated" later, by
+    // catch_up_dormant_cycles(), as cycles of a router with empty buffers:
+    // nothing goes thru the pipeline, only the clock energy is recorded
+    // and the dvfs predictor does its bookkeeping (buffer and link
+    // utilizations are zero); in this way results are the same as if the
+    // router was simulated each cycle;
+    // Note: routers go dormant only after warmup, when each of their
+    // cycles records clock energy;
+    _dormant = true;
+    _last_tick_time = last_tick_time;
+    _next_tick_time = next_tick_time;
+}
+
+EVENT_KEY ROUTER::next_tick_key() const
+{
+    // the key the ROUTER_SINGLE event of the next cycle of this router 
+    // would have had in the simulation-queue; see EVENT_KEY;
+    return EVENT_KEY( _next_tick_time, _last_tick_time, _id);
+}
+
+void ROUTER::simulate_dormant_cycle()
+{
+    // same as VNOC::receive_EVENT_ROUTER_SINGLE() for a router with
+    // nothing in its buffers;
+    DVFS_LEVEL this_dvfs_level_prev = _dvfs_level_prev;
+    maintain_dvfs_prediction(); // possibly sets new dvfs;
+    _power_module.power_clock_record();
+    _dvfs_level_prev = _dvfs_level;
+    _last_tick_time = _next_tick_time;
+    _next_tick_time = _next_tick_time + clock_period( this_dvfs_level_prev);
+}
+
+void ROUTER::catch_up_dormant_cycles( const EVENT_KEY &bound)
+{
+    // simulate the skipped cycles that come before "bound" in the
+    // simulation-queue order; without dvfs, they are all the same and
+    // only count clock cycles; so, those that start before "bound" are
+    // recorded at once; one more may start at the same time as "bound";
+    assert( _dormant);
+    if ( _vnoc->topology()->do_dvfs() == false && 
+        _next_tick_time < bound._start_time) {
+        SIM_TIME period = clock_period( _dvfs_level_prev);
+        SIM_TIME cycles = 
+            ( bound._start_time - _next_tick_time + period - 1) / period;
+        _power_module.power_clock_record( cycles);
+        _last_tick_time = _next_tick_time + ( cycles - 1) * period;
+        _next_tick_time = _next_tick_time + cycles * period;
+    }
+    while ( next_tick_key() < bound) {
+        simulate_dormant_cycle();
+    }
+}
+
+void ROUTER::wake_up()
+{
+    // something arrived at this dormant router while processing the
+    // current event of the simulation-queue; catch up with the cycles
+    // skipped so far and put the next cycle back into the queue, with
+    // the same key it would have had if it never went dormant;
+    catch_up_dormant_cycles( _event_queue->current_event_key());
+    _dormant = false;
+    EVENT next_cycle( EVENT::ROUTER_SINGLE, _next_tick_time, _id);
+    next_cycle.set_issued( _last_tick_time, _id);
+    _event_queue->add_issued_event( next_cycle);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // send_flits_via_physical_link
@@ -547,8 +927,8 @@ void ROUTER::send_flit_via_physical_link( long i)
     //  0   3
     // example: i=3, then to_port_id=4 because flit is sent South to
     // port id 4 of the downstream router below;
-    // Note: it inserts link-events into simulation queue; these events will
-    // be consumed later, after wire-delay, to "mimic" real delay on wire;
+    // Note: it adds flits to the link; the downstream router takes them
+    // in later, after wire-delay, to "mimic" real delay on wire;
     // 
     // Note: this is the way routers are indexed for a 4x4 NoC:
     //  3      7    11     15
@@ -561,43 +941,27 @@ void ROUTER::send_flit_via_physical_link( long i)
     // (0,1) (1,1) (2,1) (3,1) 
     // (0,0) (1,0) (2,0) (3,0)
 
-    double current_sim_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME current_sim_time = _event_queue->current_sim_time();
     if ( _output.out_buffer(i).size() > 0) {
-        long to_router_id = -1;
-        long to_port_id = -1;
-        if ( i == 1) {
-            to_router_id = _id - _ary_size; // West neighbor
-            to_port_id = 2;
-        } else if ( i == 2) {
-            to_router_id = _id + _ary_size; // East neighbor
-            to_port_id = 1;
-        } else if ( i == 3) {
-            assert( (_id % _ary_size) > 0);
-            to_router_id = _id - 1; // South neighbor
-            to_port_id = 4;            
-        } else { // i == 4
-            to_router_id = _id + 1; // North neighbor
-            assert( (to_router_id % _ary_size) > 0);
-            to_port_id = 3;
-        } // there should be no other case; assumption: just 2D meshes;
-        assert( to_router_id >= 0 && to_router_id < _vnoc->routers_count());
+        // there should be no link at the edges of the mesh; 
+        // assumption: just 2D meshes;
+        LINK *link = _downstream_flit_links[i];
+        assert( link != 0);
          
-        FLIT flit_t( _output.get_flit(i));
+        FLIT_HANDLE flit_h = _output.get_flit(i);
         VC_PAIR outadd_t = _output.get_addr(i);
 
         // power stuff here;
         if ( _vnoc->warmup_done() == true)
-            _power_module.power_link_traversal( i, flit_t.data());
+            _power_module.power_link_traversal( i, flit( flit_h).data());
 
         _output.remove_flit(i);
         _output.remove_addr(i);
         
-        // add a link event to the simulation queue; this will be processed
-        // at the downstream router as a flit arrival that took _wire_delay 
-        // to traverse the link;
-        _vnoc->event_queue()->add_event( 
-            EVENT(EVENT::LINK, (current_sim_time + _wire_delay), 
-            to_router_id, to_port_id, outadd_t.second, flit_t) );
+        // add the flit to the link; it will be taken in by the downstream 
+        // router as a flit arrival that took _wire_delay (for each stage)
+        // to traverse the link; the link carries only the flit handle;
+        send_on_link( link, outadd_t.second, flit_h, _wire_delay);
 
         // record that a flit has been sent over this link, for 
         // LU calculation purposes; this basically increments
@@ -615,7 +979,7 @@ void ROUTER::send_flit_via_physical_link( long i)
     // this is replaced with the above, which is simpler and works for 2D meshes;
     // this version here is more generic, and trickier to understand too;
     // currently this is not used;  
-    double current_sim_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME current_sim_time = _event_queue->current_sim_time();
     if ( _output.out_buffer(i).size() > 0) {
         ADDRESS to_address = _address;
         long to_port_id;
@@ -645,7 +1009,7 @@ void ROUTER::send_flit_via_physical_link( long i)
         // add a link event to the simulation queue; this will be processed
         // at the downstream router as a flit arrival that took _wire_delay 
         // to traverse the link;
-        _vnoc->event_queue()->add_event( EVENT(EVENT::LINK,
+        _event_queue->add_event( EVENT(EVENT::LINK,
             (current_sim_time + _wire_delay), to_address, to_port_id,
             outadd_t.second, flit_t));
 
@@ -665,7 +1029,7 @@ void ROUTER::send_flits_via_physical_link()
     // TODO: if user selects zero size for output-port buffers, then
     // this function must be combined with the SW_TR phase;
 
-    double current_sim_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME current_sim_time = _event_queue->current_sim_time();
     for ( long i = 1; i < _physical_ports_count; i++) {
     
         // send only if enough time elapssed from last transmission
@@ -691,8 +1055,8 @@ void ROUTER::send_flit_to_out_buffer_SW_TR()
 {
     // this is basically switch traversal SW_TR phase!
     // send flit to the output buffer after the SA_AB took place;
-    // Note: it inserts credit-events into simulation queue; these credit events will
-    // be consumed later, after wire-delay, to "mimic" real delay on wire
+    // Note: it adds credits to the links; the upstream routers take them
+    // in later, after credit-delay, to "mimic" real delay on wire
     // back to the upstream router;
 
     for ( long i = 0; i < _physical_ports_count; i++) {
@@ -710,10 +1074,9 @@ void ROUTER::send_flit_to_out_buffer_SW_TR()
                 // counter here;
                 _output.counter_next_r_dec(sel_routing.first, sel_routing.second);
 
-                // if this is not a flit from local PE, create and add a credit
-                // event to the simulation queue; this will let the upstream
-                // router that an empty slot became available here;
-                double event_time = _vnoc->event_queue()->current_sim_time();
+                // if this is not a flit from local PE, send a credit back
+                // thru the link; this will let the upstream router know
+                // that an empty slot became available here;
                 if (i > 0) { // meaning != 0;
                     /*---
                     // this is replaced with what's next to it, which is simpler
@@ -733,41 +1096,23 @@ void ROUTER::send_flit_to_out_buffer_SW_TR()
                             cre_add_t[(i-1)/2] = _ary_size - 1;
                         }
                     }
-                    _vnoc->event_queue()->add_event( EVENT(EVENT::CREDIT,
+                    _event_queue->add_event( EVENT(EVENT::CREDIT,
                         event_time + _credit_delay, _address, cre_add_t, cre_pc_t, j));
                     ---*/
 
-                    long to_router_id = -1;
-                    long to_port_id = -1;
-                    // if the destination is to the right, send credit to
-                    // left and vice-versa; if it's up, send it down and vice-versa;
-                    if ( i == 1) {
-                        to_router_id = _id - _ary_size; // West neighbor
-                        to_port_id = 2;
-                    } else if ( i == 2) {
-                        to_router_id = _id + _ary_size; // East neighbor
-                        to_port_id = 1;
-                    } else if ( i == 3) {
-                        assert( (_id % _ary_size) > 0);
-                        to_router_id = _id - 1; // South neighbor
-                        to_port_id = 4;            
-                    } else { // i == 4
-                        to_router_id = _id + 1; // North neighbor
-                        assert( (to_router_id % _ary_size) > 0);
-                        to_port_id = 3;
-                    } // there should be no other case; assumption: just 2D meshes;
-                    assert( to_router_id >= 0 && to_router_id < _vnoc->routers_count());
-
-                    _vnoc->event_queue()->add_event( 
-                        EVENT(EVENT::CREDIT, (event_time + _credit_delay),
-                        to_router_id, to_port_id, j)); // j is VC index;
+                    // the credit goes back thru the link of input port "i"
+                    // to the upstream router; 
+                    assert( _upstream_credit_links[i] != 0);
+                    send_on_link( _upstream_credit_links[i], j, 0, // j is VC index;
+                        _credit_delay);
                 }
 
                 // pick up the flit to be sent over the crossbar switch; erase it from
                 // input buffer;
                 long in_size_t = _input.input_buff(i,j).size();
                 assert(in_size_t >= 1);
-                FLIT flit_t( _input.get_flit(i,j));
+                FLIT_HANDLE flit_h = _input.get_flit(i,j);
+                const FLIT &flit_t = flit( flit_h);
                 _input.remove_flit(i, j);
 
                 // power stuff here;
@@ -779,7 +1124,7 @@ void ROUTER::send_flit_to_out_buffer_SW_TR()
                 // Note: output buffer is not organized by virtual channels like
                 // the input buffers; all flits from various vc indices of various 
                 // input ports are stored in the output buffer; 
-                _output.add_flit(sel_routing.first, flit_t);
+                _output.add_flit(sel_routing.first, flit_h);
 
                 // if we just shipped over crossbar a flit coming from the local PE
                 // and if happened that the PE input buffer was full, then now - because
@@ -860,49 +1205,206 @@ void ROUTER::sw_arbitration_stage_SW_AB()
     // this is basically switch arbitration SW_AB phase!
     // switch arbitration pipeline stage; processes all input ports
     // at the same time;
+    const BIT_VECTOR &sw_ab_mask = _input.vc_state_mask(SW_AB);
+    if ( sw_ab_mask.none()) {
+        return;
+    }
 
-    // (1) build map;
-    map<long, vector<VC_PAIR> > vc_o_map;
-    for ( long i = 0; i < _physical_ports_count; i++) {
-        vector<long> vc_i_t;
-        for ( long j = 0; j < _vc_number; j++) {
-            if ( _input.vc_state(i, j) == SW_AB) {
-                VC_PAIR out_t = _input.selected_routing(i, j);
-                if (( _output.counter_next_r(out_t.first, out_t.second) > 0) &&
-                    ( _output.local_counter(out_t.first) > 0)) {
-                    vc_i_t.push_back(j);
-                }
+    // (1) find the vc's in SW_AB state that can send (there is room 
+    // downstream and in the output buffer); these are the ones that
+    // take part in the allocation;
+    for ( long k = sw_ab_mask.find_first(); k >= 0; k = sw_ab_mask.find_next(k)) {
+        long i = k / _vc_number;
+        long j = k % _vc_number;
+        VC_PAIR out_t = _input.selected_routing(i, j);
+        if (( _output.counter_next_r(out_t.first, out_t.second) > 0) &&
+            ( _output.local_counter(out_t.first) > 0)) {
+            _sw_ab_eligible[i].set(j);
+            _sw_ab_in_mask.set(i);
+        }
+    }
+    if ( _sw_ab_in_mask.none()) {
+        return;
+    }
+
+    // (2) match input ports to output ports; each match moves one vc 
+    // of the input port into SW_TR state;
+    switch ( _vnoc->topology()->sw_allocator_type()) {
+    case SEPARABLE_OUTPUT_FIRST:
+        sw_allocator_output_first( 1);
+        break;
+    case ISLIP_ALLOCATOR:
+        sw_allocator_output_first( _vnoc->topology()->islip_iterations());
+        break;
+    case WAVEFRONT_ALLOCATOR:
+        sw_allocator_wavefront();
+        break;
+    default: // SEPARABLE_INPUT_FIRST
+        sw_allocator_input_first();
+        break;
+    }
+
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        _sw_ab_eligible[i].clear();
+    }
+    _sw_ab_in_mask.clear();
+}
+
+void ROUTER::sw_allocator_input_first()
+{
+    // (1) each input port puts forward one of its vc's that can send;
+    // record it as a request for the output port where the vc goes;
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        long j = _sw_in_arbiters[i].arbitrate( _sw_ab_eligible[i]);
+        long out_port = _input.selected_routing(i, j).first;
+        _sw_ab_in_vc[i] = j;
+        _sw_ab_requests[out_port].set(i);
+        _sw_ab_out_mask.set(out_port);
+    }
+
+    // (2) go thru each output port; if it is "desired" by more input ports, 
+    // then arbitrate it and give it to one of the input ports that 
+    // compete for it; 
+    for ( long o = _sw_ab_out_mask.find_first(); o >= 0; 
+          o = _sw_ab_out_mask.find_next(o)) {
+        BIT_VECTOR &requests = _sw_ab_requests[o];
+        long in_win = _sw_out_arbiters[o].arbitrate( requests);
+        // only the arbiters whose choice won are updated;
+        _sw_out_arbiters[o].update( in_win);
+        _sw_in_arbiters[in_win].update( _sw_ab_in_vc[in_win]);
+        _input.vc_state_update(in_win, _sw_ab_in_vc[in_win], SW_TR);
+        requests.clear();
+    }
+    _sw_ab_out_mask.clear();
+}
+
+void ROUTER::sw_allocator_output_first( long iterations)
+{
+    // separable output first allocator; with more than one iteration this
+    // is iSLIP: input and output ports left unmatched after an iteration
+    // try again during the next one; arbiters are updated only with
+    // matches made during the first iteration;
+
+    // (1) each input port requests all output ports its vc's go to;
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        const BIT_VECTOR &eligible = _sw_ab_eligible[i];
+        for ( long j = eligible.find_first(); j >= 0; j = eligible.find_next(j)) {
+            long out_port = _input.selected_routing(i, j).first;
+            _sw_ab_requests[out_port].set(i);
+            _sw_ab_out_mask.set(out_port);
+        }
+    }
+
+    for ( long iter = 0; iter < iterations; iter++) {
+        // (2) each unmatched output port grants one of the unmatched
+        // input ports that requested it;
+        bool granted = false;
+        for ( long o = _sw_ab_out_mask.find_first(); o >= 0; 
+              o = _sw_ab_out_mask.find_next(o)) {
+            if ( _sw_ab_out_matched.test(o)) {
+                continue;
             }
+            _sw_ab_port_scratch = _sw_ab_requests[o];
+            _sw_ab_port_scratch.and_not( _sw_ab_in_matched);
+            long in_win = _sw_out_arbiters[o].arbitrate( _sw_ab_port_scratch);
+            if ( in_win >= 0) {
+                _sw_ab_grants[in_win].set(o);
+                granted = true;
+            }
+        }
+        if ( granted == false) {
+            break;
         }
-        long vc_size_t = vc_i_t.size();
-        if ( vc_size_t > 1) {
-            long win_t = _vnoc->topology()->rng().flat_l(0, vc_size_t);
-            VC_PAIR r_t = _input.selected_routing(i, vc_i_t[win_t]);
-            vc_o_map[r_t.first].push_back(VC_PAIR(i, vc_i_t[win_t]));
-        } else if ( vc_size_t == 1) {
-            VC_PAIR r_t = _input.selected_routing(i, vc_i_t[0]);
-            vc_o_map[r_t.first].push_back(VC_PAIR(i, vc_i_t[0]));
+
+        // (3) each input port that got grants accepts one of them;
+        for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+              i = _sw_ab_in_mask.find_next(i)) {
+            BIT_VECTOR &grants = _sw_ab_grants[i];
+            long out_win = _sw_accept_arbiters[i].arbitrate( grants);
+            if ( out_win < 0) {
+                continue;
+            }
+            if ( iter == 0) {
+                _sw_out_arbiters[out_win].update(i);
+                _sw_accept_arbiters[i].update( out_win);
+            }
+            _sw_ab_in_matched.set(i);
+            _sw_ab_out_matched.set( out_win);
+            sw_allocator_grant( i, out_win);
+            grants.clear();
         }
     }
 
-    if ( vc_o_map.size() == 0) {
-        return;
+    for ( long o = _sw_ab_out_mask.find_first(); o >= 0; 
+          o = _sw_ab_out_mask.find_next(o)) {
+        _sw_ab_requests[o].clear();
     }
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        _sw_ab_grants[i].clear();
+    }
+    _sw_ab_out_mask.clear();
+    _sw_ab_in_matched.clear();
+    _sw_ab_out_matched.clear();
+}
 
-    // (2) go thru each output port; if the map has recorded that this output
-    // port is "desired" by more input ports, then arbitrate it and give it
-    // randomly to an input port that competes for it; 
-    for ( long i = 0; i < _physical_ports_count; i++) {
-        long vc_size_t = vc_o_map[i].size();
-        if ( vc_size_t > 0) {
-            VC_PAIR vc_win = vc_o_map[i][0];
-            if ( vc_size_t > 1) { // if more than 1 pi
-                vc_win = vc_o_map[i][ _vnoc->topology()->rng().flat_l(0, vc_size_t) ];
+void ROUTER::sw_allocator_wavefront()
+{
+    // wavefront allocator: the request matrix (input port i, output port o)
+    // is swept one diagonal (i + o) mod ports at a time, starting with the
+    // diagonal that has highest priority; a request is granted if neither
+    // its row nor its column was granted already; the priority diagonal
+    // rotates every time the allocator is used;
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        const BIT_VECTOR &eligible = _sw_ab_eligible[i];
+        for ( long j = eligible.find_first(); j >= 0; j = eligible.find_next(j)) {
+            _sw_ab_grants[i].set( _input.selected_routing(i, j).first);
+        }
+    }
+
+    long ports = _physical_ports_count;
+    for ( long d = 0; d < ports; d++) {
+        long diagonal = (_sw_wavefront_priority + d) % ports;
+        for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+              i = _sw_ab_in_mask.find_next(i)) {
+            long o = (diagonal - i + ports) % ports;
+            if ( _sw_ab_grants[i].test(o) && !_sw_ab_in_matched.test(i) &&
+                 !_sw_ab_out_matched.test(o)) {
+                _sw_ab_in_matched.set(i);
+                _sw_ab_out_matched.set(o);
+                sw_allocator_grant( i, o);
             }
-            _input.vc_state_update(vc_win.first, vc_win.second, SW_TR);
-            FLIT &flit_t = _input.get_flit(vc_win.first, vc_win.second);
         }
     }
+    _sw_wavefront_priority = (_sw_wavefront_priority + 1) % ports;
+
+    for ( long i = _sw_ab_in_mask.find_first(); i >= 0; 
+          i = _sw_ab_in_mask.find_next(i)) {
+        _sw_ab_grants[i].clear();
+    }
+    _sw_ab_in_matched.clear();
+    _sw_ab_out_matched.clear();
+}
+
+void ROUTER::sw_allocator_grant( long i, long o)
+{
+    // input port "i" was matched to output port "o"; pick one of its vc's 
+    // that can send and that go to "o", and move it to SW_TR state;
+    const BIT_VECTOR &eligible = _sw_ab_eligible[i];
+    for ( long j = eligible.find_first(); j >= 0; j = eligible.find_next(j)) {
+        if ( _input.selected_routing(i, j).first == o) {
+            _sw_ab_vc_scratch.set(j);
+        }
+    }
+    long j = _sw_in_arbiters[i].arbitrate( _sw_ab_vc_scratch);
+    assert( j >= 0);
+    _sw_in_arbiters[i].update(j);
+    _input.vc_state_update(i, j, SW_TR);
+    _sw_ab_vc_scratch.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -919,108 +1421,130 @@ pair<long, long> ROUTER::vc_selection(long i, long j)
     // from among the free ones;
     // choose one of the candidate routing vc;
 
-    // (1) first get all free potential vc candidates;
-    vector<VC_PAIR > &vc_candidates = _input.routing(i, j);
+    // (1) first count all free potential vc candidates;
+    const vector<VC_PAIR> &vc_candidates = _input.routing(i, j);
     long r_size_t = vc_candidates.size();
     assert( r_size_t > 0);
-    vector<VC_PAIR > vc_that_are_free;
-
-    for ( long i = 0; i < r_size_t; i++) {
-        VC_PAIR v_t = vc_candidates[i];
-        if ( _vnoc->topology()->vc_sharing_mode() == SHARED) {
-            // if shared mode, then the buffer of a vc can be used by 
-            // multiple flits of different packets;
-            if ( _output.vc_usage(v_t.first, v_t.second) == ROUTER_OUTPUT::FREE) {
-                vc_that_are_free.push_back(vc_candidates[i]);
-            }
-        } else { // NOT_SHARED
-            // if not in shared mode vc selection will go thru only if 
-            // the downstream buffer of this vc is really empty; only in that
-            // case it is included in the list from which the random pick will
-            // be made;
-            if ( _output.counter_next_r(v_t.first, v_t.second) == _buffer_size) {
-                if (  _output.vc_usage(v_t.first, v_t.second) == ROUTER_OUTPUT::FREE) {
-                    vc_that_are_free.push_back(vc_candidates[i]);
-                }
+    if ( _vc_sel_arbiters[i * _vc_number + j].type() != RANDOM_ARB) {
+        // the arbiter of this input vc picks among the free candidates;
+        for ( long k = 0; k < r_size_t; k++) {
+            if ( vc_is_free_for_selection( vc_candidates[k])) {
+                _vc_sel_candidates.set( 
+                    vc_candidates[k].first * _vc_number + vc_candidates[k].second);
             }
         }
+        long o_k = _vc_sel_arbiters[i * _vc_number + j].arbitrate( _vc_sel_candidates);
+        _vc_sel_candidates.clear();
+        if ( o_k < 0) {
+            return VC_PAIR(-1, -1);
+        }
+        return VC_PAIR(o_k / _vc_number, o_k % _vc_number);
+    }
+    long free_size_t = 0;
+    for ( long k = 0; k < r_size_t; k++) {
+        if ( vc_is_free_for_selection( vc_candidates[k])) {
+            free_size_t ++;
+        }
+    }
+    if ( free_size_t == 0) {
+        return VC_PAIR(-1, -1);
     }
 
     // (2) then, pick out one randomly;
-    r_size_t = vc_that_are_free.size();
     long vc_t = 0;
-    if ( r_size_t > 0) {
-        if ( r_size_t > 1) {
-            vc_t = _vnoc->topology()->rng().flat_l(0, r_size_t);
+    if ( free_size_t > 1) {
+        vc_t = _rng.flat_l(0, free_size_t);
+    }
+    for ( long k = 0; k < r_size_t; k++) {
+        if ( vc_is_free_for_selection( vc_candidates[k])) {
+            if ( vc_t == 0) {
+                // return pair of output port id, and vc index;
+                return vc_candidates[k];
+            }
+            vc_t --;
         }
-        // return pair of output port id, and vc index;
-        return (vc_that_are_free[vc_t]);
-    } else {
-        return VC_PAIR(-1, -1);
     }
+    assert(0);
+    return VC_PAIR(-1, -1);
+}
+
+bool ROUTER::vc_is_free_for_selection(const VC_PAIR &v_t) const
+{
+    if ( _vnoc->topology()->vc_sharing_mode() == SHARED) {
+        // if shared mode, then the buffer of a vc can be used by 
+        // multiple flits of different packets;
+        return ( _output.vc_usage(v_t.first, v_t.second) == ROUTER_OUTPUT::FREE);
+    }
+    // NOT_SHARED: if not in shared mode vc selection will go thru only if 
+    // the downstream buffer of this vc is really empty; only in that
+    // case it is included in the list from which the random pick will
+    // be made;
+    return ( _output.counter_next_r(v_t.first, v_t.second) == _buffer_size &&
+        _output.vc_usage(v_t.first, v_t.second) == ROUTER_OUTPUT::FREE);
 }
 
 void ROUTER::vc_arbitration_stage_VC_AB()
 {
-    // (1) go thru all input ports and thru all their vc indices;
-    // if any vc state is VC_AB then process and record in map;
-    map<VC_PAIR, vector<VC_PAIR> > vc_o_i_map;
-    DATA_ATOMIC_UNIT vc_request = 0;
+    const BIT_VECTOR &vc_ab_mask = _input.vc_state_mask(VC_AB);
+    if ( vc_ab_mask.none()) {
+        return;
+    }
 
-    for ( long i = 0; i < _physical_ports_count; i++) {
-        for ( long j = 0; j < _vc_number; j++) {
-            if ( _input.vc_state(i, j) == VC_AB) {
-                // pick out a vc index from among those that are
-                // free of the output port where this flit has to go;
-                // vc_pair is a pair of (output port id, and vc index), where
-                // the vc index is the free vc index of input buffers of
-                // downstream router;
-                VC_PAIR vc_pair = vc_selection(i,j);
-                if ((vc_pair.first >= 0) && (vc_pair.second >= 0)) {
-                    // output port id, vc index is "desired" also by
-                    // i,j; so record this in map that stores al i,j
-                    // that "want" this output port id, vc index;
-                    vc_o_i_map[vc_pair].push_back(VC_PAIR(i, j));
-                    vc_request = vc_request | VC_MASK[i * _vc_number + j];
-                }
-            }
+    // (1) go thru all input vc's whose state is VC_AB; each picks a free
+    // output vc and records a request for it; _vc_ab_request_vector
+    // has the bits of all input vc's that made a request (i.e., the request
+    // inputs of the vc arbiter, for power);
+    for ( long k = vc_ab_mask.find_first(); k >= 0; k = vc_ab_mask.find_next(k)) {
+        long i = k / _vc_number;
+        long j = k % _vc_number;
+        // pick out a vc index from among those that are
+        // free of the output port where this flit has to go;
+        // vc_pair is a pair of (output port id, and vc index), where
+        // the vc index is the free vc index of input buffers of
+        // downstream router;
+        VC_PAIR vc_pair = vc_selection(i,j);
+        if ((vc_pair.first >= 0) && (vc_pair.second >= 0)) {
+            // output port id, vc index is "desired" also by i,j; 
+            long o_k = vc_pair.first * _vc_number + vc_pair.second;
+            _vc_ab_requests[o_k].set(k);
+            _vc_ab_out_mask.set(o_k);
+            _vc_ab_request_vector.set(k);
         }
     }
-    if ( vc_o_i_map.size() == 0) {
-        return;
-    }
 
-    // (2) now, go and pick out randomly a winner among all
+    // (2) now, go and pick out a winner among all
     // input port id, input vc id who wanted/competed-for the
-    // ourput-port id=i, out vc index=j;
-    for ( long i = 1; i < _physical_ports_count; i++) {
-        for ( long j = 0; j < _vc_number; j++) {
-            if ( _output.vc_usage(i, j) == ROUTER_OUTPUT::FREE) {
-                long cont_temp = vc_o_i_map[VC_PAIR(i,j)].size();
-                if ( cont_temp > 0) {
-                    VC_PAIR vc_win = vc_o_i_map[VC_PAIR(i,j)][0]; // winner input-port;
-                    if ( cont_temp > 1) {
-                        vc_win = vc_o_i_map[VC_PAIR(i,j)][ // winner input-port;
-                            _vnoc->topology()->rng().flat_l(0, cont_temp)];
-                    }
-                    // Note: the winner vc_win gets its status changed to SW_AB;
-                    // because its next phase will be to traverse the crossbar;
-                    // so, it will have to go thru switch arbitration process;
-                    _input.vc_state_update(vc_win.first, vc_win.second, SW_AB);
-                    // () record the selected routing; this will be used during the
-                    // next stage of SA_AB;
-                    _input.assign_selected_routing(vc_win.first, 
-                                                   vc_win.second, VC_PAIR(i,j));
-                    _output.acquire(i, j, vc_win);
-
-                    // power stuff here;
-                    if ( _vnoc->warmup_done() == true)
-                        _power_module.power_vc_arbit( i, j, vc_request,
-                            (vc_win.first) * _vc_number + (vc_win.second));
-                }
-            }
+    // output-port id=i, out vc index=j; output port 0 (local PE)
+    // is not arbitrated;
+    for ( long o_k = _vc_ab_out_mask.find_first(); o_k >= 0; 
+          o_k = _vc_ab_out_mask.find_next(o_k)) {
+        BIT_VECTOR &requests = _vc_ab_requests[o_k];
+        long i = o_k / _vc_number;
+        long j = o_k % _vc_number;
+        if ( i >= 1 && _output.vc_usage(i, j) == ROUTER_OUTPUT::FREE) {
+            long in_k = _vc_ab_arbiters[o_k].arbitrate( requests); // winner;
+            _vc_ab_arbiters[o_k].update( in_k);
+            _vc_sel_arbiters[in_k].update( o_k);
+            VC_PAIR vc_win = VC_PAIR(in_k / _vc_number, in_k % _vc_number);
+            // Note: the winner vc_win gets its status changed to SW_AB;
+            // because its next phase will be to traverse the crossbar;
+            // so, it will have to go thru switch arbitration process;
+            _input.vc_state_update(vc_win.first, vc_win.second, SW_AB);
+            // () record the selected routing; this will be used during the
+            // next stage of SA_AB;
+            _input.assign_selected_routing(vc_win.first, 
+                                           vc_win.second, VC_PAIR(i,j));
+            _output.acquire(i, j, vc_win);
+
+            // power stuff here;
+            if ( _vnoc->warmup_done() == true)
+                _power_module.power_vc_arbit( i, j, _vc_ab_request_vector,
+                    (vc_win.first) * _vc_number + (vc_win.second));
         }
-    }   
+        requests.clear();
+    }
+    _vc_ab_out_mask.clear();
+    _vc_ab_request_vector.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1038,7 +1562,7 @@ void ROUTER::routing_decision_stage_RC()
     // for tail flits status become IDLE (buffer is not used);
     // this is done by going thru all input port id's and all vc indices;
 
-    double event_time = _vnoc->event_queue()->current_sim_time();
+    SIM_TIME event_time = _event_queue->current_sim_time();
 
     // (1) process first the PE injection physical port 0;
     // Note: flits injected by the PE at this router and which are 
@@ -1047,14 +1571,12 @@ void ROUTER::routing_decision_stage_RC()
     // is this a real scenario of PE injecting packets to itself?
     for ( long j = 0; j < _vc_number; j++) {
         // HEADER flit;
-        FLIT flit_t;
         if ( _input.vc_state(0,j) == ROUTING) {
-            flit_t = _input.get_flit(0,j);
-            ADDRESS des_t = flit_t.des_addr();
-            ADDRESS sor_t = flit_t.src_addr();
-            if ( _address == des_t) {
+            FLIT_HANDLE flit_h = _input.get_flit(0,j);
+            long des_t = flit( flit_h).des_router_id();
+            if ( _id == des_t) {
                 // (a) packets injected to itself;
-                consume_flit( event_time, flit_t);
+                consume_flit( event_time, flit_h);
                 _input.remove_flit(0, j);
                 _input.vc_state_update(0, j, HOME);
             } else {
@@ -1064,7 +1586,7 @@ void ROUTER::routing_decision_stage_RC()
 
                 // call the actual routing algo; this populates _routing of
                 // _input that will be used during vc_arbitration_stage;
-                call_current_routing_algorithm( des_t, sor_t, 0, j);
+                call_current_routing_algorithm( des_t, 0, j);
 
                 _input.vc_state_update(0, j, VC_AB);
 
@@ -1074,11 +1596,12 @@ void ROUTER::routing_decision_stage_RC()
         // the router pipeline; they shortcut that;
         } else if ( _input.vc_state(0,j) == HOME) {
             if ( _input.input_buff(0, j).size() > 0) {
-                flit_t = _input.get_flit(0, j);
-                assert( flit_t.type() != FLIT::HEADER);
-                consume_flit( event_time, flit_t);
+                FLIT_HANDLE flit_h = _input.get_flit(0, j);
+                FLIT::FLIT_TYPE flit_type = flit( flit_h).type();
+                assert( flit_type != FLIT::HEADER);
+                consume_flit( event_time, flit_h);
                 _input.remove_flit(0, j);
-                if ( flit_t.type() == FLIT::TAIL) {
+                if ( flit_type == FLIT::TAIL) {
                     if ( _input.input_buff(0, j).size() > 0) {
                         _input.vc_state_update(0, j, ROUTING);
                     } else {
@@ -1093,13 +1616,10 @@ void ROUTER::routing_decision_stage_RC()
     for ( long i = 1; i < _physical_ports_count; i++) {
         for ( long j = 0; j < _vc_number; j++) {
             // if flit is consumed here, then send right away back 
-            // a CREDIT event/message to let upstream router that an 
+            // a credit to let upstream router know that an 
             // empty slot just became available;
-            FLIT flit_t;
             if ( _input.input_buff(i,j).size() > 0) {
-                flit_t = _input.get_flit(i,j);
-                ADDRESS des_t = flit_t.des_addr();
-                if ( _address == des_t) {
+                if ( _id == flit( _input.get_flit(i,j)).des_router_id()) {
                     /*---
                     // this is replaced with what's next to it, which is simpler
                     // but works for only 2D meshes; currently this is not used;  
@@ -1120,47 +1640,27 @@ void ROUTER::routing_decision_stage_RC()
                             cre_add_t[(i-1)/2] = _ary_size - 1;
                         }
                     }
-                    _vnoc->event_queue()->add_event( EVENT(EVENT::CREDIT,
+                    _event_queue->add_event( EVENT(EVENT::CREDIT,
                         event_time + _credit_delay, _address, cre_add_t, cre_pc_t, j));
                     ---*/
 
-                    long to_router_id = -1;
-                    long to_port_id = -1;
-                    // if the destination is to the right, send credit to
-                    // left and vice-versa; if it's up, send it down and vice-versa;
-                    if ( i == 1) {
-                        to_router_id = _id - _ary_size; // West neighbor
-                        to_port_id = 2;
-                    } else if ( i == 2) {
-                        to_router_id = _id + _ary_size; // East neighbor
-                        to_port_id = 1;
-                    } else if ( i == 3) {
-                        assert( (_id % _ary_size) > 0);
-                        to_router_id = _id - 1; // South neighbor
-                        to_port_id = 4;            
-                    } else { // i == 4
-                        to_router_id = _id + 1; // North neighbor
-                        assert( (to_router_id % _ary_size) > 0);
-                        to_port_id = 3;
-                    } // there should be no other case; assumption: just 2D meshes;
-                    assert( to_router_id >= 0 && to_router_id < _vnoc->routers_count());
-
-                    _vnoc->event_queue()->add_event( 
-                        EVENT(EVENT::CREDIT, (event_time + _credit_delay),
-                        to_router_id, to_port_id, j)); // j is VC index;
+                    // the credit goes back thru the link of input port "i"
+                    // to the upstream router; 
+                    assert( _upstream_credit_links[i] != 0);
+                    send_on_link( _upstream_credit_links[i], j, 0, // j is VC index;
+                        _credit_delay);
 
                 }
             }
             //  HEADER flit;
             if ( _input.vc_state(i, j) == ROUTING) {
-                flit_t = _input.get_flit(i, j);
-                assert(flit_t.type() == FLIT::HEADER);
-                ADDRESS des_t = flit_t.des_addr();
-                ADDRESS sor_t = flit_t.src_addr();
-                if ( _address == des_t) {
+                FLIT_HANDLE flit_h = _input.get_flit(i, j);
+                assert( flit( flit_h).type() == FLIT::HEADER);
+                long des_t = flit( flit_h).des_router_id();
+                if ( _id == des_t) {
                     // (a) flit arrived at input port "i", vc index "j"
                     // has as address this local router;
-                    consume_flit( event_time, flit_t);
+                    consume_flit( event_time, flit_h);
                     _input.remove_flit(i, j);
                     _input.vc_state_update(i, j, HOME);
                 } else {
@@ -1170,7 +1670,7 @@ void ROUTER::routing_decision_stage_RC()
 
                     // call the actual routing algo; this populates _routing of
                     // _input that will be used during vc_arbitration_stage;
-                    call_current_routing_algorithm( des_t, sor_t, i, j);
+                    call_current_routing_algorithm( des_t, i, j);
 
                     _input.vc_state_update(i, j, VC_AB);
                     
@@ -1179,11 +1679,12 @@ void ROUTER::routing_decision_stage_RC()
             // BODY or TAIL flits;
             else if ( _input.vc_state(i, j) == HOME) {
                 if ( _input.input_buff(i, j).size() > 0) {
-                    flit_t = _input.get_flit(i, j);
-                    assert( flit_t.type() != FLIT::HEADER);
-                    consume_flit( event_time, flit_t);
+                    FLIT_HANDLE flit_h = _input.get_flit(i, j);
+                    FLIT::FLIT_TYPE flit_type = flit( flit_h).type();
+                    assert( flit_type != FLIT::HEADER);
+                    consume_flit( event_time, flit_h);
                     _input.remove_flit(i, j);
-                    if ( flit_t.type() == FLIT::TAIL) {
+                    if ( flit_type == FLIT::TAIL) {
                         if ( _input.input_buff(i, j).size() > 0) {
                             _input.vc_state_update(i, j, ROUTING);
                         } else {
@@ -1197,88 +1698,12 @@ void ROUTER::routing_decision_stage_RC()
 }
 
 void ROUTER::call_current_routing_algorithm(
-    const ADDRESS &des_t, const ADDRESS &sor_t,
-    long s_ph, long s_vc)
+    long des_router_id, long s_ph, long s_vc)
 {
     // setup _routing matrix that implements currently used 
-    // routing algo (XY or TXY);
-
-    long xoffset = des_t[0] - _address[0];
-    long yoffset = des_t[1] - _address[1];
-
-    // (1) XY (XY on mesh)
-    int virtual_channels_num = _vc_number;
-    if ( _routing_algo == XY) {
-
-        if ( yoffset < 0) {
-            for ( long j = 0; j < virtual_channels_num; j++) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(3,j));
-            }
-        } else if ( yoffset > 0) {
-            for ( long j = 0; j < virtual_channels_num; j++) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(4,j));
-            }
-        } else {
-            if ( xoffset < 0) {
-                for ( long j = 0; j < virtual_channels_num; j++) {
-                    _input.add_routing(s_ph, s_vc, VC_PAIR(1,j));
-                }
-            } else if ( xoffset > 0) {
-                for ( long j = 0; j < virtual_channels_num; j++) {
-                    _input.add_routing(s_ph, s_vc, VC_PAIR(2,j));
-                }
-            }
-        }
-    }
-    // (2) TXY (XY on torus)
-    // Note: this to be correted - it seems to use only 2 vc's all the time? 
-    else if ( _routing_algo == TXY) {
-
-        bool xdirection = (abs(static_cast<int>(xoffset)) * 2 <= _ary_size) ? true: false; 
-        bool ydirection = (abs(static_cast<int>(yoffset)) * 2 <= _ary_size) ? true: false; 
-
-        if ( xdirection) {
-            if ( xoffset < 0) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(1, 0));
-            } else if ( xoffset > 0) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(2, 1));
-            } else {
-                if ( ydirection) {
-                    if ( yoffset < 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(3, 0));
-                    } else if ( yoffset > 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(4, 1));
-                    }
-                } else {
-                    if ( yoffset < 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(4, 0));
-                    } else if ( yoffset > 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(3, 1)); 
-                    }
-                }
-            }
-        } else {
-            if ( xoffset < 0) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(2, 0));
-            } else if ( xoffset > 0) {
-                _input.add_routing(s_ph, s_vc, VC_PAIR(1, 1));
-            } else {
-                if ( ydirection) {
-                    if ( yoffset < 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(3, 0));
-                    } else if ( yoffset > 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(4, 1));
-                    }
-                } else {
-                    if ( yoffset < 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(4, 0));
-                    } else if ( yoffset > 0) {
-                        _input.add_routing(s_ph, s_vc, VC_PAIR(3, 1)); 
-                    }
-                }
-            }
-        }
-    }
+    // routing algo (XY, TXY or UP_DOWN); the candidates of each destination
+    // and input port were computed at startup (see NETWORK::compile());
+    _input.set_routing( s_ph, s_vc, &_network->routes( _id, s_ph, des_router_id));
 }
 
 void ROUTER::sanity_check() const
@@ -1391,43 +1816,14 @@ void ROUTER::set_frequencies_and_vdd( DVFS_LEVEL to_level)
     //printf("\n change dvfs %d",_id);
     _dvfs_level_prev = _dvfs_level;
     _dvfs_level = to_level;
-    switch ( to_level) {
-    case DVFS_BOOST: // see vnoc_topology.h for details on these values;
-        _wire_delay = WIRE_DELAY_BOOST;
-        _pipe_delay = PIPE_DELAY_BOOST;
-        _credit_delay = CREDIT_DELAY_BOOST;
-        _power_module.set_current_period( PIPE_DELAY_BOOST);
-        _power_module.set_current_vdd( VDD_BOOST);
-        _power_module.set_energy_scaling_factor( SCALING_BOOST);
-        break;
-    case DVFS_BASE:
-        _wire_delay = WIRE_DELAY_BASE;
-        _pipe_delay = PIPE_DELAY_BASE;
-        _credit_delay = CREDIT_DELAY_BASE;
-        _power_module.set_current_period( PIPE_DELAY_BASE);
-        _power_module.set_current_vdd( VDD_BASE);
-        _power_module.set_energy_scaling_factor( SCALING_BASE);
-        break;
-    case DVFS_THROTTLE_1:
-        _wire_delay = WIRE_DELAY_THROTTLE_1;
-        _pipe_delay = PIPE_DELAY_THROTTLE_1;
-        _credit_delay = CREDIT_DELAY_THROTTLE_1;
-        _power_module.set_current_period( PIPE_DELAY_THROTTLE_1);
-        _power_module.set_current_vdd( VDD_THROTTLE_1);
-        _power_module.set_energy_scaling_factor( SCALING_THROTTLE_1);
-        break;
-    case DVFS_THROTTLE_2:
-        _wire_delay = WIRE_DELAY_THROTTLE_2;
-        _pipe_delay = PIPE_DELAY_THROTTLE_2;
-        _credit_delay = CREDIT_DELAY_THROTTLE_2;
-        _power_module.set_current_period( PIPE_DELAY_THROTTLE_2);
-        _power_module.set_current_vdd( VDD_THROTTLE_2);
-        _power_module.set_energy_scaling_factor( SCALING_THROTTLE_2);
-        break;
-    default:
-        assert(0); // we shoud never get here;
-        break;
-    }
+    // see TOPOLOGY::dvfs_clock_period(); the energy of the activity
+    // from now on is priced with the Orion models of the level;
+    SIM_TIME period = clock_period( to_level);
+    _wire_delay = period;
+    _pipe_delay = period;
+    _credit_delay = period;
+    _power_module.set_current_period( ticks_to_cycles( period));
+    _power_module.set_dvfs_level( to_level);
 }
 
 
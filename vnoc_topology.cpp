@@ -6,6 +6,8 @@
 #include <math.h>
 #include <algorithm>
 #include <limits.h>
+#include <fstream>
+#include <sstream>
 
 
 using namespace std;
@@ -24,9 +26,17 @@ TOPOLOGY::TOPOLOGY( int argc, char *argv[]) : _rng()
     // terminology; it's not intuitive; but this is what people use;
     // this is the terminology used in W. Dally's book;
     _ary_size = 8; // I refer to it as "network size" in one dimension;
-    _cube_size = 2; // stays always 2 for now;
+    _cube_size = 2; // 3 for 3D meshes;
+    _nx = -1; // ary_size if not given;
+    _ny = -1;
+    _nz = 1; // 2D;
+    _torus = false;
     _link_length = 2000.0; // in micrometers; 2000*1e-6 = 2 mm;
     _pipeline_stages_per_link = 0; // link is not pipelined;
+    _topology_file = ""; // 2D mesh;
+    _power_cache_dir = ""; // Orion init is done each run;
+    _tech_node = 65; // as PARM(TECH_POINT) of orion3/SIM_port.h;
+    _transistor_type = LVT_TRANSISTOR;
     _vc_sharing_mode = SHARED;
 
     // traffic related;
@@ -45,6 +55,7 @@ TOPOLOGY::TOPOLOGY( int argc, char *argv[]) : _rng()
     _dvfs_mode = ASYNC; // SYNC;
     _use_freq_boost = false;
     _use_link_pred = true;
+    _dvfs_table_file = ""; // VDD_* and FREQ_* of vnoc_topology.h;
 
     _routing_algo = XY;
     _input_buffer_size = 16;
@@ -59,10 +70,68 @@ TOPOLOGY::TOPOLOGY( int argc, char *argv[]) : _rng()
     _gui_step_by_step = false;
     _rng_seed = 1; // time(NULL);
     _verbose = false;
+    _event_queue_type = CALENDAR_EVENT_QUEUE;
+    _simulation_engine = EVENT_DRIVEN_ENGINE;
+    _threads_count = 1;
+    _arbiter_type = RANDOM_ARB;
+    _sw_allocator_type = SEPARABLE_INPUT_FIRST;
+    _islip_iterations = 1;
+    _dormant_routers = true;
     
 
     // (2) parse in user defined topology;
     parse_command_arguments( argc, argv); // reeds in also _rng_seed;
+    if ( _nx < 0) {
+        _nx = _ary_size;
+    }
+    if ( _ny < 0) {
+        _ny = _ary_size;
+    }
+    _cube_size = ( _nz > 1) ? 3 : 2;
+    if ( _routing_algo == TXY && !_torus) {
+        printf("Error:  routing TXY requires topology: TORUS.\n");
+        exit(1);
+    }
+    if ( _routing_algo == TXY && _vc_number < 2) {
+        // half of the vc's of each port are used before the dateline 
+        // and half after it;
+        printf("Error:  routing TXY requires at least 2 virtual channels.\n");
+        exit(1);
+    }
+    if ( ( _traffic_type == TRANSPOSE1_TRAFFIC || _traffic_type == TRANSPOSE2_TRAFFIC ||
+        _traffic_type == HOTSPOT_TRAFFIC) && _cube_size != 2) {
+        printf("Error:  TRANSPOSE1, TRANSPOSE2 and HOTSPOT traffic require a 2D topology.\n");
+        exit(1);
+    }
+    if ( _use_gui && _cube_size != 2) {
+        printf("Error:  use_gui requires a 2D topology.\n");
+        exit(1);
+    }
+    if ( _simulation_engine == CYCLE_DRIVEN_ENGINE && _do_dvfs && 
+        _threads_count > 1) {
+        // with dvfs, routers are stepped by clock domains, whose routers
+        // change at each cycle; they are simulated by one thread;
+        printf("Warning:  engine CYCLE with do_dvfs: 1 uses one thread.\n");
+        _threads_count = 1;
+    }
+    if ( !_topology_file.empty()) {
+        // routers of a topology file have no coordinates; routes come from
+        // the graph;
+        if ( _routing_algo == TXY) {
+            printf("Error:  routing TXY cannot be used with topology_file.\n");
+            exit(1);
+        }
+        _routing_algo = UP_DOWN;
+        if ( _traffic_type != UNIFORM_TRAFFIC && _traffic_type != SELFSIMILAR_TRAFFIC) {
+            printf("Error:  topology_file can be used only with UNIFORM or SELFSIMILAR traffic.\n");
+            exit(1);
+        }
+        if ( _use_gui) {
+            printf("Error:  topology_file cannot be used with use_gui.\n");
+            exit(1);
+        }
+    }
+    load_dvfs_table();
     populate_hotspot_sketch_arrays(); // done only for hotspot traffic;
 
     print_topology();
@@ -89,11 +158,17 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
         printf("                          much additional percent probability. (10.0)\n");
         printf(" [injection_rate:]        Injection rate. Used with synthetic traffic. (0.015)\n");
         printf(" [ary_size:]\tBasically nx and ny for square meshes. (9) \n");
+        printf(" [nx:]\t\tNumber of routers along x; for rectangular meshes. (ary_size) \n");
+        printf(" [ny:]\t\tNumber of routers along y; for rectangular meshes. (ary_size) \n");
+        printf(" [nz:]\t\tNumber of routers along z; more than 1 for 3D meshes with 7-port routers. (1) \n");
+        printf(" [topology:]\tMust be MESH or TORUS; the torus has wraparound links; use it with routing TXY. (MESH) \n");
         printf(" [packet_size:]\tPacket size, for synthetic traffic case. (5) \n");
         printf(" [flit_size:]\tFlit size, for synthetic traffic case. (1) \n");
         printf(" [inp_buf:]\tRouter input-port buffers size in # flits. (5) \n");
         printf(" [out_buf:]\tRouter output-port buffers size in # flits. (5) \n");
-        printf(" [routing:]\tRouting algorithm. Must be XY or TXY - Torus XY. (XY) \n");
+        printf(" [routing:]\tRouting algorithm. Must be XY, TXY - Torus XY (with dateline vc's) or UPDOWN - up*/down*. (XY) \n");
+        printf(" [topology_file:]\tName of a topology file; routers and links are read from it instead of\n");
+        printf("                 \tbuilding the mesh; routing is UPDOWN. Read README.txt for its format\n");
         printf(" [vc_n:]\tNumber of virtual channels. (2) \n");
         printf(" [link_bw:]\tLink bandwidth in bits. (64) \n");
         printf(" [cycles:]\tSimulation cycles count. (10000) \n");
@@ -109,6 +184,21 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
         printf(" [dvfs_mode:]\tMust be SYNC or ASYNC - (ASYNC) \n");
         printf(" [use_boost:]\tPerform frequency boost. Must be 0 if False or 1 if True. (0) \n");
         printf(" [use_link_pred:]\tUse also link prediction. Must be 0 if False or 1 if True. (1) \n");
+        printf(" [dvfs_table:]\tName of a file with the Vdd and frequency of the DVFS levels; Orion's power\n");
+        printf("              \tmodels are made for each level. Read README.txt for its format. (none) \n");
+        printf(" [event_queue:]\tEvent scheduler. Must be CALENDAR or MULTISET. (CALENDAR) \n");
+        printf(" [engine:]\tSimulation engine. Must be EVENT, CYCLE, PDES or DOMAIN; all give the same results.\n");
+        printf("          \tCYCLE uses one thread with do_dvfs: 1. Read README.txt for more. (EVENT) \n");
+        printf(" [threads:]\tNumber of threads of the PDES engine (one mesh tile each) or of the CYCLE engine. (1) \n");
+        printf(" [arbiter:]\tArbiters of vc and switch allocators. Must be RANDOM, RR or MATRIX. (RANDOM) \n");
+        printf(" [sw_alloc:]\tSwitch allocator. Must be INPUT_FIRST, OUTPUT_FIRST, ISLIP or WAVEFRONT. (INPUT_FIRST) \n");
+        printf(" [islip_iter:]\tNumber of iterations of ISLIP switch allocator. (1) \n");
+        printf(" [dormant_routers:]\tIdle routers are not simulated each cycle. Must be 0 if False or 1 if True. (1) \n");
+        printf(" [link_stages:]\tPipeline registers of each link; a flit (or credit) takes one wire (or credit) delay for each stage and one more. (0) \n");
+        printf(" [power_cache:]\tDirectory where the Orion power models are saved, to be loaded by next runs; they\n");
+        printf("               \tare made again if Orion's sources or parameters changed. (none) \n");
+        printf(" [tech_node:]\tTechnology node of the Orion power models, in nm. Must be 90, 65, 45 or 32. (65) \n");
+        printf(" [transistor_type:]\tTransistors of the Orion power models. Must be LVT, NVT or HVT. (LVT) \n");
 
         exit(1);
     }
@@ -137,6 +227,43 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
             continue;
         }
 
+        if ( !strcmp(argv[i], "nx:") || !strcmp(argv[i], "ny:") || 
+            !strcmp(argv[i], "nz:")) {
+            long n_t = atoi(argv[i+1]);
+            long min_t = ( argv[i][1] == 'z') ? 1 : 2;
+            if (n_t < min_t || n_t > 128) { 
+                printf("Error:  %s value must be between [%ld 128].\n", argv[i], min_t);
+                exit(1); 
+            }
+            if ( argv[i][1] == 'x') {
+                _nx = n_t;
+            } else if ( argv[i][1] == 'y') {
+                _ny = n_t;
+            } else {
+                _nz = n_t;
+            }
+            i += 2; 
+            continue;
+        }
+
+        if (strcmp (argv[i],"topology:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  topology option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "MESH") == 0) {
+                _torus = false;
+            } 
+            else if (strcmp(argv[i+1], "TORUS") == 0) {
+                _torus = true;
+            } else {
+                printf("Error:  topology must be MESH or TORUS.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+
         if (strcmp (argv[i],"routing:") == 0) {
             if (argc <= i+1) {
                 printf ("Error:  routing option requires a string parameter.\n");
@@ -147,8 +274,63 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
             } 
             else if (strcmp(argv[i+1], "TXY") == 0) {
                 _routing_algo = TXY;
+            } 
+            else if (strcmp(argv[i+1], "UPDOWN") == 0) {
+                _routing_algo = UP_DOWN;
+            } else {
+                printf("Error:  routing algorithm must be XY, TXY or UPDOWN.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+
+        if (strcmp (argv[i],"topology_file:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  topology_file option requires a string parameter.\n");
+                exit (1);
+            } 
+            _topology_file = argv[i+1];
+            i += 2;
+            continue;
+        }
+
+        if (strcmp (argv[i],"power_cache:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  power_cache option requires a string parameter.\n");
+                exit (1);
+            } 
+            _power_cache_dir = argv[i+1];
+            i += 2;
+            continue;
+        }
+        if (strcmp (argv[i],"tech_node:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  tech_node option requires an integer parameter.\n");
+                exit (1);
+            } 
+            _tech_node = atoi(argv[i+1]);
+            if ( _tech_node != 90 && _tech_node != 65 && 
+                _tech_node != 45 && _tech_node != 32) {
+                printf("Error:  tech_node must be 90, 65, 45 or 32.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+        if (strcmp (argv[i],"transistor_type:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  transistor_type option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "LVT") == 0) {
+                _transistor_type = LVT_TRANSISTOR;
+            } else if (strcmp(argv[i+1], "NVT") == 0) {
+                _transistor_type = NVT_TRANSISTOR;
+            } else if (strcmp(argv[i+1], "HVT") == 0) {
+                _transistor_type = HVT_TRANSISTOR;
             } else {
-                printf("Error:  routing algorithm must be XY or TXY.\n");
+                printf("Error:  transistor_type must be LVT, NVT or HVT.\n");
                 exit (1);
             }
             i += 2;
@@ -184,10 +366,9 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
             long a_hotspot = 0;
             while (++i < argc) { 
                 if (strstr(argv[i], ":")) {
-                    --i;
-                    break; 
+                    break; // next option;
                 }
-                if (!sscanf(argv[i], "%d", &a_hotspot)) {
+                if (!sscanf(argv[i], "%ld", &a_hotspot)) {
                     printf("Error:  While reading hotspots id's.\n");
                     exit(1);
                 }
@@ -255,8 +436,8 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
         }
         if ( !strcmp(argv[i], "flit_size:")) {
             _flit_size = atoi(argv[i+1]);
-            if (_flit_size < 1 || _flit_size > 128) { 
-                printf("Error:  flit_size value must be between [1 128].\n");
+            if (_flit_size < 1 || _flit_size > FLIT_MAX_SIZE) { 
+                printf("Error:  flit_size value must be between [1 %d].\n", FLIT_MAX_SIZE);
                 exit(1); 
             }
             i += 2; 
@@ -390,7 +571,16 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
             i += 2; 
             continue;
         }
-        if (strcmp (argv[i],"dvfs_mode:") == 0) {
+        if (strcmp (argv[i],"dvfs_table:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  dvfs_table option requires a string parameter.\n");
+                exit (1);
+            } 
+            _dvfs_table_file = argv[i+1];
+            i += 2;
+            continue;
+        }
+                if (strcmp (argv[i],"dvfs_mode:") == 0) {
             if (argc <= i+1) {
                 printf ("Error:  dvfs mode requires a string parameter.\n");
                 exit (1);
@@ -407,6 +597,121 @@ bool TOPOLOGY::parse_command_arguments( int argc, char *argv[])
             i += 2;
             continue;
         }
+        if (strcmp (argv[i],"event_queue:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  event_queue option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "CALENDAR") == 0) {
+                 _event_queue_type = CALENDAR_EVENT_QUEUE;
+            } 
+            else if (strcmp(argv[i+1], "MULTISET") == 0) {
+                _event_queue_type = MULTISET_EVENT_QUEUE;
+            } else {
+                printf("Error:  event_queue must be CALENDAR or MULTISET.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+        if (strcmp (argv[i],"engine:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  engine option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "EVENT") == 0) {
+                 _simulation_engine = EVENT_DRIVEN_ENGINE;
+            } 
+            else if (strcmp(argv[i+1], "CYCLE") == 0) {
+                _simulation_engine = CYCLE_DRIVEN_ENGINE;
+            } 
+            else if (strcmp(argv[i+1], "PDES") == 0) {
+                _simulation_engine = PARALLEL_ENGINE;
+            } 
+            else if (strcmp(argv[i+1], "DOMAIN") == 0) {
+                _simulation_engine = CLOCK_DOMAIN_ENGINE;
+            } else {
+                printf("Error:  engine must be EVENT, CYCLE, PDES or DOMAIN.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+        if ( !strcmp(argv[i], "threads:")) {
+            _threads_count = atoi(argv[i+1]);
+            if (_threads_count < 1 || _threads_count > 256) { 
+                printf("Error:  threads value must be between [1 256].\n");
+                exit(1); 
+            }
+            i += 2; 
+            continue;
+        }
+        if (strcmp (argv[i],"arbiter:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  arbiter option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "RANDOM") == 0) {
+                _arbiter_type = RANDOM_ARB;
+            } else if (strcmp(argv[i+1], "RR") == 0) {
+                _arbiter_type = ROUND_ROBIN_ARB;
+            } else if (strcmp(argv[i+1], "MATRIX") == 0) {
+                _arbiter_type = MATRIX_ARB;
+            } else {
+                printf("Error:  arbiter must be RANDOM, RR or MATRIX.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+        if (strcmp (argv[i],"sw_alloc:") == 0) {
+            if (argc <= i+1) {
+                printf ("Error:  sw_alloc option requires a string parameter.\n");
+                exit (1);
+            } 
+            if (strcmp(argv[i+1], "INPUT_FIRST") == 0) {
+                _sw_allocator_type = SEPARABLE_INPUT_FIRST;
+            } else if (strcmp(argv[i+1], "OUTPUT_FIRST") == 0) {
+                _sw_allocator_type = SEPARABLE_OUTPUT_FIRST;
+            } else if (strcmp(argv[i+1], "ISLIP") == 0) {
+                _sw_allocator_type = ISLIP_ALLOCATOR;
+            } else if (strcmp(argv[i+1], "WAVEFRONT") == 0) {
+                _sw_allocator_type = WAVEFRONT_ALLOCATOR;
+            } else {
+                printf("Error:  sw_alloc must be INPUT_FIRST, OUTPUT_FIRST, ISLIP or WAVEFRONT.\n");
+                exit (1);
+            }
+            i += 2;
+            continue;
+        }
+        if ( !strcmp(argv[i], "islip_iter:")) {
+            _islip_iterations = atoi(argv[i+1]);
+            if (_islip_iterations < 1 || _islip_iterations > 16) { 
+                printf("Error:  islip_iter value must be between [1 16].\n");
+                exit(1); 
+            }
+            i += 2; 
+            continue;
+        }
+        if ( !strcmp(argv[i], "dormant_routers:")) {
+            long dormant_routers_temp = atoi(argv[i+1]);
+            if (dormant_routers_temp < 0 || dormant_routers_temp > 1) { 
+                printf("Error:  dormant_routers value must be 0 (false) or 1 (true).\n");
+                exit(1); 
+            }
+            _dormant_routers = ( dormant_routers_temp == 1);
+            i += 2; 
+            continue;
+        }
+        if ( !strcmp(argv[i], "link_stages:")) {
+            _pipeline_stages_per_link = atoi(argv[i+1]);
+            if (_pipeline_stages_per_link < 0 || _pipeline_stages_per_link > 32) { 
+                printf("Error:  link_stages value must be between [0 32].\n");
+                exit(1); 
+            }
+            i += 2; 
+            continue;
+        }
 
         printf("Error:  Parameter #%d '%s' not recognized.\n", i, argv[i]);
         exit(1);
@@ -457,8 +762,16 @@ bool TOPOLOGY::check_topology()
 
 void TOPOLOGY::print_topology()
 {
-    printf("ary_size:                 %dx%d \n", _ary_size, _ary_size);
+    if ( _cube_size == 2) {
+        printf("ary_size:                 %ldx%ld \n", _nx, _ny);
+    } else {
+        printf("ary_size:                 %ldx%ldx%ld \n", _nx, _ny, _nz);
+    }
     printf("cube_size:                %d \n", _cube_size);
+    printf("topology:                 %s \n", _torus ? "TORUS" : "MESH");
+    if ( !_topology_file.empty()) {
+        printf("topology_file:            %s \n", _topology_file.c_str());
+    }
     printf("packet_size:              %d \n", _packet_size);
     printf("flit_size:                %d \n", _flit_size);
     printf("input_buffer_size:        %d \n", _input_buffer_size );
@@ -466,12 +779,20 @@ void TOPOLOGY::print_topology()
     printf("virtual_channel_number:   %d \n", _vc_number);
     printf("link_bandwidth:           %d \n", _link_bandwidth);
     printf("link_length [um]:         %g \n", _link_length);
-    //printf("pipeline_stages_per_link: %d \n", _pipeline_stages_per_link);
+    printf("pipeline_stages_per_link: %ld \n", _pipeline_stages_per_link);
+    if ( !_power_cache_dir.empty()) {
+        printf("power_cache:              %s \n", _power_cache_dir.c_str());
+    }
+    const char *transistor_names[] = { "LVT", "NVT", "HVT" };
+    printf("tech_node [nm]:           %ld \n", _tech_node);
+    printf("transistor_type:          %s \n", transistor_names[ _transistor_type]);
     printf("seed:                     %ld \n", _rng_seed);
     if ( _routing_algo == XY) {
         printf("routing_algo:             %s \n", "XY");
     } else if ( _routing_algo == TXY) {
         printf("routing_algo:             %s \n", "TXY (Torus XY)");
+    } else if ( _routing_algo == UP_DOWN) {
+        printf("routing_algo:             %s \n", "UPDOWN (up*/down*)");
     }
     if ( _traffic_type == UNIFORM_TRAFFIC) {
         printf("traffic type:             %s \n", "UNIFORM");
@@ -529,9 +850,135 @@ void TOPOLOGY::print_topology()
     } else {
         printf("use_link_pred:            %s \n", "True");
     }
+    if ( _do_dvfs) {
+        if ( !_dvfs_table_file.empty()) {
+            printf("dvfs_table:               %s \n", _dvfs_table_file.c_str());
+        }
+        const char *level_names[] = { "BOOST", "BASE", "THROTTLE_1", "THROTTLE_2" };
+        for ( long l = 0; l < DVFS_LEVELS_COUNT; l++) {
+            char label_t[32];
+            sprintf( label_t, "dvfs_%s:", level_names[ l]);
+            printf("%-26s%.3f V, %.3f GHz \n", label_t,
+                _dvfs_vdd[ l], _dvfs_freq[ l]);
+        }
+    }
+    if ( _event_queue_type == CALENDAR_EVENT_QUEUE) {
+        printf("event_queue:              %s \n", "CALENDAR");
+    } else if ( _event_queue_type == MULTISET_EVENT_QUEUE) {
+        printf("event_queue:              %s \n", "MULTISET");
+    }
+    if ( _simulation_engine == EVENT_DRIVEN_ENGINE) {
+        printf("engine:                   %s \n", "EVENT");
+    } else if ( _simulation_engine == CYCLE_DRIVEN_ENGINE && _threads_count > 1) {
+        printf("engine:                   %s (%ld threads) \n", "CYCLE", 
+            _threads_count);
+    } else if ( _simulation_engine == CYCLE_DRIVEN_ENGINE && _do_dvfs) {
+        printf("engine:                   %s (clock domains) \n", "CYCLE");
+    } else if ( _simulation_engine == CYCLE_DRIVEN_ENGINE) {
+        printf("engine:                   %s \n", "CYCLE");
+    } else if ( _simulation_engine == PARALLEL_ENGINE) {
+        printf("engine:                   %s (%ld threads) \n", "PDES", 
+            _threads_count);
+    } else if ( _simulation_engine == CLOCK_DOMAIN_ENGINE) {
+        printf("engine:                   %s \n", "DOMAIN");
+    }
+    if ( _arbiter_type == RANDOM_ARB) {
+        printf("arbiter:                  %s \n", "RANDOM");
+    } else if ( _arbiter_type == ROUND_ROBIN_ARB) {
+        printf("arbiter:                  %s \n", "RR");
+    } else if ( _arbiter_type == MATRIX_ARB) {
+        printf("arbiter:                  %s \n", "MATRIX");
+    }
+    if ( _sw_allocator_type == SEPARABLE_INPUT_FIRST) {
+        printf("sw_alloc:                 %s \n", "INPUT_FIRST");
+    } else if ( _sw_allocator_type == SEPARABLE_OUTPUT_FIRST) {
+        printf("sw_alloc:                 %s \n", "OUTPUT_FIRST");
+    } else if ( _sw_allocator_type == ISLIP_ALLOCATOR) {
+        printf("sw_alloc:                 %s (%ld iterations) \n", "ISLIP", 
+            _islip_iterations);
+    } else if ( _sw_allocator_type == WAVEFRONT_ALLOCATOR) {
+        printf("sw_alloc:                 %s \n", "WAVEFRONT");
+    }
+    if ( _dormant_routers == false) {
+        printf("dormant_routers:          %s \n", "False");
+    } else {
+        printf("dormant_routers:          %s \n", "True");
+    }
     printf("\n");
 }
 
+void TOPOLOGY::load_dvfs_table()
+{
+    // one line per level: its name (BOOST, BASE, THROTTLE_1 or THROTTLE_2),
+    // Vdd in V and frequency in GHz; "#" starts a comment; levels not in 
+    // the file keep their defaults;
+    double vdd_t[] = { VDD_BOOST, VDD_BASE, VDD_THROTTLE_1, VDD_THROTTLE_2 };
+    double freq_t[] = { FREQ_BOOST, FREQ_BASE, FREQ_THROTTLE_1, FREQ_THROTTLE_2 };
+    _dvfs_vdd.assign( vdd_t, vdd_t + DVFS_LEVELS_COUNT);
+    _dvfs_freq.assign( freq_t, freq_t + DVFS_LEVELS_COUNT);
+    if ( !_dvfs_table_file.empty()) {
+        const char *level_names[] = { "BOOST", "BASE", "THROTTLE_1", "THROTTLE_2" };
+        ifstream file_st( _dvfs_table_file.c_str());
+        if ( !file_st) {
+            printf("Error:  Cannot open DVFS table file %s.\n", _dvfs_table_file.c_str());
+            exit(1);
+        }
+        string line;
+        long line_number = 0;
+        while ( getline( file_st, line)) {
+            line_number ++;
+            size_t comment = line.find('#');
+            if ( comment != string::npos) {
+                line.erase( comment);
+            }
+            istringstream line_st( line);
+            string keyword;
+            if ( !(line_st >> keyword)) {
+                continue; // empty line;
+            }
+            long level = 0;
+            while ( level < DVFS_LEVELS_COUNT && keyword != level_names[ level]) {
+                level ++;
+            }
+            double vdd = 0.0, freq = 0.0;
+            string extra;
+            if ( level == DVFS_LEVELS_COUNT || !(line_st >> vdd >> freq) ||
+                vdd <= 0.0 || vdd > 5.0 || freq <= 0.0 || freq > 100.0 ||
+                (line_st >> extra)) {
+                printf("Error:  DVFS table file %s, line %ld: '%s' is not valid.\n",
+                    _dvfs_table_file.c_str(), line_number, line.c_str());
+                exit(1);
+            }
+            _dvfs_vdd[ level] = vdd;
+            _dvfs_freq[ level] = freq;
+        }
+        file_st.close();
+        for ( long l = 1; l < DVFS_LEVELS_COUNT; l++) {
+            if ( _dvfs_freq[ l] > _dvfs_freq[ l - 1]) {
+                printf("Error:  DVFS table file %s: frequencies must not increase from BOOST to THROTTLE_2.\n",
+                    _dvfs_table_file.c_str());
+                exit(1);
+            }
+        }
+    }
+    // the base level takes one cycle; the others are rounded to whole ticks;
+    _dvfs_clock_periods.resize( DVFS_LEVELS_COUNT);
+    for ( long l = 0; l < DVFS_LEVELS_COUNT; l++) {
+        _dvfs_clock_periods[ l] = (SIM_TIME)floor( double(PIPE_DELAY_BASE) *
+            _dvfs_freq[ DVFS_BASE] / _dvfs_freq[ l] + 0.5);
+        if ( _dvfs_clock_periods[ l] < 1) {
+            printf("Error:  DVFS table file %s: frequencies are too far apart.\n",
+                _dvfs_table_file.c_str());
+            exit(1);
+        }
+    }
+}
+
+SIM_TIME TOPOLOGY::min_dvfs_clock_period() const
+{
+    return *min_element( _dvfs_clock_periods.begin(), _dvfs_clock_periods.end());
+}
+
 void TOPOLOGY::populate_hotspot_sketch_arrays()
 {
     if ( _traffic_type == HOTSPOT_TRAFFIC) {
@@ -539,14 +986,13 @@ void TOPOLOGY::populate_hotspot_sketch_arrays()
         // (1) if user did not provide a list of hotspots, create one single hotspot
         // at the center of the mesh;
         if ( _hotspots.empty()) { 
-            // assumption: I work with square meshes for now;
-            long default_hotspot = _ary_size/2 * _ary_size + _ary_size/2;
+            long default_hotspot = _nx/2 * _ny + _ny/2;
             _hotspots.push_back( default_hotspot);
         }
 
         // (2) initialize the non_hotspots sketch array too;
         _non_hotspots.clear();
-        long num_of_nodes = _ary_size * _ary_size; // num of routers;
+        long num_of_nodes = routers_count();
         for ( long id=0; id < num_of_nodes; id++) {
             if ( find(_hotspots.begin(), _hotspots.end(), id) == _hotspots.end()) {
                 _non_hotspots.push_back( id);
@@ -555,3 +1001,33 @@ void TOPOLOGY::populate_hotspot_sketch_arrays()
     }
 }
 
+
+long TOPOLOGY::routers_count() const
+{
+    long count = 1;
+    for ( long d = 0; d < _cube_size; d++) {
+        count *= dimension_size( d);
+    }
+    return count;
+}
+
+long TOPOLOGY::router_id( const ADDRESS &a) const
+{
+    // id = x * ny + y in 2D and (x * ny + y) * nz + z in 3D, because
+    // of the way routers are indexed;
+    long id = 0;
+    for ( long d = 0; d < long(a.size()); d++) {
+        id = id * dimension_size( d) + a[d];
+    }
+    return id;
+}
+
+ADDRESS TOPOLOGY::router_address( long id) const
+{
+    ADDRESS a( _cube_size, 0);
+    for ( long d = _cube_size - 1; d >= 0; d--) {
+        a[d] = id % dimension_size( d);
+        id = id / dimension_size( d);
+    }
+    return a;
+}
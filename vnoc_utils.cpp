@@ -46,87 +46,96 @@ void *my_realloc(void *ptr, size_t size)
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-RANDOM_NUMBER_GENERATOR::RANDOM_NUMBER_GENERATOR(long seed) :_seed(seed)
+RANDOM_NUMBER_GENERATOR::RANDOM_NUMBER_GENERATOR(long seed, 
+    unsigned long long stream)
 {
-    srandom( _seed);
+    set_seed( seed, stream);
 }
 
-RANDOM_NUMBER_GENERATOR::RANDOM_NUMBER_GENERATOR() : _seed(1)
+RANDOM_NUMBER_GENERATOR::RANDOM_NUMBER_GENERATOR()
 {
-    srandom( _seed);
+    set_seed( 1, 0);
 }
 
-double RANDOM_NUMBER_GENERATOR::sflat01()
+void RANDOM_NUMBER_GENERATOR::set_seed(long seed, unsigned long long stream) 
 {
-    double val = random() * 1.0 / RAND_MAX;
-    return val;
+    _seed = (unsigned long long)seed;
+    _stream = stream;
+    _counter = 0;
+    _block_used = 4; // empty;
+    _gauss_saved = false;
+    _gauss_next = 0.0;
 }
 
-void RANDOM_NUMBER_GENERATOR::set_seed(long seed) 
+void RANDOM_NUMBER_GENERATOR::next_block()
 {
-    _seed = seed;
-    srandom( seed);
+    // Philox4x32-10 (Salmon et al., SC'11); the 128-bit counter is made of
+    // the block index and the stream id; the key is the seed;
+    unsigned int c[4] = { (unsigned int)_counter, (unsigned int)(_counter >> 32),
+        (unsigned int)_stream, (unsigned int)(_stream >> 32) };
+    unsigned int k0 = (unsigned int)_seed;
+    unsigned int k1 = (unsigned int)(_seed >> 32);
+    for ( long round = 0; round < 10; round++) {
+        unsigned long long p0 = 0xD2511F53ULL * c[0];
+        unsigned long long p1 = 0xCD9E8D57ULL * c[2];
+        unsigned int c0 = (unsigned int)(p1 >> 32) ^ c[1] ^ k0;
+        unsigned int c2 = (unsigned int)(p0 >> 32) ^ c[3] ^ k1;
+        c[0] = c0;
+        c[1] = (unsigned int)p1;
+        c[2] = c2;
+        c[3] = (unsigned int)p0;
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    for ( long i = 0; i < 4; i++) {
+        _block[i] = c[i];
+    }
+    _block_used = 0;
+    _counter ++;
 }
 
 double RANDOM_NUMBER_GENERATOR::flat_d(double low, double high) 
 {
     assert( low < high);
-    return (high - low) * sflat01() + low;
+    return (high - low) * flat01() + low;
 }
 
 long RANDOM_NUMBER_GENERATOR::flat_l(long low, long high)
 {
     assert( low < high);
-    long val = long((high - low) * sflat01() + low);
-    assert( val >= low && val < high);
-    return val;
+    return low + long( bounded( (unsigned long long)(high - low)));
 }
 
 unsigned long RANDOM_NUMBER_GENERATOR::flat_ul(unsigned long low, 
     unsigned long high) 
 {
     assert( low < high);
-    unsigned long val = (unsigned long)((high-low) * sflat01() + low);
-    assert( val >= low && val < high);
-    return val;
+    return low + (unsigned long)( bounded( high - low));
 }
 
 unsigned long long RANDOM_NUMBER_GENERATOR::flat_ull(unsigned long long low,
     unsigned long long high) 
 {
     assert( low < high);
-    unsigned long long val = (unsigned long long)((high-low) * sflat01() + low);
-    assert( val >= low && val < high);
-    return val;
+    return low + bounded( high - low);
 }
 
 double RANDOM_NUMBER_GENERATOR::gauss01()
 {
-    // mean = 0, variance = 1;
-    double modifier;
-    double compile_b;
-    double in_a, in_b;
-    double out_a;
-    static double out_b;
-    static int recalc = 1;
-
-    if (recalc) {
-        // Range from (0:1], not [0:1). Had to change this to prevent log(0).
-        in_a = 1.0 - sflat01();
-        in_b = sflat01();
-
-        modifier = sqrt( -2.0 * log(in_a));
-        compile_b = 2.0 * PI * in_b;
-
-        out_a = modifier * cos(compile_b);
-        out_b = modifier * sin(compile_b);
-
-        recalc = 0;
-        return out_b;
+    // mean = 0, variance = 1; Box-Muller makes two numbers; the second
+    // one is returned by the next call;
+    if ( _gauss_saved) {
+        _gauss_saved = false;
+        return _gauss_next;
     }
-
-    recalc = 1;
-    return out_b;
+    // range is (0:1], not [0:1), to prevent log(0);
+    double in_a = 1.0 - flat01();
+    double in_b = flat01();
+    double modifier = sqrt( -2.0 * log(in_a));
+    double compile_b = 2.0 * PI * in_b;
+    _gauss_next = modifier * cos(compile_b);
+    _gauss_saved = true;
+    return modifier * sin(compile_b);
 }
 
 double RANDOM_NUMBER_GENERATOR::gauss_mean_d(double mean, double variance) 
@@ -160,7 +169,7 @@ int RANDOM_NUMBER_GENERATOR::poisson( double this_mean)
     float z;
     int i = -1;
     while ( sum <= this_mean) {
-        R = (float)rand()/(float)(RAND_MAX+1);
+        R = 1.0 - flat01(); // (0:1], to prevent log(0);
         z = -log(R);
         sum += z;
         i++;
@@ -173,7 +182,7 @@ int RANDOM_NUMBER_GENERATOR::pareto( double alpha)
     // http://www.pamvotis.org/vassis/RandGen.htm
     // do not use this one; does not have the beta parameter?
     float R;
-    R = (float)rand()/(float)(RAND_MAX+1);
+    R = 1.0 - flat01();
     return (float)1/(float)(pow(R,(float)1/alpha));
 }
 
@@ -207,8 +216,10 @@ TRAFFIC_INJECTOR::TRAFFIC_INJECTOR( long id, long x, long y,
     // a ByteTime of 1, which is my simulation cycle;
     //_gen_pareto_level2(8.0E-6, injection_rate, 128)
 {
-    // selfsimilar;
-    _gen_pareto_level2.initialize(1.0E-2, injection_rate, 128, seed);
+    _rng.set_seed( seed, rng_stream( INJECTOR_RNG_STREAM, id));
+    // selfsimilar; the generator has its own stream;
+    _gen_pareto_level2.initialize(1.0E-2, injection_rate, 128, seed,
+        rng_stream( PARETO_RNG_STREAM, id));
     _prev_injection_time = 0.0;
     _prev_num_injected_packets = 0;
     _selected_src_for_selfsimilar = false;
@@ -228,7 +239,7 @@ long TRAFFIC_INJECTOR::get_dest_uniform(void)
 {
     long dest_id = _id;
     while (dest_id == _id) 
-        dest_id = (long) (drand48() * _vnoc->get_num_of_traffic_sinks());
+        dest_id = (long) (_rng.flat_d(0.0, 1.0) * _vnoc->get_num_of_traffic_sinks());
     return dest_id;
 }
 
@@ -264,7 +275,7 @@ long TRAFFIC_INJECTOR::get_dest_hotspot(void)
 {
     assert( _vnoc->topology()->hotspots().size() > 0);
     bool i_am_hotspot = false;
-    vector<long>::iterator iter = 
+    vector<long>::const_iterator iter = 
         find( _vnoc->topology()->hotspots().begin(), _vnoc->topology()->hotspots().end(), _id);
     if ( iter != _vnoc->topology()->hotspots().end()) { // this node is one of the hotspots
         i_am_hotspot = true;
@@ -292,10 +303,10 @@ long TRAFFIC_INJECTOR::get_dest_hotspot(void)
 
     long dest_id = _id;
     long index = -1;
-    if ( drand48() < sum_normal_prob) { 
+    if ( _rng.flat_d(0.0, 1.0) < sum_normal_prob) { 
         // set the destination to one of the normal nodes
         while ( dest_id == _id) {
-            index = (unsigned int) (drand48() * _vnoc->topology()->non_hotspots().size());
+            index = (unsigned int) (_rng.flat_d(0.0, 1.0) * _vnoc->topology()->non_hotspots().size());
             dest_id = _vnoc->topology()->non_hotspots()[index];
         }
     }
@@ -303,7 +314,7 @@ long TRAFFIC_INJECTOR::get_dest_hotspot(void)
         assert(n_of_hotspots_dest);
         // set the destination to one of the hotspots
         while ( dest_id == _id) {
-            index = (unsigned int) (drand48() * _vnoc->topology()->hotspots().size());
+            index = (unsigned int) (_rng.flat_d(0.0, 1.0) * _vnoc->topology()->hotspots().size());
             dest_id = _vnoc->topology()->hotspots()[index];
         }
     }
@@ -334,7 +345,7 @@ void TRAFFIC_INJECTOR::simulate_one_traffic_injector()
 
     // (2) uniform, transpose 1/2, hotspot traffic; 
     else {
-        if ( drand48() < _injection_rate) { // mimic Poisson arrival
+        if ( _rng.flat_d(0.0, 1.0) < _injection_rate) { // mimic Poisson arrival
             long dest_id = _id;
 
             if (_traffic_type == UNIFORM_TRAFFIC) {